@@ -0,0 +1,66 @@
+#!/usr/bin/env bash
+
+#check that extractorPairedEnd gives the same output with one thread as with several
+source "$(dirname "$0")/threadsRegressionCommon.sh"
+startThreadsTest extractorPairedEndThreads.sh 7 "$@"
+
+#multiplexed paired fixture, three barcodes and three targets
+TARGETS=(tar1 tar2 tar3)
+FORWARDS=(ACGTTGCAAGCTCAGT GATCCTAGGCATTCAG TTCAGGCAACGTATGC)
+REVERSES=(TTGACCGATGCAGTCA CAGTAGGCTTACCGAT AGCATCGGTACTTGCA)
+MIDS=(MID01 MID02 MID03)
+BARCODES=(ACGAGTGCGT ACGCTCGACA AGACGCACTC)
+#set QUAL_LINE to qualities of length $1 with the odd low quality base
+qualLine() {
+	QUAL_LINE=""
+	for ((pos = 0; pos < $1; ++pos)); do
+		if [ $((RANDOM % 40)) -eq 0 ]; then
+			QUAL_LINE+="#"
+		else
+			QUAL_LINE+="I"
+		fi
+	done
+}
+for ((readNum = 0; readNum < 600; ++readNum)); do
+	tarNum=$((RANDOM % 3))
+	midNum=$((RANDOM % 3))
+	randomSeq $((150 + RANDOM % 30))
+	insert=$RANDOM_SEQ
+	r1="${BARCODES[$midNum]}${FORWARDS[$tarNum]}$insert"
+	r2="${REVERSES[$tarNum]}$(revComp $insert)"
+	case $((readNum % 10)) in
+		#no forward primer
+		0) randomSeq 16; r1="${BARCODES[$midNum]}$RANDOM_SEQ$insert" ;;
+		#an N
+		1) r1="${r1:0:60}N${r1:61}" ;;
+		#too short
+		2) r1=${r1:0:40}; r2=${r2:0:40} ;;
+		#unrecognized barcode
+		3) randomSeq 10; r1="$RANDOM_SEQ${r1:10}" ;;
+		#the forward primer of one target with the reverse primer of another
+		4) r2="${REVERSES[$(( (tarNum + 1) % 3 ))]}$(revComp $insert)" ;;
+	esac
+	r1=${r1:0:210}
+	r2=${r2:0:200}
+	qualLine ${#r1}
+	echo -e "@read$readNum 1\n$r1\n+\n$QUAL_LINE" >> "$WORK_DIR/reads_R1.fastq"
+	qualLine ${#r2}
+	echo -e "@read$readNum 2\n$r2\n+\n$QUAL_LINE" >> "$WORK_DIR/reads_R2.fastq"
+done
+{
+	echo -e "target\tforward\treverse"
+	for ((tarNum = 0; tarNum < 3; ++tarNum)); do
+		echo -e "${TARGETS[$tarNum]}\t${FORWARDS[$tarNum]}\t$(revComp ${REVERSES[$tarNum]})"
+	done
+	echo -e "id\tbarcode"
+	for ((midNum = 0; midNum < 3; ++midNum)); do
+		echo -e "${MIDS[$midNum]}\t${BARCODES[$midNum]}"
+	done
+} > "$WORK_DIR/ids.tab.txt"
+
+compareThreads extractorPairedEnd extractorPairedEnd --fastq1 "$WORK_DIR/reads_R1.fastq" \
+	--fastq2 "$WORK_DIR/reads_R2.fastq" --id "$WORK_DIR/ids.tab.txt" --multiplex
+#the primer shortlists are per thread too
+compareThreads extractorPairedEndShortlist extractorPairedEnd --fastq1 "$WORK_DIR/reads_R1.fastq" \
+	--fastq2 "$WORK_DIR/reads_R2.fastq" --id "$WORK_DIR/ids.tab.txt" --multiplex \
+	--primerKmerIndex --primerEditScreen
@@ -0,0 +1,33 @@
+#!/usr/bin/env bash
+
+#check that qluster gives the same clusters with one thread as with several
+source "$(dirname "$0")/threadsRegressionCommon.sh"
+startThreadsTest qlusterThreads.sh 11 "$@"
+
+#a few haplotypes with errors added to their reads
+BASES=(A C G T)
+HAPLOTYPES=()
+for ((hapNum = 0; hapNum < 4; ++hapNum)); do
+	randomSeq 150
+	HAPLOTYPES+=($RANDOM_SEQ)
+done
+for ((readNum = 0; readNum < 600; ++readNum)); do
+	#uneven haplotype frequencies, the last haplotype is a third as common as the others
+	hapNum=$(( (RANDOM % 10) / 3 ))
+	read=${HAPLOTYPES[$hapNum]}
+	qual=$(printf 'I%.0s' $(seq 1 ${#read}))
+	for ((errorNum = 0; errorNum < RANDOM % 3; ++errorNum)); do
+		pos=$((RANDOM % ${#read}))
+		read="${read:0:$pos}${BASES[$((RANDOM % 4))]}${read:$((pos + 1))}"
+		qual="${qual:0:$pos}5${qual:$((pos + 1))}"
+	done
+	#the odd one base deletion
+	if [ $((RANDOM % 20)) -eq 0 ]; then
+		pos=$((RANDOM % ${#read}))
+		read="${read:0:$pos}${read:$((pos + 1))}"
+		qual="${qual:0:$pos}${qual:$((pos + 1))}"
+	fi
+	echo -e "@read$readNum\n$read\n+\n$qual" >> "$WORK_DIR/reads.fastq"
+done
+
+compareThreads qluster qluster --fastq "$WORK_DIR/reads.fastq"
@@ -0,0 +1,61 @@
+#!/usr/bin/env bash
+
+#shared by the *Threads.sh regression tests, source it rather than running it
+#each test checks that a SeekDeep program gives the same output with one thread as with several
+
+#check args and set SEEKDEEP, NUM_THREADS and WORK_DIR, the work directory is removed on exit
+#usage: startThreadsTest [SCRIPT_NAME] [SEED] "$@"
+startThreadsTest() {
+	local scriptName=$1
+	local seed=$2
+	shift 2
+	if [ $# -lt 1 ] || [ $# -gt 2 ]; then
+		echo Need 1 or 2 arguments
+		echo "1) SeekDeep executable"
+		echo "2) number of threads to compare against one thread, default 4"
+		echo "$scriptName [SEEKDEEP] [NUM_THREADS]"
+		exit 1
+	fi
+	SEEKDEEP=$1
+	NUM_THREADS=${2:-4}
+	WORK_DIR=$(mktemp -d)
+	trap 'rm -rf "$WORK_DIR"' EXIT
+	#same fixture every run
+	RANDOM=$seed
+}
+
+#set RANDOM_SEQ to a random sequence of length $1, not run in a subshell ($(...)) since bash re-seeds RANDOM in subshells and
+#the fixture wouldn't be the same every run
+randomSeq() {
+	RANDOM_SEQ=""
+	local bases=(A C G T)
+	for ((pos = 0; pos < $1; ++pos)); do
+		RANDOM_SEQ+=${bases[$((RANDOM % 4))]}
+	done
+}
+
+revComp() {
+	echo $1 | rev | tr ACGT TGCA
+}
+
+#run the program with --numThreads 1 and --numThreads NUM_THREADS, each into its own directory under WORK_DIR, and compare their
+#output, the run logs have times in them so they're left out
+#usage: compareThreads [NAME] [PROGRAM] [ARGS...]
+compareThreads() {
+	local name=$1
+	local program=$2
+	shift 2
+	for threads in 1 $NUM_THREADS; do
+		"$SEEKDEEP" $program "$@" \
+			--dout "$WORK_DIR/${name}Threads$threads" --numThreads $threads > "$WORK_DIR/${name}Threads$threads.log" 2>&1 || {
+			echo "$program ($name) failed with --numThreads $threads"
+			cat "$WORK_DIR/${name}Threads$threads.log"
+			exit 1
+		}
+	done
+	if ! diff -r -x "*Log*" -x "*log*" -x "*.json" "$WORK_DIR/${name}Threads1" "$WORK_DIR/${name}Threads$NUM_THREADS"; then
+		echo "$program ($name) output differs between --numThreads 1 and --numThreads $NUM_THREADS"
+		exit 1
+	fi
+	echo "$program ($name) output is the same with --numThreads 1 and --numThreads $NUM_THREADS"
+}
@@ -12,5 +12,29 @@
 #include "SeekDeep/objects/TarAmpAnalysisSetup.hpp"
 #include "SeekDeep/objects/PrimersAndMids.hpp"
 #include "SeekDeep/objects/ReadPairsOrganizer.hpp"
+#include "SeekDeep/objects/ReadBatchPipeline.hpp"
+#include "SeekDeep/objects/ExtractionTally.hpp"
+#include "SeekDeep/objects/MidNeighborhoodIndex.hpp"
+#include "SeekDeep/objects/PrimerKmerIndex.hpp"
+#include "SeekDeep/objects/PrimerEditScreen.hpp"
+#include "SeekDeep/objects/ShortlistPrimerDeterminator.hpp"
+#include "SeekDeep/objects/ContaminationKmerIndex.hpp"
+#include "SeekDeep/objects/BgzfStream.hpp"
+#include "SeekDeep/objects/BgzfSeqIO.hpp"
+#include "SeekDeep/objects/BufferedMultiSeqOut.hpp"
+#include "SeekDeep/objects/StageTimingProfile.hpp"
+#include "SeekDeep/objects/ExtractorCheckpoint.hpp"
+#include "SeekDeep/objects/PairedReadStitcher.hpp"
+#include "SeekDeep/objects/ReadAheadSeqInput.hpp"
+#include "SeekDeep/objects/ReadArena.hpp"
+#include "SeekDeep/objects/PackedSeq.hpp"
+#include "SeekDeep/objects/IdenticalReadCollapser.hpp"
+#include "SeekDeep/objects/QualityHistogram.hpp"
+#include "SeekDeep/objects/ClusterPrealigner.hpp"
+#include "SeekDeep/objects/ClusterKmerIndex.hpp"
+#include "SeekDeep/objects/MappedAlignmentCache.hpp"
+#include "SeekDeep/objects/ChimeraPrealigner.hpp"
+#include "SeekDeep/objects/MinSpanningTreeBuilder.hpp"
+#include "SeekDeep/objects/ExtractorReadFilter.hpp"
 
 
@@ -0,0 +1,193 @@
+/*
+ * BgzfSeqIO.cpp
+ *
+ *  Created on: Mar 16, 2017
+ *      Author: nick
+ */
+
+#include "BgzfSeqIO.hpp"
+
+namespace bibseq {
+
+BgzfSeqOutput::BgzfSeqOutput(const SeqIOOptions & opts, uint32_t numThreads,
+		int32_t level) :
+		opts_(opts), numThreads_(numThreads), level_(level) {
+	if (!canCompress(opts_)) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: can only compress fasta or fastq output, not "
+				<< getOutFnp(opts_) << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+}
+
+bool BgzfSeqOutput::canCompress(const SeqIOOptions & opts) {
+	return SeqIOOptions::outFormats::FASTQ == opts.outFormat_
+			|| SeqIOOptions::outFormats::FASTA == opts.outFormat_;
+}
+
+bfs::path BgzfSeqOutput::getOutFnp(const SeqIOOptions & opts) {
+	std::string extension = opts.out_.outExtention_;
+	if ("" == extension) {
+		extension =
+				SeqIOOptions::outFormats::FASTQ == opts.outFormat_ ? ".fastq" : ".fasta";
+	}
+	std::string fnp = opts.out_.outFilename_.string();
+	if (bib::endsWith(fnp, ".gz")) {
+		return fnp;
+	}
+	if (!bib::endsWith(fnp, extension)) {
+		fnp += extension;
+	}
+	return fnp + ".gz";
+}
+
+void BgzfSeqOutput::openOut() {
+	if (outOpen()) {
+		return;
+	}
+	auto fnp = getOutFnp(opts_);
+	if (bfs::exists(fnp) && !opts_.out_.append_ && !opts_.out_.overWriteFile_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: " << fnp
+				<< " already exists, use --overWrite to over write it" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	out_ = std::make_unique<BgzfOFStream>(fnp, opts_.out_.append_, numThreads_,
+			level_);
+}
+
+void BgzfSeqOutput::closeOut() {
+	if (nullptr != out_) {
+		out_->close();
+	}
+}
+
+bool BgzfSeqOutput::outOpen() const {
+	return nullptr != out_ && out_->buf_.isOpen();
+}
+
+uint64_t BgzfSeqOutput::bytesIn() const {
+	return nullptr == out_ ? 0 : out_->buf_.bytesIn_;
+}
+
+uint64_t BgzfSeqOutput::bytesOut() const {
+	return nullptr == out_ ? 0 : out_->buf_.bytesOut_;
+}
+
+void BgzfSeqOutput::writeText(const std::string & text) {
+	if (!outOpen()) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: output " << getOutFnp(opts_)
+				<< " isn't open" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	out_->write(text.data(), text.size());
+}
+
+void BgzfSeqOutput::formatRecord(std::ostream & out, const seqInfo & read,
+		const SeqIOOptions & opts) {
+	if (SeqIOOptions::outFormats::FASTQ == opts.outFormat_) {
+		read.outPutFastq(out);
+	} else {
+		read.outPutSeq(out);
+	}
+}
+
+void BgzfSeqOutput::formatRecord(std::ostream & out, const std::string & line,
+		const SeqIOOptions & opts) {
+	out << line << "\n";
+}
+
+BgzfSeqInput::BgzfSeqInput(const SeqIOOptions & opts, uint32_t numThreads) :
+		opts_(opts), numThreads_(numThreads) {
+}
+
+bool BgzfSeqInput::isBgzfInput(const SeqIOOptions & opts) {
+	return Bgzf::isBgzf(opts.firstName_);
+}
+
+void BgzfSeqInput::openIn() {
+	if (inOpen()) {
+		return;
+	}
+	if (!isBgzfInput(opts_)) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: " << opts_.firstName_
+				<< " is not a bgzf file" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	in_ = std::make_unique<BgzfIFStream>(opts_.firstName_, numThreads_);
+	nameLine_.clear();
+}
+
+void BgzfSeqInput::closeIn() {
+	in_ = nullptr;
+}
+
+bool BgzfSeqInput::inOpen() const {
+	return nullptr != in_;
+}
+
+bool BgzfSeqInput::readNextRead(seqInfo & read) {
+	if (!inOpen()) {
+		openIn();
+	}
+	//nameLine_ holds the header of the next fasta record if it's already been read
+	if (nameLine_.empty()) {
+		while (std::getline(*in_, nameLine_) && nameLine_.empty()) {
+		}
+		if (nameLine_.empty()) {
+			return false;
+		}
+	}
+	if ('@' == nameLine_.front()) {
+		if (!std::getline(*in_, seqLine_) || !std::getline(*in_, qualLine_)
+				|| !std::getline(*in_, qualLine_)) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error: " << opts_.firstName_
+					<< " ended in the middle of the record for " << nameLine_ << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		if (qualLine_.size() != seqLine_.size()) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error: in " << opts_.firstName_
+					<< " the quality length doesn't match the sequence length for "
+					<< nameLine_ << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		std::vector<uint32_t> quals(qualLine_.size());
+		for (uint32_t pos = 0; pos < qualLine_.size(); ++pos) {
+			quals[pos] = static_cast<uint32_t>(qualLine_[pos]) - qualOffset_;
+		}
+		read = seqInfo(nameLine_.substr(1), seqLine_, quals);
+		nameLine_.clear();
+	} else if ('>' == nameLine_.front()) {
+		std::string name = nameLine_.substr(1);
+		seqLine_.clear();
+		nameLine_.clear();
+		std::string line;
+		while (std::getline(*in_, line)) {
+			if (!line.empty() && '>' == line.front()) {
+				nameLine_ = line;
+				break;
+			}
+			seqLine_.append(line);
+		}
+		read = seqInfo(name, seqLine_);
+	} else {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: in " << opts_.firstName_
+				<< " expected a record to start with @ or > but found " << nameLine_
+				<< "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	if ("remove" == opts_.lowerCaseBases_) {
+		read.removeLowerCase();
+	} else if ("upper" == opts_.lowerCaseBases_) {
+		stringToUpper(read.seq_);
+	}
+	read.processRead(opts_.processed_);
+	return true;
+}
+
+}  // namespace bibseq
@@ -0,0 +1,160 @@
+#pragma once
+
+/*
+ * BgzfSeqIO.hpp
+ *
+ *  Created on: Mar 16, 2017
+ *      Author: nick
+ */
+
+#include "SeekDeep/objects/BgzfStream.hpp"
+
+namespace bibseq {
+
+/**@brief Write fasta or fastq reads to a BGZF compressed file (the output name with .gz appended), compressing on numThreads threads
+ *
+ */
+class BgzfSeqOutput {
+public:
+	BgzfSeqOutput(const SeqIOOptions & opts, uint32_t numThreads,
+			int32_t level = Z_DEFAULT_COMPRESSION);
+
+	SeqIOOptions opts_;
+	uint32_t numThreads_;
+	int32_t level_;
+
+	void openOut();
+	void closeOut();
+	bool outOpen() const;
+
+	uint64_t bytesIn() const;
+	uint64_t bytesOut() const;
+
+	/**@brief write already formated records
+	 *
+	 * @param text the records
+	 */
+	void writeText(const std::string & text);
+
+	template<typename T>
+	void write(const T & read) {
+		if (!outOpen()) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error: output "
+					<< getOutFnp(opts_) << " isn't open" << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		formatRecord(*out_, read, opts_);
+	}
+
+	template<typename T>
+	void openWrite(const T & read) {
+		openOut();
+		write(read);
+	}
+
+	template<typename T>
+	void write(const std::vector<T> & reads) {
+		for (const auto & read : reads) {
+			write(read);
+		}
+	}
+
+	template<typename T>
+	static void write(const std::vector<T> & reads, const SeqIOOptions & opts,
+			uint32_t numThreads, int32_t level = Z_DEFAULT_COMPRESSION) {
+		BgzfSeqOutput out(opts, numThreads, level);
+		out.openOut();
+		out.write(reads);
+		out.closeOut();
+	}
+
+	/**@brief only fasta and fastq outputs can be compressed
+	 *
+	 */
+	static bool canCompress(const SeqIOOptions & opts);
+
+	static bfs::path getOutFnp(const SeqIOOptions & opts);
+
+	template<typename T>
+	static void formatRecord(std::ostream & out, const T & read,
+			const SeqIOOptions & opts) {
+		formatRecord(out, read.seqBase_, opts);
+	}
+	template<typename T>
+	static void formatRecord(std::ostream & out, const std::shared_ptr<T> & read,
+			const SeqIOOptions & opts) {
+		formatRecord(out, *read, opts);
+	}
+	static void formatRecord(std::ostream & out, const seqInfo & read,
+			const SeqIOOptions & opts);
+	static void formatRecord(std::ostream & out, const std::string & line,
+			const SeqIOOptions & opts);
+
+private:
+	std::unique_ptr<BgzfOFStream> out_;
+};
+
+/**@brief Read fasta or fastq reads from a BGZF compressed file, decompressing on numThreads threads
+ *
+ */
+class BgzfSeqInput {
+public:
+	BgzfSeqInput(const SeqIOOptions & opts, uint32_t numThreads);
+
+	SeqIOOptions opts_;
+	uint32_t numThreads_;
+	//fastq quality characters are decoded with the offset SeqInput decodes them with
+	const uint32_t qualOffset_ = SangerQualOffset;
+
+	void openIn();
+	void closeIn();
+	bool inOpen() const;
+
+	bool readNextRead(seqInfo & read);
+
+	template<typename T>
+	bool readNextRead(T & read) {
+		seqInfo info;
+		if (!readNextRead(info)) {
+			return false;
+		}
+		read = T(info);
+		return true;
+	}
+
+	template<typename T>
+	bool readNextRead(std::shared_ptr<T> & read) {
+		seqInfo info;
+		if (!readNextRead(info)) {
+			return false;
+		}
+		read = std::make_shared<T>(info);
+		return true;
+	}
+
+	template<typename T>
+	std::vector<T> readAllReads() {
+		std::vector<T> ret;
+		openIn();
+		T read;
+		while (readNextRead(read)) {
+			ret.emplace_back(read);
+		}
+		closeIn();
+		return ret;
+	}
+
+	/**@brief whether the input in opts is a BGZF file that this can read
+	 *
+	 */
+	static bool isBgzfInput(const SeqIOOptions & opts);
+
+private:
+	std::unique_ptr<BgzfIFStream> in_;
+	std::string nameLine_;
+	std::string seqLine_;
+	std::string qualLine_;
+};
+
+}  // namespace bibseq
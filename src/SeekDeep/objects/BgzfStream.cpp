@@ -0,0 +1,413 @@
+/*
+ * BgzfStream.cpp
+ *
+ *  Created on: Mar 16, 2017
+ *      Author: nick
+ */
+
+#include "BgzfStream.hpp"
+
+namespace bibseq {
+
+namespace {
+//run func on each block, spread over numThreads threads
+void runOnBlocks(std::vector<std::string> & blocks, uint32_t numThreads,
+		const std::function<void(std::string &)> & func) {
+	if (numThreads <= 1 || blocks.size() <= 1) {
+		for (auto & block : blocks) {
+			func(block);
+		}
+		return;
+	}
+	std::atomic<uint32_t> next { 0 };
+	std::mutex mut;
+	std::exception_ptr exception;
+	auto work = [&]() {
+		try {
+			uint32_t pos = next++;
+			while (pos < blocks.size()) {
+				func(blocks[pos]);
+				pos = next++;
+			}
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(mut);
+			exception = std::current_exception();
+		}
+	};
+	std::vector<std::thread> threads;
+	for (uint32_t t = 0; t < std::min<uint32_t>(numThreads, blocks.size()); ++t) {
+		threads.emplace_back(work);
+	}
+	for (auto & t : threads) {
+		t.join();
+	}
+	if (nullptr != exception) {
+		std::rethrow_exception(exception);
+	}
+}
+
+void putUint16(std::string & out, uint32_t pos, uint16_t val) {
+	out[pos] = static_cast<char>(val & 0xff);
+	out[pos + 1] = static_cast<char>((val >> 8) & 0xff);
+}
+
+void putUint32(std::string & out, uint32_t pos, uint32_t val) {
+	for (uint32_t byte = 0; byte < 4; ++byte) {
+		out[pos + byte] = static_cast<char>((val >> (8 * byte)) & 0xff);
+	}
+}
+
+uint32_t getUint16(const std::string & in, uint32_t pos) {
+	return static_cast<uint8_t>(in[pos])
+			| static_cast<uint32_t>(static_cast<uint8_t>(in[pos + 1])) << 8;
+}
+
+uint32_t getUint32(const std::string & in, uint32_t pos) {
+	uint32_t ret = 0;
+	for (uint32_t byte = 0; byte < 4; ++byte) {
+		ret |= static_cast<uint32_t>(static_cast<uint8_t>(in[pos + byte])) << (8 * byte);
+	}
+	return ret;
+}
+
+}  // namespace
+
+std::string Bgzf::compressBlock(const std::string & data, int32_t level) {
+	if (data.size() > maxBlockInputSize_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: data size " << data.size()
+				<< " is larger than the max block input size of " << maxBlockInputSize_
+				<< "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	std::string block(maxBlockSize_, '\0');
+	//gzip header with the BC extra field that holds the block size
+	const std::array<uint8_t, headerSize_> header { { 0x1f, 0x8b, 8, 4, 0, 0, 0,
+			0, 0, 0xff, 6, 0, 'B', 'C', 2, 0, 0, 0 } };
+	std::copy(header.begin(), header.end(), block.begin());
+	uint32_t compressedSize = 0;
+	//if compressing doesn't fit, which can only happen for incompressible data, store it instead
+	for (const auto currentLevel : std::vector<int32_t> { level, Z_NO_COMPRESSION }) {
+		z_stream zs;
+		zs.zalloc = Z_NULL;
+		zs.zfree = Z_NULL;
+		zs.opaque = Z_NULL;
+		if (Z_OK
+				!= deflateInit2(&zs, currentLevel, Z_DEFLATED, -15, 8,
+						Z_DEFAULT_STRATEGY)) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error: couldn't initialize zlib deflate"
+					<< "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+		zs.avail_in = data.size();
+		zs.next_out = reinterpret_cast<Bytef *>(&block[headerSize_]);
+		zs.avail_out = maxBlockSize_ - headerSize_ - footerSize_;
+		auto status = deflate(&zs, Z_FINISH);
+		compressedSize = zs.total_out;
+		deflateEnd(&zs);
+		if (Z_STREAM_END == status) {
+			break;
+		}
+		if (Z_NO_COMPRESSION == currentLevel) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error: couldn't fit block in "
+					<< maxBlockSize_ << " bytes" << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+	}
+	uint32_t blockSize = headerSize_ + compressedSize + footerSize_;
+	putUint16(block, 16, blockSize - 1);
+	putUint32(block, headerSize_ + compressedSize,
+			crc32(crc32(0L, Z_NULL, 0),
+					reinterpret_cast<const Bytef *>(data.data()), data.size()));
+	putUint32(block, headerSize_ + compressedSize + 4, data.size());
+	block.resize(blockSize);
+	return block;
+}
+
+std::string Bgzf::decompressBlock(const std::string & block) {
+	if (block.size() < headerSize_ + footerSize_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: block size " << block.size()
+				<< " is too small" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	uint32_t dataStart = 12 + getUint16(block, 10);
+	uint32_t compressedSize = block.size() - dataStart - footerSize_;
+	uint32_t expectedCrc = getUint32(block, block.size() - 8);
+	uint32_t expectedSize = getUint32(block, block.size() - 4);
+	std::string data(expectedSize, '\0');
+	if (expectedSize > 0) {
+		z_stream zs;
+		zs.zalloc = Z_NULL;
+		zs.zfree = Z_NULL;
+		zs.opaque = Z_NULL;
+		zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(&block[dataStart]));
+		zs.avail_in = compressedSize;
+		if (Z_OK != inflateInit2(&zs, -15)) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error: couldn't initialize zlib inflate"
+					<< "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		zs.next_out = reinterpret_cast<Bytef *>(&data[0]);
+		zs.avail_out = expectedSize;
+		auto status = inflate(&zs, Z_FINISH);
+		auto decompressedSize = zs.total_out;
+		inflateEnd(&zs);
+		if (Z_STREAM_END != status || decompressedSize != expectedSize) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error: failed to decompress block, expected "
+					<< expectedSize << " bytes but got " << decompressedSize << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+	}
+	if (expectedCrc
+			!= crc32(crc32(0L, Z_NULL, 0),
+					reinterpret_cast<const Bytef *>(data.data()), data.size())) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: crc check failed for block" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	return data;
+}
+
+const std::string & Bgzf::eofBlock() {
+	static const std::string eof = compressBlock("", Z_DEFAULT_COMPRESSION);
+	return eof;
+}
+
+bool Bgzf::isBgzf(const bfs::path & fnp) {
+	std::ifstream in(fnp.string(), std::ios::binary);
+	if (!in) {
+		return false;
+	}
+	std::string header(headerSize_, '\0');
+	in.read(&header[0], headerSize_);
+	if (static_cast<uint32_t>(in.gcount()) < headerSize_) {
+		return false;
+	}
+	return 0x1f == static_cast<uint8_t>(header[0])
+			&& 0x8b == static_cast<uint8_t>(header[1])
+			&& 8 == static_cast<uint8_t>(header[2])
+			&& (static_cast<uint8_t>(header[3]) & 4)
+			&& getUint16(header, 10) >= 6
+			&& 'B' == header[12]
+			&& 'C' == header[13]
+			&& 2 == getUint16(header, 14);
+}
+
+BgzfOutBuf::BgzfOutBuf(const bfs::path & fnp, bool append,
+		uint32_t numThreads, int32_t level) :
+		numThreads_(std::max<uint32_t>(1, numThreads)), level_(level) {
+	out_.open(fnp.string(),
+			append ? std::ios::binary | std::ios::app : std::ios::binary);
+	if (!out_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: couldn't open " << fnp
+				<< " for writing" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	block_.reserve(Bgzf::maxBlockInputSize_);
+}
+
+BgzfOutBuf::~BgzfOutBuf() {
+	try {
+		close();
+	} catch (std::exception & e) {
+		std::cerr << __PRETTY_FUNCTION__ << ", error closing bgzf output: "
+				<< e.what() << std::endl;
+	}
+}
+
+bool BgzfOutBuf::isOpen() const {
+	return out_.is_open();
+}
+
+BgzfOutBuf::int_type BgzfOutBuf::overflow(int_type c) {
+	if (traits_type::eq_int_type(c, traits_type::eof())) {
+		return traits_type::not_eof(c);
+	}
+	char ch = traits_type::to_char_type(c);
+	xsputn(&ch, 1);
+	return c;
+}
+
+std::streamsize BgzfOutBuf::xsputn(const char * s, std::streamsize n) {
+	std::streamsize written = 0;
+	while (written < n) {
+		auto toAdd = std::min<std::streamsize>(n - written,
+				Bgzf::maxBlockInputSize_ - block_.size());
+		block_.append(s + written, toAdd);
+		written += toAdd;
+		if (Bgzf::maxBlockInputSize_ == block_.size()) {
+			finishBlock();
+		}
+	}
+	bytesIn_ += n;
+	return n;
+}
+
+int BgzfOutBuf::sync() {
+	if (!out_.is_open()) {
+		return 0;
+	}
+	writePending();
+	out_.flush();
+	return out_ ? 0 : -1;
+}
+
+void BgzfOutBuf::finishBlock() {
+	if (block_.empty()) {
+		return;
+	}
+	pending_.emplace_back(std::move(block_));
+	block_.clear();
+	block_.reserve(Bgzf::maxBlockInputSize_);
+	//keep enough blocks queued up to give each thread a few
+	if (pending_.size() >= numThreads_ * 4) {
+		writePending();
+	}
+}
+
+void BgzfOutBuf::writePending() {
+	if (pending_.empty()) {
+		return;
+	}
+	auto level = level_;
+	runOnBlocks(pending_, numThreads_, [level](std::string & block) {
+		block = Bgzf::compressBlock(block, level);
+	});
+	for (const auto & block : pending_) {
+		out_.write(block.data(), block.size());
+		bytesOut_ += block.size();
+		++blocksWritten_;
+	}
+	pending_.clear();
+	if (!out_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: failed writing bgzf blocks" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+}
+
+void BgzfOutBuf::close() {
+	if (!out_.is_open()) {
+		return;
+	}
+	finishBlock();
+	writePending();
+	out_.write(Bgzf::eofBlock().data(), Bgzf::eofBlock().size());
+	bytesOut_ += Bgzf::eofBlock().size();
+	out_.close();
+}
+
+BgzfInBuf::BgzfInBuf(const bfs::path & fnp, uint32_t numThreads) :
+		fnp_(fnp), numThreads_(std::max<uint32_t>(1, numThreads)) {
+	in_.open(fnp.string(), std::ios::binary);
+	if (!in_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: couldn't open " << fnp
+				<< " for reading" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+}
+
+bool BgzfInBuf::isOpen() const {
+	return in_.is_open();
+}
+
+bool BgzfInBuf::readBlock(std::string & block) {
+	block.assign(12, '\0');
+	in_.read(&block[0], 12);
+	if (0 == in_.gcount()) {
+		return false;
+	}
+	if (12 != in_.gcount() || 0x1f != static_cast<uint8_t>(block[0])
+			|| 0x8b != static_cast<uint8_t>(block[1])
+			|| !(static_cast<uint8_t>(block[3]) & 4)) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: " << fnp_
+				<< " is not bgzf, found a gzip member without an extra field" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	uint32_t extraLen = getUint16(block, 10);
+	block.resize(12 + extraLen);
+	in_.read(&block[12], extraLen);
+	//find the BC subfield which holds the total block size
+	uint32_t blockSize = 0;
+	uint32_t pos = 12;
+	while (pos + 4 <= 12 + extraLen) {
+		uint32_t subLen = getUint16(block, pos + 2);
+		if ('B' == block[pos] && 'C' == block[pos + 1] && 2 == subLen) {
+			blockSize = getUint16(block, pos + 4) + 1;
+		}
+		pos += 4 + subLen;
+	}
+	if (0 == blockSize || blockSize < 12 + extraLen + Bgzf::footerSize_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: " << fnp_
+				<< " is not bgzf, couldn't find the block size" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	uint32_t rest = blockSize - block.size();
+	block.resize(blockSize);
+	in_.read(&block[12 + extraLen], rest);
+	if (static_cast<std::streamsize>(rest) != in_.gcount()) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: " << fnp_ << " is truncated"
+				<< "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	return true;
+}
+
+bool BgzfInBuf::readBatch() {
+	blocks_.clear();
+	blockPos_ = 0;
+	std::string block;
+	while (blocks_.size() < numThreads_ * 4 && readBlock(block)) {
+		blocks_.emplace_back(std::move(block));
+	}
+	runOnBlocks(blocks_, numThreads_, [](std::string & block) {
+		block = Bgzf::decompressBlock(block);
+	});
+	return !blocks_.empty();
+}
+
+BgzfInBuf::int_type BgzfInBuf::underflow() {
+	if (gptr() < egptr()) {
+		return traits_type::to_int_type(*gptr());
+	}
+	while (true) {
+		if (blockPos_ >= blocks_.size() && !readBatch()) {
+			return traits_type::eof();
+		}
+		auto & block = blocks_[blockPos_];
+		++blockPos_;
+		//skip empty blocks like the eof marker
+		if (!block.empty()) {
+			setg(&block[0], &block[0], &block[0] + block.size());
+			return traits_type::to_int_type(*gptr());
+		}
+	}
+}
+
+BgzfOFStream::BgzfOFStream(const bfs::path & fnp, bool append,
+		uint32_t numThreads, int32_t level) :
+		std::ostream(nullptr), buf_(fnp, append, numThreads, level) {
+	rdbuf(&buf_);
+}
+
+void BgzfOFStream::close() {
+	buf_.close();
+}
+
+BgzfIFStream::BgzfIFStream(const bfs::path & fnp, uint32_t numThreads) :
+		std::istream(nullptr), buf_(fnp, numThreads) {
+	rdbuf(&buf_);
+}
+
+}  // namespace bibseq
@@ -0,0 +1,126 @@
+#pragma once
+
+/*
+ * BgzfStream.hpp
+ *
+ *  Created on: Mar 16, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+#include <zlib.h>
+
+namespace bibseq {
+
+/**@brief Helpers for the BGZF format, gzip members of at most 64kb each with the compressed size of the member stored
+ * in the header so every block can be found (and seeked to) without decompressing the ones before it
+ *
+ * Any gzip reader can read BGZF files since they are just concatenated gzip members
+ */
+class Bgzf {
+public:
+	//max uncompressed bytes per block so the compressed block always fits in 64kb
+	static const uint32_t maxBlockInputSize_ = 0xff00;
+	static const uint32_t maxBlockSize_ = 0x10000;
+	static const uint32_t headerSize_ = 18;
+	static const uint32_t footerSize_ = 8;
+
+	/**@brief compress data into a complete BGZF block
+	 *
+	 * @param data the data to compress, no more than maxBlockInputSize_
+	 * @param level the zlib compression level
+	 * @return the block
+	 */
+	static std::string compressBlock(const std::string & data, int32_t level);
+	/**@brief decompress a complete BGZF block, the crc and size are checked
+	 *
+	 * @param block the full block including header and footer
+	 * @return the uncompressed data
+	 */
+	static std::string decompressBlock(const std::string & block);
+
+	static const std::string & eofBlock();
+
+	/**@brief check if a file starts with a BGZF block header
+	 *
+	 * @param fnp the file to check
+	 * @return true if the first gzip member in the file has the BGZF extra field
+	 */
+	static bool isBgzf(const bfs::path & fnp);
+};
+
+/**@brief An output stream buffer that writes BGZF, full blocks are compressed in parallel on numThreads threads and written in order
+ *
+ * Partial blocks are only finished on close so flushing (e.g. std::endl) doesn't make small blocks
+ */
+class BgzfOutBuf: public std::streambuf {
+public:
+	BgzfOutBuf(const bfs::path & fnp, bool append, uint32_t numThreads,
+			int32_t level = Z_DEFAULT_COMPRESSION);
+
+	~BgzfOutBuf();
+
+	void close();
+	bool isOpen() const;
+
+	uint64_t blocksWritten_ = 0;
+	uint64_t bytesIn_ = 0;
+	uint64_t bytesOut_ = 0;
+
+protected:
+	int_type overflow(int_type c) override;
+	std::streamsize xsputn(const char * s, std::streamsize n) override;
+	int sync() override;
+
+private:
+	std::ofstream out_;
+	uint32_t numThreads_;
+	int32_t level_;
+	std::string block_;
+	std::vector<std::string> pending_;
+
+	void finishBlock();
+	void writePending();
+};
+
+/**@brief An input stream buffer that reads BGZF, batches of blocks are read in and decompressed in parallel on numThreads threads
+ *
+ */
+class BgzfInBuf: public std::streambuf {
+public:
+	BgzfInBuf(const bfs::path & fnp, uint32_t numThreads);
+
+	bool isOpen() const;
+
+protected:
+	int_type underflow() override;
+
+private:
+	std::ifstream in_;
+	bfs::path fnp_;
+	uint32_t numThreads_;
+	std::vector<std::string> blocks_;
+	uint32_t blockPos_ = 0;
+
+	bool readBlock(std::string & block);
+	bool readBatch();
+};
+
+class BgzfOFStream: public std::ostream {
+public:
+	BgzfOFStream(const bfs::path & fnp, bool append, uint32_t numThreads,
+			int32_t level = Z_DEFAULT_COMPRESSION);
+
+	BgzfOutBuf buf_;
+
+	void close();
+};
+
+class BgzfIFStream: public std::istream {
+public:
+	BgzfIFStream(const bfs::path & fnp, uint32_t numThreads);
+
+	BgzfInBuf buf_;
+};
+
+}  // namespace bibseq
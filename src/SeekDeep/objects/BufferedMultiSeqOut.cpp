@@ -0,0 +1,303 @@
+/*
+ * BufferedMultiSeqOut.cpp
+ *
+ *  Created on: Mar 14, 2017
+ *      Author: nick
+ */
+
+#include "BufferedMultiSeqOut.hpp"
+
+namespace bibseq {
+
+void BufferedMultiSeqOut::Stats::addOtherStats(const Stats & other) {
+	outputs_ += other.outputs_;
+	recordsWritten_ += other.recordsWritten_;
+	bytesBuffered_ += other.bytesBuffered_;
+	flushes_ += other.flushes_;
+	opens_ += other.opens_;
+	reopens_ += other.reopens_;
+	evictions_ += other.evictions_;
+	maxOpen_ = std::max(maxOpen_, other.maxOpen_);
+	maxBufferedBytes_ = std::max(maxBufferedBytes_, other.maxBufferedBytes_);
+	bgzfBytesIn_ += other.bgzfBytesIn_;
+	bgzfBytesOut_ += other.bgzfBytesOut_;
+}
+
+BufferedMultiSeqOut::Output::Output(const SeqIOOptions & opts) :
+		opts_(opts) {
+}
+
+BufferedMultiSeqOut::BufferedMultiSeqOut(uint32_t maxOpen, uint64_t bufferSize,
+		uint64_t totalBufferSize) :
+		maxOpen_(maxOpen), bufferSize_(bufferSize), totalBufferSize_(
+				totalBufferSize) {
+	if (0 == maxOpen_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: maxOpen can't be 0" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+}
+
+BufferedMultiSeqOut::~BufferedMultiSeqOut() {
+	try {
+		closeOutAll();
+	} catch (std::exception & e) {
+		std::cerr << __PRETTY_FUNCTION__ << ", error writing out buffered reads: "
+				<< e.what() << std::endl;
+	}
+}
+
+void BufferedMultiSeqOut::setBgzfOutput(uint32_t numThreads, int32_t level) {
+	bgzf_ = true;
+	bgzfThreads_ = numThreads;
+	bgzfLevel_ = level;
+}
+
+void BufferedMultiSeqOut::addReader(const std::string & uid,
+		const SeqIOOptions & opts) {
+	if (containsReader(uid)) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: already contains reader for "
+				<< uid << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	auto output = std::make_unique<Output>(opts);
+	output->bgzf_ = bgzf_ && BgzfSeqOutput::canCompress(opts);
+	outputs_.emplace(uid, std::move(output));
+	++stats_.outputs_;
+}
+
+bool BufferedMultiSeqOut::containsReader(const std::string & uid) const {
+	return outputs_.end() != outputs_.find(uid);
+}
+
+BufferedMultiSeqOut::Output & BufferedMultiSeqOut::getOutput(
+		const std::string & uid) {
+	auto search = outputs_.find(uid);
+	if (outputs_.end() == search) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: no reader for " << uid << "\n";
+		ss << "Options are: " << bib::conToStr(getVectorOfMapKeys(outputs_), ",")
+				<< "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	return *search->second;
+}
+
+void BufferedMultiSeqOut::openWriteFlow(const std::string & uid,
+		const sffObject & read) {
+	auto copy = read;
+	addRecord(uid, recordBytes(read), [copy](SeqOutput & out) {
+		out.openWriteFlow(copy);
+	});
+}
+
+void BufferedMultiSeqOut::addRecord(const std::string & uid, uint64_t bytes,
+		const std::function<void(SeqOutput &)> & record) {
+	auto & output = getOutput(uid);
+	if (output.bgzf_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: can't write this record type to bgzf output "
+				<< uid << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	output.buffer_.emplace_back(record);
+	addBytes(uid, output, bytes);
+}
+
+void BufferedMultiSeqOut::addText(const std::string & uid, Output & output,
+		const std::string & text) {
+	output.text_.append(text);
+	addBytes(uid, output, text.size());
+}
+
+void BufferedMultiSeqOut::addBytes(const std::string & uid, Output & output,
+		uint64_t bytes) {
+	output.bufferedBytes_ += bytes;
+	totalBufferedBytes_ += bytes;
+	stats_.bytesBuffered_ += bytes;
+	++stats_.recordsWritten_;
+	stats_.maxBufferedBytes_ = std::max(stats_.maxBufferedBytes_, totalBufferedBytes_);
+	if (output.bufferedBytes_ >= bufferSize_) {
+		flush(uid, output);
+	}
+	if (totalBufferedBytes_ >= totalBufferSize_) {
+		flushLargest();
+	}
+}
+
+bool BufferedMultiSeqOut::isOpen(const Output & output) const {
+	return nullptr != output.out_ || nullptr != output.bgzfOut_;
+}
+
+void BufferedMultiSeqOut::openOutput(const std::string & uid, Output & output) {
+	//make room before opening another file
+	while (openOrder_.size() >= maxOpen_) {
+		closeOutput(getOutput(openOrder_.back()));
+		++stats_.evictions_;
+	}
+	auto opts = output.opts_;
+	if (output.created_) {
+		opts.out_.append_ = true;
+		++stats_.reopens_;
+	}
+	if (output.bgzf_) {
+		output.bgzfOut_ = std::make_unique<BgzfSeqOutput>(opts, bgzfThreads_,
+				bgzfLevel_);
+		output.bgzfOut_->openOut();
+	} else {
+		output.out_ = std::make_unique<SeqOutput>(opts);
+		output.out_->openOut();
+	}
+	output.created_ = true;
+	openOrder_.emplace_front(uid);
+	output.openPos_ = openOrder_.begin();
+	++stats_.opens_;
+	stats_.maxOpen_ = std::max<uint64_t>(stats_.maxOpen_, openOrder_.size());
+}
+
+void BufferedMultiSeqOut::flush(const std::string & uid, Output & output) {
+	if (output.buffer_.empty() && output.text_.empty()) {
+		return;
+	}
+	if (!isOpen(output)) {
+		openOutput(uid, output);
+	} else {
+		openOrder_.splice(openOrder_.begin(), openOrder_, output.openPos_);
+	}
+	if (output.bgzf_) {
+		output.bgzfOut_->writeText(output.text_);
+		output.text_.clear();
+	} else {
+		for (const auto & record : output.buffer_) {
+			record(*output.out_);
+		}
+		output.buffer_.clear();
+	}
+	totalBufferedBytes_ -= output.bufferedBytes_;
+	output.bufferedBytes_ = 0;
+	++stats_.flushes_;
+}
+
+void BufferedMultiSeqOut::flushLargest() {
+	std::vector<std::pair<uint64_t, std::string>> buffered;
+	for (const auto & output : outputs_) {
+		if (output.second->bufferedBytes_ > 0) {
+			buffered.emplace_back(output.second->bufferedBytes_, output.first);
+		}
+	}
+	std::sort(buffered.rbegin(), buffered.rend());
+	for (const auto & largest : buffered) {
+		if (totalBufferedBytes_ < totalBufferSize_ / 2) {
+			break;
+		}
+		flush(largest.second, getOutput(largest.second));
+	}
+}
+
+void BufferedMultiSeqOut::closeOutput(Output & output) {
+	if (nullptr != output.out_) {
+		output.out_->closeOut();
+		output.out_ = nullptr;
+		openOrder_.erase(output.openPos_);
+	}
+	if (nullptr != output.bgzfOut_) {
+		output.bgzfOut_->closeOut();
+		stats_.bgzfBytesIn_ += output.bgzfOut_->bytesIn();
+		stats_.bgzfBytesOut_ += output.bgzfOut_->bytesOut();
+		output.bgzfOut_ = nullptr;
+		openOrder_.erase(output.openPos_);
+	}
+}
+
+void BufferedMultiSeqOut::closeOut(const std::string & uid) {
+	auto & output = getOutput(uid);
+	flush(uid, output);
+	closeOutput(output);
+}
+
+void BufferedMultiSeqOut::closeOutAll() {
+	for (const auto & output : outputs_) {
+		flush(output.first, *output.second);
+		closeOutput(*output.second);
+	}
+}
+
+bfs::path BufferedMultiSeqOut::getOutFnp(const Output & output) {
+	if (output.bgzf_) {
+		return BgzfSeqOutput::getOutFnp(output.opts_);
+	}
+	std::string fnp = output.opts_.out_.outFilename_.string();
+	if (!bib::endsWith(fnp, output.opts_.out_.outExtention_)) {
+		fnp += output.opts_.out_.outExtention_;
+	}
+	return fnp;
+}
+
+std::map<std::string, uint64_t> BufferedMultiSeqOut::checkpoint() {
+	closeOutAll();
+	std::map<std::string, uint64_t> ret;
+	for (const auto & output : outputs_) {
+		if (output.second->created_) {
+			ret[output.first] = bfs::file_size(getOutFnp(*output.second));
+		}
+	}
+	return ret;
+}
+
+void BufferedMultiSeqOut::restore(const std::map<std::string, uint64_t> & sizes) {
+	for (const auto & size : sizes) {
+		if (!containsReader(size.first)) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error: no reader for " << size.first
+					<< "\n";
+			throw std::runtime_error { ss.str() };
+		}
+	}
+	for (const auto & output : outputs_) {
+		if (!output.second->buffer_.empty() || !output.second->text_.empty()
+				|| isOpen(*output.second)) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error: can only restore outputs before anything is written to them, "
+					<< output.first << " has already been written to" << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		auto fnp = getOutFnp(*output.second);
+		auto search = sizes.find(output.first);
+		if (sizes.end() == search) {
+			if (bfs::exists(fnp)) {
+				bfs::remove(fnp);
+			}
+			output.second->created_ = false;
+			continue;
+		}
+		if (!bfs::exists(fnp) || bfs::file_size(fnp) < search->second) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error: " << fnp
+					<< " is missing or smaller than its checkpoint size of "
+					<< search->second << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		bfs::resize_file(fnp, search->second);
+		output.second->created_ = true;
+	}
+}
+
+void BufferedMultiSeqOut::writeStats(std::ostream & out, const Stats & stats) {
+	out << "outputs\trecordsWritten\tbytesBuffered\tflushes\tmeanBytesPerFlush\topens\treopens\tevictions\tmaxOpen\tmaxBufferedBytes\tbgzfBytesIn\tbgzfBytesOut" << "\n";
+	out << stats.outputs_
+			<< "\t" << stats.recordsWritten_
+			<< "\t" << stats.bytesBuffered_
+			<< "\t" << stats.flushes_
+			<< "\t" << (0 == stats.flushes_ ? 0 : static_cast<double>(stats.bytesBuffered_)/stats.flushes_)
+			<< "\t" << stats.opens_
+			<< "\t" << stats.reopens_
+			<< "\t" << stats.evictions_
+			<< "\t" << stats.maxOpen_
+			<< "\t" << stats.maxBufferedBytes_
+			<< "\t" << stats.bgzfBytesIn_
+			<< "\t" << stats.bgzfBytesOut_
+			<< "\n";
+}
+
+}  // namespace bibseq
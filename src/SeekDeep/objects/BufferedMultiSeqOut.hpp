@@ -0,0 +1,163 @@
+#pragma once
+
+/*
+ * BufferedMultiSeqOut.hpp
+ *
+ *  Created on: Mar 14, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+#include "SeekDeep/objects/BgzfSeqIO.hpp"
+
+namespace bibseq {
+
+/**@brief A replacement for MultiSeqIO for writing to many outputs that buffers reads in memory and caps the number of open files
+ *
+ * Reads written to an output are kept in that output's buffer and written out together once the buffer gets large, or once all buffers
+ * together get too large, only maxOpen_ files are kept open at once, the least recently written one is closed when another
+ * needs to be opened and is re-opened in append mode if written to again, files are only created if something is written to them
+ * If BGZF output is turned on fasta and fastq outputs are written compressed, for those outputs reads are formated when added and
+ * the text is buffered instead of a copy of the read
+ *
+ */
+class BufferedMultiSeqOut {
+public:
+	struct Stats {
+		uint64_t outputs_ = 0;
+		uint64_t recordsWritten_ = 0;
+		uint64_t bytesBuffered_ = 0;
+		uint64_t flushes_ = 0;
+		uint64_t opens_ = 0;
+		uint64_t reopens_ = 0;
+		uint64_t evictions_ = 0;
+		uint64_t maxOpen_ = 0;
+		uint64_t maxBufferedBytes_ = 0;
+		uint64_t bgzfBytesIn_ = 0;
+		uint64_t bgzfBytesOut_ = 0;
+
+		void addOtherStats(const Stats & other);
+	};
+
+	/**@brief
+	 *
+	 * @param maxOpen the max number of output files to have open at once
+	 * @param bufferSize the approximate bytes to buffer for an output before writing it out
+	 * @param totalBufferSize the approximate bytes to buffer over all the outputs before writing out the largest buffers
+	 */
+	BufferedMultiSeqOut(uint32_t maxOpen = 256, uint64_t bufferSize = 1024 * 1024,
+			uint64_t totalBufferSize = 512 * 1024 * 1024);
+
+	~BufferedMultiSeqOut();
+
+	uint32_t maxOpen_;
+	uint64_t bufferSize_;
+	uint64_t totalBufferSize_;
+	Stats stats_;
+
+	/**@brief write fasta and fastq outputs added after this as BGZF
+	 *
+	 * @param numThreads the number of threads to compress with
+	 * @param level the zlib compression level
+	 */
+	void setBgzfOutput(uint32_t numThreads, int32_t level);
+
+	void addReader(const std::string & uid, const SeqIOOptions & opts);
+	bool containsReader(const std::string & uid) const;
+
+	template<typename T>
+	void openWrite(const std::string & uid, const T & read) {
+		auto & output = getOutput(uid);
+		if (output.bgzf_) {
+			std::stringstream text;
+			BgzfSeqOutput::formatRecord(text, read, output.opts_);
+			addText(uid, output, text.str());
+			return;
+		}
+		auto copy = copyRecord(read);
+		addRecord(uid, recordBytes(read), [copy](SeqOutput & out) {
+			out.openWrite(copy);
+		});
+	}
+
+	void openWriteFlow(const std::string & uid, const sffObject & read);
+
+	void closeOut(const std::string & uid);
+	void closeOutAll();
+
+	/**@brief write out everything buffered, close the outputs and get the size of each output file created so far
+	 *
+	 * @return the uid of each created output to the size of its file
+	 */
+	std::map<std::string, uint64_t> checkpoint();
+
+	/**@brief set the outputs back to how they were at a checkpoint(), files are cut back to their checkpoint size and written to in
+	 * append mode, files for outputs that weren't created by the checkpoint are removed
+	 *
+	 * @param sizes the output sizes returned by checkpoint()
+	 */
+	void restore(const std::map<std::string, uint64_t> & sizes);
+
+	static void writeStats(std::ostream & out, const Stats & stats);
+
+private:
+	struct Output {
+		Output(const SeqIOOptions & opts);
+		SeqIOOptions opts_;
+		std::unique_ptr<SeqOutput> out_;
+		std::vector<std::function<void(SeqOutput &)>> buffer_;
+		bool bgzf_ = false;
+		std::unique_ptr<BgzfSeqOutput> bgzfOut_;
+		std::string text_;
+		uint64_t bufferedBytes_ = 0;
+		bool created_ = false;
+		std::list<std::string>::iterator openPos_;
+	};
+	std::unordered_map<std::string, std::unique_ptr<Output>> outputs_;
+	//open outputs, most recently written at the front
+	std::list<std::string> openOrder_;
+	uint64_t totalBufferedBytes_ = 0;
+	bool bgzf_ = false;
+	uint32_t bgzfThreads_ = 1;
+	int32_t bgzfLevel_ = Z_DEFAULT_COMPRESSION;
+
+	Output & getOutput(const std::string & uid);
+	void addRecord(const std::string & uid, uint64_t bytes,
+			const std::function<void(SeqOutput &)> & record);
+	void addText(const std::string & uid, Output & output, const std::string & text);
+	void addBytes(const std::string & uid, Output & output, uint64_t bytes);
+	bool isOpen(const Output & output) const;
+	void openOutput(const std::string & uid, Output & output);
+	void flush(const std::string & uid, Output & output);
+	void flushLargest();
+	void closeOutput(Output & output);
+	static bfs::path getOutFnp(const Output & output);
+
+	//reads handed over as pointers are usually re-used for the next read so buffer a copy
+	template<typename T>
+	static T copyRecord(const T & read) {
+		return read;
+	}
+	template<typename T>
+	static std::shared_ptr<T> copyRecord(const std::shared_ptr<T> & read) {
+		return std::make_shared<T>(*read);
+	}
+
+	template<typename T>
+	static uint64_t recordBytes(const T & read) {
+		return 2 * read.seqBase_.seq_.size() + read.seqBase_.name_.size();
+	}
+	template<typename T>
+	static uint64_t recordBytes(const std::shared_ptr<T> & read) {
+		return recordBytes(*read);
+	}
+	static uint64_t recordBytes(const PairedRead & read) {
+		return 2 * read.seqBase_.seq_.size() + read.seqBase_.name_.size()
+				+ 2 * read.mateSeqBase_.seq_.size() + read.mateSeqBase_.name_.size();
+	}
+	static uint64_t recordBytes(const std::string & line) {
+		return line.size();
+	}
+};
+
+}  // namespace bibseq
@@ -0,0 +1,72 @@
+/*
+ * ChimeraPrealigner.cpp
+ *
+ *  Created on: Mar 23, 2017
+ *      Author: nick
+ */
+
+#include "ChimeraPrealigner.hpp"
+
+namespace bibseq {
+
+ChimeraPrealigner::ChimeraPrealigner(uint32_t numThreads) :
+		numThreads_(std::max<uint32_t>(1, numThreads)) {
+}
+
+void ChimeraPrealigner::prealign(const std::vector<cluster> & clusters,
+		aligner & alignerObj, const ChimeraOpts & chiOpts) {
+	//most abundant first so each child's possible parents are the clusters before it
+	std::vector<uint32_t> positions(clusters.size());
+	std::iota(positions.begin(), positions.end(), 0);
+	std::stable_sort(positions.begin(), positions.end(),
+			[&clusters](uint32_t pos1, uint32_t pos2) {
+				return clusters[pos1].seqBase_.cnt_ > clusters[pos2].seqBase_.cnt_;
+			});
+	concurrent::AlignerPool alnPool(alignerObj, numThreads_);
+	alnPool.initAligners();
+	std::vector<decltype(alnPool.popAligner())> threadAligners;
+	for (uint32_t t = 0; t < numThreads_; ++t) {
+		threadAligners.emplace_back(alnPool.popAligner());
+	}
+	std::vector<std::exception_ptr> exceptions(numThreads_);
+	std::atomic<uint32_t> nextChild { 1 };
+	auto alignChildren = [&](uint32_t threadNum) {
+		try {
+			auto & threadAligner = *threadAligners[threadNum];
+			for (uint32_t childPos = nextChild++; childPos < positions.size(); childPos = nextChild++) {
+				const auto & child = clusters[positions[childPos]];
+				for (uint32_t parentPos = 0; parentPos < childPos; ++parentPos) {
+					const auto & parent = clusters[positions[parentPos]];
+					//sorted so the rest are less abundant
+					if (parent.seqBase_.cnt_ < chiOpts.parentFreqs_ * child.seqBase_.cnt_) {
+						break;
+					}
+					threadAligner.alignCacheGlobal(parent, child);
+				}
+			}
+		} catch (...) {
+			exceptions[threadNum] = std::current_exception();
+		}
+	};
+	std::vector<std::thread> threads;
+	for (uint32_t t = 0; t < numThreads_; ++t) {
+		threads.emplace_back(alignChildren, t);
+	}
+	for (auto & t : threads) {
+		t.join();
+	}
+	for (const auto & e : exceptions) {
+		if (nullptr != e) {
+			std::rethrow_exception(e);
+		}
+	}
+	//the thread aligners started as copies so their counts past alignerObj's are the alignments they did
+	uint64_t startingAlignments = alignerObj.numberOfAlingmentsDone_;
+	for (uint32_t t = 0; t < numThreads_; ++t) {
+		alignerObj.alnHolder_.mergeOtherHolder(threadAligners[t]->alnHolder_);
+		alignmentsDone_ += threadAligners[t]->numberOfAlingmentsDone_ - startingAlignments;
+	}
+	alignerObj.numberOfAlingmentsDone_ += alignmentsDone_;
+}
+
+}  // namespace bibseq
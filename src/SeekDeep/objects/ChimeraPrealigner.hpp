@@ -0,0 +1,40 @@
+#pragma once
+
+/*
+ * ChimeraPrealigner.hpp
+ *
+ *  Created on: Mar 23, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+
+namespace bibseq {
+
+/**@brief Does the global alignments of each cluster against its possible chimera parents on several threads ahead of
+ * collapser::markChimeras() and puts them in the aligner's cache
+ *
+ * markChimeras() then finds its alignments in the cache rather than aligning them one at a time, a cached alignment is the
+ * same alignment markChimeras() would have done so which clusters are marked doesn't change
+ *
+ */
+class ChimeraPrealigner {
+public:
+	ChimeraPrealigner(uint32_t numThreads);
+
+	const uint32_t numThreads_;
+	//alignments done by the threads, also added to the aligner's numberOfAlingmentsDone_
+	uint64_t alignmentsDone_ = 0;
+
+	/**@brief align each cluster to every cluster at least chiOpts.parentFreqs_ times as abundant, children are split between the
+	 * threads and each thread has its own copy of alignerObj, the threads' alignments are then merged into alignerObj's cache
+	 *
+	 * @param clusters the clusters markChimeras() will be run on
+	 * @param alignerObj the aligner markChimeras() will be run with
+	 * @param chiOpts the chimera options markChimeras() will be run with
+	 */
+	void prealign(const std::vector<cluster> & clusters, aligner & alignerObj,
+			const ChimeraOpts & chiOpts);
+};
+
+}  // namespace bibseq
@@ -0,0 +1,113 @@
+/*
+ * ClusterKmerIndex.cpp
+ *
+ *  Created on: Mar 23, 2017
+ *      Author: nick
+ */
+
+#include "ClusterKmerIndex.hpp"
+
+namespace bibseq {
+
+ClusterKmerIndex::ClusterKmerIndex(uint32_t kLen) :
+		kLen_(kLen) {
+	if (0 == kLen_ || kLen_ > 32) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: kLen should be between 1 and 32, not "
+				<< kLen_ << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+}
+
+uint32_t ClusterKmerIndex::countKmers(const std::string & seq,
+		std::vector<std::pair<uint64_t, uint32_t>> & counts) {
+	counts.clear();
+	packed_.assign(seq);
+	packed_.kmers(kLen_, kmers_);
+	std::sort(kmers_.begin(), kmers_.end());
+	for (const auto kmer : kmers_) {
+		if (counts.empty() || counts.back().first != kmer) {
+			counts.emplace_back(kmer, 0);
+		}
+		++counts.back().second;
+	}
+	return kmers_.size();
+}
+
+void ClusterKmerIndex::build(const std::vector<cluster> & clusters,
+		const std::vector<uint32_t> & positions) {
+	postings_.clear();
+	kmerCounts_.assign(clusters.size(), 0);
+	lengths_.assign(clusters.size(), 0);
+	indexed_.assign(clusters.size(), 0);
+	ambiguous_.assign(clusters.size(), 0);
+	clusterKmers_.assign(clusters.size(), {});
+	shared_.assign(clusters.size(), 0);
+	touched_.clear();
+	queryPos_ = std::numeric_limits<uint32_t>::max();
+	for (const auto pos : positions) {
+		auto & counts = clusterKmers_[pos];
+		kmerCounts_[pos] = countKmers(clusters[pos].seqBase_.seq_, counts);
+		lengths_[pos] = clusters[pos].seqBase_.seq_.size();
+		indexed_[pos] = 1;
+		//kmers with an N (or any base other than A,C,G,T) weren't counted
+		uint32_t allKmers = lengths_[pos] >= kLen_ ? lengths_[pos] - kLen_ + 1 : 0;
+		ambiguous_[pos] = kmerCounts_[pos] != allKmers;
+		for (const auto & count : counts) {
+			postings_[count.first].emplace_back(pos, count.second);
+		}
+	}
+}
+
+void ClusterKmerIndex::setQuery(uint32_t pos) {
+	if (pos >= indexed_.size() || !indexed_[pos]) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: position " << pos
+				<< " wasn't indexed" << "\n";
+		throw std::out_of_range { ss.str() };
+	}
+	for (const auto touchedPos : touched_) {
+		shared_[touchedPos] = 0;
+	}
+	touched_.clear();
+	queryPos_ = pos;
+	//shared kmers counting repeats are the sum of the smaller count of each kmer
+	for (const auto & count : clusterKmers_[pos]) {
+		for (const auto & entry : postings_.at(count.first)) {
+			if (0 == shared_[entry.first]) {
+				touched_.emplace_back(entry.first);
+			}
+			shared_[entry.first] += std::min(count.second, entry.second);
+		}
+	}
+}
+
+bool ClusterKmerIndex::couldMatch(uint32_t pos, uint64_t maxEdits,
+		bool endGapsCounted) const {
+	if (std::numeric_limits<uint32_t>::max() == queryPos_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: setQuery() has to be called first" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	if (pos >= indexed_.size() || !indexed_[pos]) {
+		return true;
+	}
+	//with free end gaps the sequences could overlap by any amount and an N could match any base, neither leaves a bound on the
+	//shared kmers
+	if (!endGapsCounted || ambiguous_[pos] || ambiguous_[queryPos_]) {
+		return true;
+	}
+	uint64_t lenDiff = lengths_[pos] > lengths_[queryPos_] ?
+			lengths_[pos] - lengths_[queryPos_] : lengths_[queryPos_] - lengths_[pos];
+	if (lenDiff > maxEdits) {
+		return false;
+	}
+	uint64_t alignedKmers = std::max(kmerCounts_[pos], kmerCounts_[queryPos_]);
+	uint64_t lostKmers = maxEdits * kLen_;
+	if (alignedKmers <= lostKmers) {
+		return true;
+	}
+	return shared_[pos] >= alignedKmers - lostKmers;
+}
+
+}  // namespace bibseq
@@ -0,0 +1,78 @@
+#pragma once
+
+/*
+ * ClusterKmerIndex.hpp
+ *
+ *  Created on: Mar 23, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+#include "SeekDeep/objects/PackedSeq.hpp"
+
+namespace bibseq {
+
+/**@brief An inverted kmer index over cluster sequences used to skip comparing clusters that share too few kmers to align within the
+ * allowed errors
+ *
+ * Each edit between two sequences can remove at most kLen of the kmers they share (counting repeated kmers), so two sequences with
+ * at most e edits share at least (number of kmers of the longer sequence) - kLen * e kmers, this only holds when the sequences are
+ * aligned end to end and every base is A,C,G or T, so sequences with an N (or any other base) are never ruled out and nothing is
+ * ruled out when end gaps aren't counted
+ *
+ */
+class ClusterKmerIndex {
+public:
+	ClusterKmerIndex(uint32_t kLen = 8);
+
+	const uint32_t kLen_;
+
+	/**@brief index the sequences of the clusters at positions, replacing whatever was indexed
+	 *
+	 * @param clusters the clusters
+	 * @param positions the positions in clusters to index
+	 */
+	void build(const std::vector<cluster> & clusters,
+			const std::vector<uint32_t> & positions);
+
+	/**@brief count the kmers the cluster at pos shares with every other indexed cluster, for couldMatch()
+	 *
+	 * @param pos a position given to build()
+	 */
+	void setQuery(uint32_t pos);
+
+	/**@brief whether the cluster at pos could be within maxEdits edits of the query set by setQuery()
+	 *
+	 * @param pos a position given to build()
+	 * @param maxEdits the most edits allowed
+	 * @param endGapsCounted whether gaps at the ends count as edits, if not this is always true
+	 * @return false only if the two can't be within maxEdits, always true if either has a base other than A,C,G,T
+	 */
+	bool couldMatch(uint32_t pos, uint64_t maxEdits, bool endGapsCounted) const;
+
+private:
+	//kmer to the positions of the clusters with it and how many times
+	std::unordered_map<uint64_t, std::vector<std::pair<uint32_t, uint32_t>>> postings_;
+	//the distinct kmers of each cluster and their counts
+	std::vector<std::vector<std::pair<uint64_t, uint32_t>>> clusterKmers_;
+	std::vector<uint32_t> kmerCounts_;
+	std::vector<uint32_t> lengths_;
+	std::vector<uint8_t> indexed_;
+	//has a base other than A,C,G,T
+	std::vector<uint8_t> ambiguous_;
+
+	uint32_t queryPos_ = std::numeric_limits<uint32_t>::max();
+	std::vector<uint32_t> shared_;
+	std::vector<uint32_t> touched_;
+
+	/**@brief the distinct kmers of seq and how many times each occurs, returns the total number of kmers without Ns
+	 *
+	 */
+	uint32_t countKmers(const std::string & seq,
+			std::vector<std::pair<uint64_t, uint32_t>> & counts);
+
+	PackedSeq packed_;
+	std::vector<uint64_t> kmers_;
+};
+
+}  // namespace bibseq
@@ -0,0 +1,155 @@
+/*
+ * ClusterPrealigner.cpp
+ *
+ *  Created on: Mar 23, 2017
+ *      Author: nick
+ */
+
+#include "ClusterPrealigner.hpp"
+
+namespace bibseq {
+
+ClusterPrealigner::ClusterPrealigner(const CollapserOpts & opts,
+		uint32_t numThreads) :
+		opts_(opts), numThreads_(std::max<uint32_t>(1, numThreads)) {
+}
+
+void ClusterPrealigner::setAlignmentCache(MappedAlignmentCache * alnCache) {
+	alnCache_ = alnCache;
+}
+
+bool ClusterPrealigner::canPrealign(const CollapserOpts & opts, bool onPerId) {
+	return !opts.alignOpts_.noAlign_ && !onPerId;
+}
+
+void ClusterPrealigner::align(aligner & alignerObj, uint64_t scoringKey,
+		const cluster & ref, const cluster & read) {
+	if (opts_.alignOpts_.local_) {
+		alignerObj.alignCacheLocal(ref, read);
+		return;
+	}
+	if (nullptr == alnCache_) {
+		alignerObj.alignCacheGlobal(ref, read);
+		return;
+	}
+	auto key = MappedAlignmentCache::genKey(scoringKey, ref.seqBase_.seq_,
+			read.seqBase_.seq_);
+	MappedAlignmentCache::Alignment cached;
+	if (alnCache_->get(key, cached)) {
+		//put where alignCacheGlobal() looks so it's found there rather than aligned
+		alignerObj.alnHolder_.globalHolder_[alignerObj.parts_.gapScores_.getIdentifer()].addAlnInfo(
+				ref.seqBase_.seq_, read.seqBase_.seq_, cached.toAlnInfo());
+		alignerObj.alignCacheGlobal(ref, read);
+	} else {
+		alignerObj.alignCacheGlobal(ref, read);
+		alnCache_->add(key,
+				MappedAlignmentCache::Alignment::fromAlnInfo(alignerObj.parts_.gHolder_));
+	}
+}
+
+void ClusterPrealigner::prealign(const std::vector<cluster> & clusters,
+		aligner & alignerObj, const CollapseIterations & iteratorMap) {
+	if (iteratorMap.iters_.empty()) {
+		return;
+	}
+	if (clusters.size() > std::numeric_limits<uint32_t>::max()) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: can't prealign more than "
+				<< std::numeric_limits<uint32_t>::max() << " clusters" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	//most abundant first, tied clusters are candidates of each other so the order ties end up in doesn't matter
+	std::vector<uint32_t> positions;
+	for (uint32_t pos = 0; pos < clusters.size(); ++pos) {
+		if (!clusters[pos].remove) {
+			positions.emplace_back(pos);
+		}
+	}
+	std::stable_sort(positions.begin(), positions.end(),
+			[&clusters](uint32_t pos1, uint32_t pos2) {
+				return clusters[pos1].seqBase_.cnt_ > clusters[pos2].seqBase_.cnt_;
+			});
+	//enough candidates for every iteration
+	uint32_t stopCheck = 0;
+	for (const auto & iter : iteratorMap.iters_) {
+		stopCheck = std::max(stopCheck, iter.second.stopCheck_);
+	}
+	std::vector<std::vector<uint32_t>> candidates(positions.size());
+	for (uint32_t readRank = 0; readRank < positions.size(); ++readRank) {
+		const auto & read = clusters[positions[readRank]];
+		uint32_t considered = 0;
+		for (uint32_t candRank = 0; candRank < positions.size() && considered < stopCheck; ++candRank) {
+			const auto candPos = positions[candRank];
+			if (candRank == readRank) {
+				continue;
+			}
+			if (clusters[candPos].seqBase_.cnt_ < read.seqBase_.cnt_) {
+				break;
+			}
+			++considered;
+			candidates[readRank].emplace_back(candPos);
+		}
+	}
+
+	concurrent::AlignerPool alnPool(alignerObj, numThreads_);
+	alnPool.initAligners();
+	std::vector<decltype(alnPool.popAligner())> threadAligners;
+	for (uint32_t t = 0; t < numThreads_; ++t) {
+		threadAligners.emplace_back(alnPool.popAligner());
+	}
+	uint64_t scoringKey = 0;
+	if (nullptr != alnCache_) {
+		scoringKey = MappedAlignmentCache::scoringKey(alignerObj);
+	}
+	const auto & firstErrors = iteratorMap.iters_.begin()->second.errors_;
+	const uint32_t passesNeeded = opts_.bestMatchOpts_.findingBestMatch_ ?
+			std::max<uint32_t>(1, opts_.bestMatchOpts_.bestMatchCheck_) : 1;
+	std::vector<std::exception_ptr> exceptions(numThreads_);
+	std::atomic<uint32_t> nextRank { 0 };
+	auto alignCandidates = [&](uint32_t threadNum) {
+		try {
+			auto & threadAligner = *threadAligners[threadNum];
+			for (uint32_t readRank = nextRank++; readRank < positions.size(); readRank = nextRank++) {
+				const auto & read = clusters[positions[readRank]];
+				uint32_t passed = 0;
+				for (const auto candPos : candidates[readRank]) {
+					const auto & candidate = clusters[candPos];
+					align(threadAligner, scoringKey, candidate, read);
+					//past enough passing candidates runFullClustering() is unlikely to look, only decides how much is done ahead
+					threadAligner.profileAlignment(candidate, read, false, true,
+							opts_.iTOpts_.weighHomopolyer_);
+					if (firstErrors.passErrorProfile(threadAligner.comp_)) {
+						++passed;
+						if (passed >= passesNeeded) {
+							break;
+						}
+					}
+				}
+			}
+		} catch (...) {
+			exceptions[threadNum] = std::current_exception();
+		}
+	};
+	std::vector<std::thread> threads;
+	for (uint32_t t = 0; t < numThreads_; ++t) {
+		threads.emplace_back(alignCandidates, t);
+	}
+	for (auto & t : threads) {
+		t.join();
+	}
+	for (const auto & e : exceptions) {
+		if (nullptr != e) {
+			std::rethrow_exception(e);
+		}
+	}
+	//the thread aligners started as copies so their counts past alignerObj's are the alignments they did
+	uint64_t startingAlignments = alignerObj.numberOfAlingmentsDone_;
+	uint64_t alignmentsDone = 0;
+	for (uint32_t t = 0; t < numThreads_; ++t) {
+		alignerObj.alnHolder_.mergeOtherHolder(threadAligners[t]->alnHolder_);
+		alignmentsDone += threadAligners[t]->numberOfAlingmentsDone_ - startingAlignments;
+	}
+	alignmentsDone_ += alignmentsDone;
+}
+
+}  // namespace bibseq
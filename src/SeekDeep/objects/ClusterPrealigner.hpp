@@ -0,0 +1,74 @@
+#pragma once
+
+/*
+ * ClusterPrealigner.hpp
+ *
+ *  Created on: Mar 23, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+#include "SeekDeep/objects/MappedAlignmentCache.hpp"
+
+namespace bibseq {
+
+/**@brief Does the alignments collapser::runFullClustering() will look for on several threads ahead of it and puts them in the
+ * aligner's cache
+ *
+ * The clustering itself is left to runFullClustering(), which then finds the alignments in the cache rather than aligning them one
+ * at a time, a cached alignment is the same alignment it would have done so the clusters are the same with any number of threads,
+ * which alignments are done ahead of time only changes how many runFullClustering() still has to do itself
+ *
+ * Each cluster is aligned to the clusters at least as abundant as it, most abundant first, up to the largest stopCheck_ of the
+ * iterations, stopping early once as many pass the first iteration's errors as runFullClustering() would take before picking
+ *
+ */
+class ClusterPrealigner {
+public:
+	/**@brief
+	 *
+	 * @param opts the collapser options runFullClustering() will be run with
+	 * @param numThreads the number of threads
+	 */
+	ClusterPrealigner(const CollapserOpts & opts, uint32_t numThreads);
+
+	CollapserOpts opts_;
+	const uint32_t numThreads_;
+
+	//alignments done by the threads, kept out of the aligner's numberOfAlingmentsDone_ so that still counts only the alignments
+	//runFullClustering() had to do itself
+	uint64_t alignmentsDone_ = 0;
+
+	/**@brief Look alignments up in alnCache before aligning and add the ones done to it, the cache has to outlive the prealigner
+	 *
+	 * @param alnCache the cache, nullptr to stop using one
+	 */
+	void setAlignmentCache(MappedAlignmentCache * alnCache);
+
+	/**@brief align the clusters to their candidates on numThreads_ threads, each with its own copy of alignerObj, and merge the
+	 * alignments into alignerObj's cache
+	 *
+	 * @param clusters the clusters runFullClustering() will be run on
+	 * @param alignerObj the aligner runFullClustering() will be run with
+	 * @param iteratorMap the iterations runFullClustering() will be run with
+	 */
+	void prealign(const std::vector<cluster> & clusters, aligner & alignerObj,
+			const CollapseIterations & iteratorMap);
+
+	/**@brief Whether runFullClustering() aligns clusters with these options, it doesn't when comparing without aligning or
+	 * clustering on percent identity
+	 *
+	 */
+	static bool canPrealign(const CollapserOpts & opts, bool onPerId);
+
+private:
+	MappedAlignmentCache * alnCache_ = nullptr;
+
+	/**@brief align read to ref with alignerObj the way runFullClustering() would, from the alignment cache if there is one
+	 *
+	 */
+	void align(aligner & alignerObj, uint64_t scoringKey, const cluster & ref,
+			const cluster & read);
+};
+
+}  // namespace bibseq
@@ -0,0 +1,137 @@
+/*
+ * ContaminationKmerIndex.cpp
+ *
+ *  Created on: Mar 12, 2017
+ *      Author: nick
+ */
+
+#include "ContaminationKmerIndex.hpp"
+
+namespace bibseq {
+
+uint32_t ContaminationKmerIndex::packedKmers(const std::string & seq,
+		std::vector<uint64_t> & kmers) const {
+	PackedSeq packed(seq);
+	uint32_t otherKmers = packed.kmers(kLen_, kmers);
+	std::sort(kmers.begin(), kmers.end());
+	return otherKmers;
+}
+
+ContaminationKmerIndex::ContaminationKmerIndex(const std::vector<seqInfo> & refs,
+		uint32_t kLen) :
+		kLen_(kLen) {
+	if (0 == kLen_ || kLen_ > 32) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: kLen should be between 1 and 32, not "
+				<< kLen_ << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	for (const auto & ref : refs) {
+		names_.emplace_back(ref.name_);
+	}
+	distinctKmers_ = std::vector<uint32_t>(2 * refs.size(), 0);
+	std::vector<uint64_t> kmers;
+	auto indexSeq = [this, &kmers](const std::string & seq, uint32_t refPos) {
+		packedKmers(seq, kmers);
+		for (auto kmerIt = kmers.begin(); kmerIt != kmers.end();) {
+			auto runEnd = std::upper_bound(kmerIt, kmers.end(), *kmerIt);
+			index_[*kmerIt].emplace_back(RefCount { refPos,
+				static_cast<uint32_t>(runEnd - kmerIt) });
+			++distinctKmers_[refPos];
+			kmerIt = runEnd;
+		}
+	};
+	for (uint32_t refPos = 0; refPos < refs.size(); ++refPos) {
+		indexSeq(refs[refPos].seq_, refPos);
+		indexSeq(seqUtil::reverseComplement(refs[refPos].seq_, "DNA"),
+				refPos + refs.size());
+	}
+}
+
+std::vector<uint32_t> ContaminationKmerIndex::candidates(const std::string & seq,
+		double kmerCutOff, bool forward, bool reverse) const {
+	std::vector<uint64_t> kmers;
+	uint32_t otherKmers = packedKmers(seq, kmers);
+	//shared counts are the larger of the two counts and kmers with other bases are counted as shared with everything,
+	//divided by the fewest distinct kmers of either, so this is an upper bound on the shared kmer fraction
+	std::vector<uint32_t> shared(distinctKmers_.size(), otherKmers);
+	uint32_t readDistinct = 0;
+	for (auto kmerIt = kmers.begin(); kmerIt != kmers.end();) {
+		auto runEnd = std::upper_bound(kmerIt, kmers.end(), *kmerIt);
+		uint32_t count = runEnd - kmerIt;
+		++readDistinct;
+		auto search = index_.find(*kmerIt);
+		if (index_.end() != search) {
+			for (const auto & refCount : search->second) {
+				shared[refCount.refPos_] += std::max(count, refCount.count_);
+			}
+		}
+		kmerIt = runEnd;
+	}
+	std::vector<std::pair<double, uint32_t>> bounds;
+	uint32_t numRefs = names_.size();
+	for (uint32_t refPos = 0; refPos < distinctKmers_.size(); ++refPos) {
+		if ((refPos < numRefs && !forward) || (refPos >= numRefs && !reverse)) {
+			continue;
+		}
+		uint32_t denominator = std::min(readDistinct, distinctKmers_[refPos]);
+		double bound = 0 == denominator ?
+				std::numeric_limits<double>::max() :
+				static_cast<double>(shared[refPos]) / denominator;
+		if (bound >= kmerCutOff) {
+			bounds.emplace_back(bound, refPos);
+		}
+	}
+	std::stable_sort(bounds.begin(), bounds.end(),
+			[](const std::pair<double, uint32_t> & p1,
+					const std::pair<double, uint32_t> & p2) {
+				return p1.first > p2.first;
+			});
+	std::vector<uint32_t> ret;
+	for (const auto & bound : bounds) {
+		ret.emplace_back(bound.second);
+	}
+	return ret;
+}
+
+const ReadCheckerOnKmerComp & ContaminationKmerIndex::getChecker(uint32_t refPos,
+		const std::map<std::string, ReadCheckerOnKmerComp> & forwardCheckers,
+		const std::map<std::string, ReadCheckerOnKmerComp> & reverseCheckers) const {
+	bool isReverse = refPos >= names_.size();
+	const auto & name = names_[isReverse ? refPos - names_.size() : refPos];
+	const auto & checkers = isReverse ? reverseCheckers : forwardCheckers;
+	auto search = checkers.find(name);
+	if (checkers.end() == search) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: no "
+				<< (isReverse ? "reverse" : "forward") << " checker for " << name
+				<< "\n";
+		ss << "Options are: " << bib::conToStr(getVectorOfMapKeys(checkers), ",")
+				<< "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	return search->second;
+}
+
+bool ContaminationKmerIndex::checkRead(seqInfo & info,
+		const std::map<std::string, ReadCheckerOnKmerComp> & forwardCheckers,
+		const std::map<std::string, ReadCheckerOnKmerComp> & reverseCheckers,
+		double kmerCutOff, bool forward, bool reverse) const {
+	if (names_.empty() || (!forward && !reverse)) {
+		return info.on_;
+	}
+	auto refPositions = candidates(info.seq_, kmerCutOff, forward, reverse);
+	for (const auto & refPos : refPositions) {
+		if (getChecker(refPos, forwardCheckers, reverseCheckers).checkRead(info)) {
+			return true;
+		}
+	}
+	if (refPositions.empty()) {
+		//nothing could pass, check against one so the read is marked the same way as a failed check
+		return getChecker(forward ? 0 : names_.size(), forwardCheckers,
+				reverseCheckers).checkRead(info);
+	}
+	return false;
+}
+
+}  // namespace bibseq
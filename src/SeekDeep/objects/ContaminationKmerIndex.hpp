@@ -0,0 +1,87 @@
+#pragma once
+
+/*
+ * ContaminationKmerIndex.hpp
+ *
+ *  Created on: Mar 12, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+#include "SeekDeep/objects/PackedSeq.hpp"
+
+namespace bibseq {
+
+/**@brief One 2bit packed kmer table of all the contamination compare sequences, both the sequences and their reverse complements
+ *
+ * A read's kmers are looked up once to get an upper bound of the kmer fraction it could share with every compare sequence,
+ * only the compare sequences that could pass the kmer cut off are then checked with their ReadCheckerOnKmerComp, best
+ * first, so checking a read no longer needs re-kmerizing it for every compare sequence
+ *
+ */
+class ContaminationKmerIndex {
+public:
+
+	/**@brief Build the index
+	 *
+	 * @param refs the compare sequences, their names should be the keys of the checker maps given to checkRead()
+	 * @param kLen the kmer length, has to be 32 or less
+	 */
+	ContaminationKmerIndex(const std::vector<seqInfo> & refs, uint32_t kLen);
+
+	VecStr names_;
+	uint32_t kLen_;
+
+	/**@brief Get the compare sequences the read could pass the kmer cut off against, sorted by best upper bound first
+	 *
+	 * @param seq the read sequence
+	 * @param kmerCutOff the kmer fraction cut off
+	 * @param forward include the compare sequences as given
+	 * @param reverse include the reverse complements of the compare sequences
+	 * @return positions in names_ for forward and names_.size() + position in names_ for the reverse complements
+	 */
+	std::vector<uint32_t> candidates(const std::string & seq, double kmerCutOff,
+			bool forward, bool reverse) const;
+
+	/**@brief Check the read with the checkers of the candidate compare sequences until one passes
+	 *
+	 * Passes if any of the checkers of the requested directions would pass the read, same as looping over all of them,
+	 * if none pass the read is left as the failing checker left it
+	 *
+	 * @param info the read to check
+	 * @param forwardCheckers the checkers for the compare sequences
+	 * @param reverseCheckers the checkers for the reverse complement of the compare sequences
+	 * @param kmerCutOff the kmer fraction cut off the checkers were made with
+	 * @param forward check against the compare sequences
+	 * @param reverse check against the reverse complement of the compare sequences
+	 * @return whether the read passed
+	 */
+	bool checkRead(seqInfo & info,
+			const std::map<std::string, ReadCheckerOnKmerComp> & forwardCheckers,
+			const std::map<std::string, ReadCheckerOnKmerComp> & reverseCheckers,
+			double kmerCutOff, bool forward, bool reverse) const;
+
+private:
+	struct RefCount {
+		uint32_t refPos_;
+		uint32_t count_;
+	};
+	std::unordered_map<uint64_t, std::vector<RefCount>> index_;
+	//distinct kmers of only A,C,G,T in each reference, forward then reverse complement
+	std::vector<uint32_t> distinctKmers_;
+
+	/**@brief the packed kmers of seq that are only A,C,G,T, sorted
+	 *
+	 * @param seq the sequence to kmerize
+	 * @param kmers filled with the packed kmers
+	 * @return the number of kmers containing something other than A,C,G,T
+	 */
+	uint32_t packedKmers(const std::string & seq,
+			std::vector<uint64_t> & kmers) const;
+
+	const ReadCheckerOnKmerComp & getChecker(uint32_t refPos,
+			const std::map<std::string, ReadCheckerOnKmerComp> & forwardCheckers,
+			const std::map<std::string, ReadCheckerOnKmerComp> & reverseCheckers) const;
+};
+
+}  // namespace bibseq
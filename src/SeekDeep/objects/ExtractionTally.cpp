@@ -0,0 +1,53 @@
+/*
+ * ExtractionTally.cpp
+ *
+ *  Created on: Mar 3, 2017
+ *      Author: nick
+ */
+
+#include "ExtractionTally.hpp"
+
+namespace bibseq {
+
+void ExtractionTally::DirCounts::increaseCount(const std::string & readName) {
+	if (std::string::npos != readName.find("_Comp")) {
+		++revCount_;
+	} else {
+		++forCount_;
+	}
+}
+
+void ExtractionTally::increaseCounts(const std::string & fullname,
+		const std::string & readName, ExtractionStator::extractCase eCase) {
+	counts_[fullname][eCase].increaseCount(readName);
+}
+
+void ExtractionTally::increaseFailedForward(const std::string & midName,
+		const std::string & readName) {
+	failedForward_[midName].increaseCount(readName);
+}
+
+void ExtractionTally::addToStator(ExtractionStator & stats) const {
+	const std::string forName = "read";
+	const std::string revName = "read_Comp";
+	for (const auto & name : counts_) {
+		for (const auto & eCase : name.second) {
+			for (uint32_t count = 0; count < eCase.second.forCount_; ++count) {
+				stats.increaseCounts(name.first, forName, eCase.first);
+			}
+			for (uint32_t count = 0; count < eCase.second.revCount_; ++count) {
+				stats.increaseCounts(name.first, revName, eCase.first);
+			}
+		}
+	}
+	for (const auto & mid : failedForward_) {
+		for (uint32_t count = 0; count < mid.second.forCount_; ++count) {
+			stats.increaseFailedForward(mid.first, forName);
+		}
+		for (uint32_t count = 0; count < mid.second.revCount_; ++count) {
+			stats.increaseFailedForward(mid.first, revName);
+		}
+	}
+}
+
+}  // namespace bibseq
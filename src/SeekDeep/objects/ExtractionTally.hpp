@@ -0,0 +1,41 @@
+#pragma once
+
+/*
+ * ExtractionTally.hpp
+ *
+ *  Created on: Mar 3, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+
+namespace bibseq {
+
+/**@brief Keeps the counts that go into an ExtractionStator without needing the total read counts up front
+ *
+ * ExtractionStator needs the total read, unrecognized barcode and small fragment counts on construction which
+ * aren't known until all reads have been seen when extracting in a single pass, this just tallies the forward and
+ * reverse (_Comp) counts per name and case and they are added to a ExtractionStator once all reads have been processed
+ *
+ */
+class ExtractionTally {
+public:
+
+	struct DirCounts {
+		uint32_t forCount_ = 0;
+		uint32_t revCount_ = 0;
+		void increaseCount(const std::string & readName);
+	};
+
+	std::map<std::string, std::map<ExtractionStator::extractCase, DirCounts>> counts_;
+	std::map<std::string, DirCounts> failedForward_;
+
+	void increaseCounts(const std::string & fullname, const std::string & readName,
+			ExtractionStator::extractCase eCase);
+	void increaseFailedForward(const std::string & midName,
+			const std::string & readName);
+
+	void addToStator(ExtractionStator & stats) const;
+};
+
+}  // namespace bibseq
@@ -0,0 +1,115 @@
+/*
+ * ExtractorCheckpoint.cpp
+ *
+ *  Created on: Mar 20, 2017
+ *      Author: nick
+ */
+
+#include "ExtractorCheckpoint.hpp"
+
+namespace bibseq {
+
+void ExtractorCheckpoint::addReadLengths(const std::vector<size_t> & readLens,
+		size_t fromPos) {
+	for (size_t pos = fromPos; pos < readLens.size(); ++pos) {
+		++readLengthCounts_[readLens[pos]];
+	}
+}
+
+std::vector<size_t> ExtractorCheckpoint::getReadLengths() const {
+	std::vector<size_t> ret;
+	for (const auto & lenCount : readLengthCounts_) {
+		ret.insert(ret.end(), lenCount.second, lenCount.first);
+	}
+	return ret;
+}
+
+Json::Value ExtractorCheckpoint::toJson() const {
+	Json::Value ret;
+	ret["barcodesDone"] = bib::json::toJson(barcodesDone_);
+	ret["readsProcessed"] = bib::json::toJson(readsProcessed_);
+	ret["smallFragmentCount"] = bib::json::toJson(smallFragmentCount_);
+	ret["startsWithBadQualCount"] = bib::json::toJson(startsWithBadQualCount_);
+	ret["readsNotMatchedToBarcode"] = bib::json::toJson(readsNotMatchedToBarcode_);
+	ret["readsNotMatchedToBarcodePossContam"] = bib::json::toJson(
+			readsNotMatchedToBarcodePossContam_);
+	auto & counts = ret["counts"];
+	for (const auto & count : counts_) {
+		counts[count.first]["forward"] = bib::json::toJson(count.second.first);
+		counts[count.first]["reverse"] = bib::json::toJson(count.second.second);
+	}
+	auto & failBarCodeCounts = ret["failBarCodeCounts"];
+	for (const auto & count : failBarCodeCounts_) {
+		failBarCodeCounts[count.first] = bib::json::toJson(count.second);
+	}
+	auto & failBarCodeCountsPossibleContamination =
+			ret["failBarCodeCountsPossibleContamination"];
+	for (const auto & count : failBarCodeCountsPossibleContamination_) {
+		failBarCodeCountsPossibleContamination[count.first] = bib::json::toJson(
+				count.second);
+	}
+	auto & readLengthCounts = ret["readLengthCounts"];
+	for (const auto & count : readLengthCounts_) {
+		readLengthCounts[estd::to_string(count.first)] = bib::json::toJson(
+				count.second);
+	}
+	auto & outputSizes = ret["outputSizes"];
+	for (const auto & size : outputSizes_) {
+		outputSizes[size.first] = bib::json::toJson(size.second);
+	}
+	return ret;
+}
+
+void ExtractorCheckpoint::write(const bfs::path & fnp) const {
+	auto tempFnp = bfs::path(fnp.string() + ".tmp");
+	{
+		std::ofstream out(tempFnp.string());
+		if (!out) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error: couldn't open " << tempFnp
+					<< " for writing" << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		out << toJson();
+	}
+	bfs::rename(tempFnp, fnp);
+}
+
+ExtractorCheckpoint ExtractorCheckpoint::read(const bfs::path & fnp) {
+	if (!bfs::exists(fnp)) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: checkpoint file " << fnp
+				<< " doesn't exist" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	auto json = bib::json::parseFile(fnp.string());
+	ExtractorCheckpoint ret;
+	ret.barcodesDone_ = json["barcodesDone"].asBool();
+	ret.readsProcessed_ = json["readsProcessed"].asUInt64();
+	ret.smallFragmentCount_ = json["smallFragmentCount"].asUInt();
+	ret.startsWithBadQualCount_ = json["startsWithBadQualCount"].asUInt();
+	ret.readsNotMatchedToBarcode_ = json["readsNotMatchedToBarcode"].asUInt();
+	ret.readsNotMatchedToBarcodePossContam_ =
+			json["readsNotMatchedToBarcodePossContam"].asUInt();
+	for (const auto & name : json["counts"].getMemberNames()) {
+		ret.counts_[name] = {json["counts"][name]["forward"].asUInt(),
+				json["counts"][name]["reverse"].asUInt()};
+	}
+	for (const auto & name : json["failBarCodeCounts"].getMemberNames()) {
+		ret.failBarCodeCounts_[name] = json["failBarCodeCounts"][name].asUInt();
+	}
+	for (const auto & name : json["failBarCodeCountsPossibleContamination"].getMemberNames()) {
+		ret.failBarCodeCountsPossibleContamination_[name] =
+				json["failBarCodeCountsPossibleContamination"][name].asUInt();
+	}
+	for (const auto & len : json["readLengthCounts"].getMemberNames()) {
+		ret.readLengthCounts_[estd::stou(len)] =
+				json["readLengthCounts"][len].asUInt64();
+	}
+	for (const auto & name : json["outputSizes"].getMemberNames()) {
+		ret.outputSizes_[name] = json["outputSizes"][name].asUInt64();
+	}
+	return ret;
+}
+
+}  // namespace bibseq
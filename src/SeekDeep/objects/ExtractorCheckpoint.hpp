@@ -0,0 +1,56 @@
+#pragma once
+
+/*
+ * ExtractorCheckpoint.hpp
+ *
+ *  Created on: Mar 20, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+
+namespace bibseq {
+
+/**@brief The state of the extractor's barcode pass at a point where all the outputs have been written out, used to resume a killed run
+ *
+ * The input position is stored as the number of reads processed so on resume that many reads are skipped, the output sizes are used
+ * to cut off anything written after the checkpoint
+ *
+ */
+class ExtractorCheckpoint {
+public:
+	//whether the whole barcode pass was finished
+	bool barcodesDone_ = false;
+	uint64_t readsProcessed_ = 0;
+	uint32_t smallFragmentCount_ = 0;
+	uint32_t startsWithBadQualCount_ = 0;
+	uint32_t readsNotMatchedToBarcode_ = 0;
+	uint32_t readsNotMatchedToBarcodePossContam_ = 0;
+	std::map<std::string, std::pair<uint32_t, uint32_t>> counts_;
+	std::unordered_map<std::string, uint32_t> failBarCodeCounts_;
+	std::unordered_map<std::string, uint32_t> failBarCodeCountsPossibleContamination_;
+	//read length to number of reads with that length
+	std::map<size_t, uint64_t> readLengthCounts_;
+	//output uid to the size of its file
+	std::map<std::string, uint64_t> outputSizes_;
+
+	/**@brief add the lengths in readLens from position fromPos on to readLengthCounts_
+	 *
+	 * @param readLens the lengths
+	 * @param fromPos the position to start at
+	 */
+	void addReadLengths(const std::vector<size_t> & readLens, size_t fromPos);
+	std::vector<size_t> getReadLengths() const;
+
+	Json::Value toJson() const;
+
+	/**@brief write to a temporary file and then move it over fnp so a checkpoint is never half written
+	 *
+	 * @param fnp the checkpoint file
+	 */
+	void write(const bfs::path & fnp) const;
+
+	static ExtractorCheckpoint read(const bfs::path & fnp);
+};
+
+}  // namespace bibseq
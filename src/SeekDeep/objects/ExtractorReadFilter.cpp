@@ -0,0 +1,129 @@
+/*
+ * ExtractorReadFilter.cpp
+ *
+ *  Created on: Mar 24, 2017
+ *      Author: nick
+ */
+
+#include "ExtractorReadFilter.hpp"
+
+namespace bibseq {
+
+ExtractorReadFilter::ExtractorReadFilter(const extractorPars & pars,
+		const table & primerTable, const ReadCheckerOnKmerComp * compareInfo,
+		const ReadCheckerOnKmerComp * compareInfoRev,
+		const std::map<std::string, ReadCheckerOnKmerComp> & compareInfos,
+		const std::map<std::string, ReadCheckerOnKmerComp> & compareInfosRev,
+		const ContaminationKmerIndex * contaminationIndex,
+		const std::map<std::string, LenCutOffs> & lenCutOffs,
+		const std::map<std::string, LenCutOffs> * mateLenCutOffs,
+		const ReadChecker & nChecker, const ReadChecker & qualChecker) :
+		pars_(pars), primerTable_(primerTable), compareInfo_(compareInfo), compareInfoRev_(
+				compareInfoRev), compareInfos_(compareInfos), compareInfosRev_(
+				compareInfosRev), contaminationIndex_(contaminationIndex), lenCutOffs_(
+				lenCutOffs), mateLenCutOffs_(mateLenCutOffs), nChecker_(nChecker), qualChecker_(
+				qualChecker) {
+}
+
+uint64_t ExtractorReadFilter::readBytes(const readObject & seq) {
+	return seq.seqBase_.name_.size() + seq.seqBase_.seq_.size()
+			+ seq.seqBase_.qual_.size();
+}
+
+uint64_t ExtractorReadFilter::readBytes(const PairedRead & seq) {
+	return seq.seqBase_.name_.size() + seq.seqBase_.seq_.size()
+			+ seq.seqBase_.qual_.size() + seq.mateSeqBase_.name_.size()
+			+ seq.mateSeqBase_.seq_.size() + seq.mateSeqBase_.qual_.size();
+}
+
+void ExtractorReadFilter::screenContamination(seqInfo & info,
+		const std::string & primerName, bool foundInReverse) const {
+	if (pars_.multipleTargets) {
+		if (compareInfos_.find(primerName) != compareInfos_.end()) {
+			if (foundInReverse) {
+				compareInfosRev_.at(primerName).checkRead(info);
+			} else {
+				compareInfos_.at(primerName).checkRead(info);
+			}
+		} else {
+			std::stringstream ss;
+			ss
+					<< "Error in screening for contamination, multiple targets turned on but no contamination found for "
+					<< primerName << std::endl;
+			ss << "Options are: "
+					<< vectorToString(getVectorOfMapKeys(compareInfos_), ",")
+					<< std::endl;
+			throw std::runtime_error{ss.str()};
+		}
+	} else {
+		if (pars_.contaminationMutlipleCompare && nullptr != contaminationIndex_) {
+			contaminationIndex_->checkRead(info, compareInfos_, compareInfosRev_,
+					pars_.kmerCutOff, !foundInReverse, foundInReverse);
+		} else if(pars_.contaminationMutlipleCompare){
+			//if it passes at least one of the multiple compares given in compareSeq filename
+			if (foundInReverse) {
+				for(const auto & compares : compareInfosRev_){
+					if(compares.second.checkRead(info)){
+						break;
+					}
+				}
+			}else{
+				for(const auto & compares : compareInfos_){
+					if(compares.second.checkRead(info)){
+						break;
+					}
+				}
+			}
+		}else{
+			if (foundInReverse) {
+				compareInfoRev_->checkRead(info);
+			} else {
+				compareInfo_->checkRead(info);
+			}
+		}
+	}
+}
+
+const ExtractorReadFilter::LenCutOffs & ExtractorReadFilter::mateCutOffs(
+		const std::string & primerName) const {
+	if (nullptr == mateLenCutOffs_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__
+				<< ", error: filtering paired reads needs the length cut offs of the second mate"
+				<< "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	return mateLenCutOffs_->at(primerName);
+}
+
+void ExtractorReadFilter::checkMinLen(readObject & seq,
+		const std::string & primerName) const {
+	lenCutOffs_.at(primerName).minLenChecker_.checkRead(seq.seqBase_);
+}
+
+void ExtractorReadFilter::checkMinLen(PairedRead & seq,
+		const std::string & primerName) const {
+	lenCutOffs_.at(primerName).minLenChecker_.checkRead(seq.seqBase_);
+	mateCutOffs(primerName).minLenChecker_.checkRead(seq.mateSeqBase_);
+}
+
+void ExtractorReadFilter::checkMaxLen(readObject & seq,
+		const std::string & primerName) const {
+	lenCutOffs_.at(primerName).maxLenChecker_.checkRead(seq.seqBase_);
+}
+
+void ExtractorReadFilter::checkMaxLen(PairedRead & seq,
+		const std::string & primerName) const {
+	lenCutOffs_.at(primerName).maxLenChecker_.checkRead(seq.seqBase_);
+	mateCutOffs(primerName).maxLenChecker_.checkRead(seq.mateSeqBase_);
+}
+
+void ExtractorReadFilter::check(const ReadChecker & checker, readObject & seq) {
+	checker.checkRead(seq.seqBase_);
+}
+
+void ExtractorReadFilter::check(const ReadChecker & checker, PairedRead & seq) {
+	checker.checkRead(seq);
+}
+
+}  // namespace bibseq
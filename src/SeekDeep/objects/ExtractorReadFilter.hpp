@@ -0,0 +1,256 @@
+#pragma once
+
+/*
+ * ExtractorReadFilter.hpp
+ *
+ *  Created on: Mar 24, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+#include "SeekDeep/parameters/setUpPars.hpp"
+#include "SeekDeep/objects/ContaminationKmerIndex.hpp"
+#include "SeekDeep/objects/ShortlistPrimerDeterminator.hpp"
+#include "SeekDeep/objects/StageTimingProfile.hpp"
+
+namespace bibseq {
+
+/**@brief The filtering done on reads after they are matched to a barcode, shared by extractor and extractorPairedEnd
+ *
+ * Checks the forward primer, possible contamination, min length, the reverse primer, min length again, Ns, max length and
+ * quality in that order, works on readObject and PairedRead, for PairedRead the lengths of both mates are checked and
+ * the N and quality checks are done on the pair, only holds references to the extractor's set up so it can be shared by
+ * the filtering threads, each thread passes in it's own aligner and primer determinators
+ *
+ */
+class ExtractorReadFilter {
+public:
+	struct LenCutOffs {
+		LenCutOffs(uint32_t minLen, uint32_t maxLen, bool mark = true) :
+				minLenChecker_(ReadCheckerLenAbove(minLen, mark)), maxLenChecker_(
+						ReadCheckerLenBelow(maxLen, mark)) {
+		}
+		ReadCheckerLenAbove minLenChecker_;
+		ReadCheckerLenBelow maxLenChecker_;
+	};
+
+	struct Result {
+		std::string primerName_;
+		std::string fullname_;
+		bool failedForward_ = false;
+		ExtractionStator::extractCase case_ = ExtractionStator::extractCase::GOOD;
+	};
+
+	/**@brief
+	 *
+	 * @param pars the extractor parameters
+	 * @param primerTable the primer table, the first target is used when there's no forward primer
+	 * @param compareInfo the contamination checker for a single compare sequence, nullptr if not screening this way
+	 * @param compareInfoRev the reverse complement of compareInfo
+	 * @param compareInfos the contamination checkers for multiple targets or multiple compare sequences
+	 * @param compareInfosRev the reverse complements of compareInfos
+	 * @param contaminationIndex kmer index of the multiple compare sequences, nullptr to check them all
+	 * @param lenCutOffs the length cut offs per target, for PairedRead the first mate's
+	 * @param mateLenCutOffs the length cut offs per target for the second mate of PairedRead, nullptr for readObject
+	 * @param nChecker the N checker
+	 * @param qualChecker the quality checker
+	 */
+	ExtractorReadFilter(const extractorPars & pars, const table & primerTable,
+			const ReadCheckerOnKmerComp * compareInfo,
+			const ReadCheckerOnKmerComp * compareInfoRev,
+			const std::map<std::string, ReadCheckerOnKmerComp> & compareInfos,
+			const std::map<std::string, ReadCheckerOnKmerComp> & compareInfosRev,
+			const ContaminationKmerIndex * contaminationIndex,
+			const std::map<std::string, LenCutOffs> & lenCutOffs,
+			const std::map<std::string, LenCutOffs> * mateLenCutOffs,
+			const ReadChecker & nChecker, const ReadChecker & qualChecker);
+
+	const extractorPars & pars_;
+	/**@brief whether to check the max length, extractorPairedEnd doesn't
+	 *
+	 */
+	bool checkMaxLen_ = true;
+
+	/**@brief Filter a read
+	 *
+	 * @param seq the read, turned off if it fails, reverse complemented if the primers were found in the reverse direction
+	 * @param barcodeName the barcode the read was matched to
+	 * @param alignObj the calling thread's aligner
+	 * @param pDetermine the calling thread's primer determinator
+	 * @param shortlistPDetermine the calling thread's shortlist primer determinator, nullptr to use pDetermine
+	 * @param timing where to time the stages, nullptr to not time
+	 * @param result the primer, the output name and the filter case of the read
+	 */
+	template<typename READ>
+	void filter(std::shared_ptr<READ> & seq, const std::string & barcodeName,
+			aligner & alignObj, PrimerDeterminator & pDetermine,
+			ShortlistPrimerDeterminator * shortlistPDetermine,
+			StageTimingProfile * timing, Result & result) const {
+		//filter on primers
+		//forward
+		StageTimingProfile::Timer forwardTimer(timing, "primerDetermination", readBytes(*seq));
+		std::string primerName = "";
+		bool foundInReverse = false;
+		if (pars_.noForwardPrimer) {
+			primerName = primerTable_.content_.front()[primerTable_.getColPos(
+					"geneName")];
+		} else {
+			uint32_t start = 0;
+			if (!pars_.multiplex) {
+				start = pars_.mDetPars.variableStop_;
+			}
+			if (nullptr != shortlistPDetermine) {
+				primerName = shortlistPDetermine->determineForwardPrimer(seq, start, alignObj,
+						pars_.fPrimerErrors, !pars_.forwardPrimerToUpperCase);
+			} else {
+				primerName = pDetermine.determineForwardPrimer(seq, start, alignObj,
+						pars_.fPrimerErrors, !pars_.forwardPrimerToUpperCase);
+			}
+			if (primerName == "unrecognized" && pars_.mDetPars.checkComplement_) {
+				if (nullptr != shortlistPDetermine) {
+					primerName = shortlistPDetermine->determineWithReversePrimer(seq, start,
+							alignObj, pars_.fPrimerErrors, !pars_.forwardPrimerToUpperCase);
+				} else {
+					primerName = pDetermine.determineWithReversePrimer(seq, start,
+							alignObj, pars_.fPrimerErrors, !pars_.forwardPrimerToUpperCase);
+				}
+				if (seq->seqBase_.on_) {
+					foundInReverse = true;
+				}
+			}
+			if (!seq->seqBase_.on_) {
+				result.failedForward_ = true;
+				return;
+			}
+		}
+		forwardTimer.bytesOut_ = readBytes(*seq);
+		forwardTimer.stop();
+		result.primerName_ = primerName;
+		result.fullname_ = primerName;
+		if (pars_.multiplex) {
+			result.fullname_ += barcodeName;
+		} else if (pars_.sampleName != "") {
+			result.fullname_ += pars_.sampleName;
+		}
+
+		//look for possible contamination
+		if (pars_.screenForPossibleContamination) {
+			StageTimingProfile::Timer timer(timing, "contaminationScreening", readBytes(*seq));
+			screenContamination(seq->seqBase_, primerName, foundInReverse);
+			if (!seq->seqBase_.on_) {
+				result.case_ = ExtractionStator::extractCase::CONTAMINATION;
+				return;
+			}
+		}
+
+		//min len
+		{
+			StageTimingProfile::Timer timer(timing, "lengthChecks", readBytes(*seq));
+			//reads were already counted for the length stage by the small fragment check
+			timer.reads_ = 0;
+			checkMinLen(*seq, primerName);
+			if (!seq->seqBase_.on_) {
+				result.case_ = ExtractionStator::extractCase::MINLENBAD;
+				return;
+			}
+			timer.bytesOut_ = readBytes(*seq);
+		}
+
+		//reverse
+		if (!pars_.noReversePrimer) {
+			StageTimingProfile::Timer timer(timing, "primerDetermination", readBytes(*seq));
+			//reads were already counted for the primer stage by the forward primer search
+			timer.reads_ = 0;
+			if (foundInReverse) {
+				pDetermine.checkForForwardPrimerInRev(seq, primerName, alignObj,
+						pars_.rPrimerErrors, !pars_.reversePrimerToUpperCase,
+						pars_.mDetPars.variableStop_, false);
+			} else {
+				pDetermine.checkForReversePrimer(seq, primerName, alignObj,
+						pars_.rPrimerErrors, !pars_.reversePrimerToUpperCase,
+						pars_.mDetPars.variableStop_, false);
+			}
+			if (!seq->seqBase_.on_) {
+				result.case_ = ExtractionStator::extractCase::BADREVERSE;
+				return;
+			}
+			timer.bytesOut_ = readBytes(*seq);
+		}
+		StageTimingProfile::Timer lenTimer(timing, "lengthChecks", readBytes(*seq));
+		lenTimer.reads_ = 0;
+		//min len again becuase the reverse primer search trims to the reverse primer so it could be short again
+		checkMinLen(*seq, primerName);
+		if (!seq->seqBase_.on_) {
+			result.case_ = ExtractionStator::extractCase::MINLENBAD;
+			return;
+		}
+		lenTimer.bytesOut_ = readBytes(*seq);
+		lenTimer.stop();
+
+		//if found in the reverse direction need to re-orient now
+		if (foundInReverse) {
+			seq->seqBase_.reverseComplementRead(true, true);
+		}
+
+		StageTimingProfile::Timer nTimer(timing, "qualityChecks", readBytes(*seq));
+		//contains n
+		check(nChecker_, *seq);
+		if (!seq->seqBase_.on_) {
+			result.case_ = ExtractionStator::extractCase::CONTAINSNS;
+			return;
+		}
+		nTimer.stop();
+
+		//max len
+		if (checkMaxLen_) {
+			StageTimingProfile::Timer timer(timing, "lengthChecks", readBytes(*seq));
+			timer.reads_ = 0;
+			checkMaxLen(*seq, primerName);
+			if (!seq->seqBase_.on_) {
+				result.case_ = ExtractionStator::extractCase::MAXLENBAD;
+				return;
+			}
+			timer.bytesOut_ = readBytes(*seq);
+		}
+
+		//quality
+		StageTimingProfile::Timer qualityTimer(timing, "qualityChecks", readBytes(*seq));
+		qualityTimer.reads_ = 0;
+		check(qualChecker_, *seq);
+		if (!seq->seqBase_.on_) {
+			result.case_ = ExtractionStator::extractCase::QUALITYFAILED;
+			return;
+		}
+		result.case_ = ExtractionStator::extractCase::GOOD;
+	}
+
+	static uint64_t readBytes(const readObject & seq);
+	static uint64_t readBytes(const PairedRead & seq);
+
+private:
+	const table & primerTable_;
+	const ReadCheckerOnKmerComp * compareInfo_;
+	const ReadCheckerOnKmerComp * compareInfoRev_;
+	const std::map<std::string, ReadCheckerOnKmerComp> & compareInfos_;
+	const std::map<std::string, ReadCheckerOnKmerComp> & compareInfosRev_;
+	const ContaminationKmerIndex * contaminationIndex_;
+	const std::map<std::string, LenCutOffs> & lenCutOffs_;
+	const std::map<std::string, LenCutOffs> * mateLenCutOffs_;
+	const ReadChecker & nChecker_;
+	const ReadChecker & qualChecker_;
+
+	void screenContamination(seqInfo & info, const std::string & primerName,
+			bool foundInReverse) const;
+
+	void checkMinLen(readObject & seq, const std::string & primerName) const;
+	void checkMinLen(PairedRead & seq, const std::string & primerName) const;
+	void checkMaxLen(readObject & seq, const std::string & primerName) const;
+	void checkMaxLen(PairedRead & seq, const std::string & primerName) const;
+
+	static void check(const ReadChecker & checker, readObject & seq);
+	static void check(const ReadChecker & checker, PairedRead & seq);
+
+	const LenCutOffs & mateCutOffs(const std::string & primerName) const;
+};
+
+}  // namespace bibseq
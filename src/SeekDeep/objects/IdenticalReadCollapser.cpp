@@ -0,0 +1,219 @@
+/*
+ * IdenticalReadCollapser.cpp
+ *
+ *  Created on: Mar 22, 2017
+ *      Author: nick
+ */
+
+#include "IdenticalReadCollapser.hpp"
+
+namespace bibseq {
+
+namespace {
+
+//groups smaller than this get their qualities from sorting each position's qualities rather than from a histogram, clearing and
+//scanning the histogram's bins costs more than the sort for only a few reads
+const uint32_t minHistogramGroupSize = 16;
+
+void setGroupQualities(const ReadArena & reads,
+		const std::vector<uint32_t> & group, const std::string & qualRep,
+		QualityHistogram & hist, std::vector<uint32_t> & posQuals,
+		std::vector<uint32_t> & readQual, std::vector<uint32_t> & quals) {
+	if (1 == group.size()) {
+		reads.getQual(group.front(), quals);
+		return;
+	}
+	//the arena holds a quality for every base so identical reads always have the same quality length
+	const uint32_t qualLen = reads.getSeqLen(group.front());
+	if (group.size() >= minHistogramGroupSize) {
+		hist.reset(qualLen);
+		for (const auto readPos : group) {
+			reads.getQual(readPos, readQual);
+			hist.add(readQual);
+		}
+		hist.setQualities(qualRep, quals);
+		return;
+	}
+	quals.resize(qualLen);
+	for (uint32_t pos = 0; pos < qualLen; ++pos) {
+		posQuals.clear();
+		for (const auto readPos : group) {
+			posQuals.emplace_back(reads.getBaseQual(readPos, pos));
+		}
+		std::sort(posQuals.begin(), posQuals.end());
+		if ("median" == qualRep) {
+			uint32_t mid = posQuals.size() / 2;
+			quals[pos] = 0 == posQuals.size() % 2 ?
+					(posQuals[mid - 1] + posQuals[mid]) / 2 : posQuals[mid];
+		} else if ("average" == qualRep) {
+			uint64_t sum = std::accumulate(posQuals.begin(), posQuals.end(),
+					static_cast<uint64_t>(0));
+			quals[pos] = sum / posQuals.size();
+		} else if ("worst" == qualRep) {
+			quals[pos] = posQuals.front();
+		} else {
+			quals[pos] = posQuals.back();
+		}
+	}
+}
+
+}  // namespace
+
+IdenticalReadCollapser::IdenticalReadCollapser(uint32_t numThreads) :
+		numThreads_(std::max<uint32_t>(1, numThreads)) {
+}
+
+void IdenticalReadCollapser::runOnThreads(
+		const std::function<void(uint32_t)> & func) const {
+	if (1 == numThreads_) {
+		func(0);
+		return;
+	}
+	std::vector<std::exception_ptr> exceptions(numThreads_);
+	std::vector<std::thread> threads;
+	for (uint32_t t = 0; t < numThreads_; ++t) {
+		threads.emplace_back([&func, &exceptions, t]() {
+			try {
+				func(t);
+			} catch (...) {
+				exceptions[t] = std::current_exception();
+			}
+		});
+	}
+	for (auto & t : threads) {
+		t.join();
+	}
+	for (const auto & e : exceptions) {
+		if (nullptr != e) {
+			std::rethrow_exception(e);
+		}
+	}
+}
+
+std::vector<std::vector<uint32_t>> IdenticalReadCollapser::groupIdenticalReads(
+		const ReadArena & reads) const {
+	const uint32_t numReads = reads.size();
+	//hash every sequence, a contiguous chunk of reads per thread
+	std::vector<uint64_t> hashes(numReads);
+	//not std::vector<bool> so the threads can set their own reads
+	std::vector<uint8_t> packable(numReads, 0);
+	uint32_t chunkSize = (numReads + numThreads_ - 1) / numThreads_;
+	runOnThreads([&](uint32_t threadNum) {
+		PackedSeq packed;
+		std::hash<std::string> strHasher;
+		std::string seq;
+		uint32_t start = std::min(numReads, threadNum * chunkSize);
+		uint32_t stop = std::min(numReads, start + chunkSize);
+		for (uint32_t readPos = start; readPos < stop; ++readPos) {
+			reads.getSeq(readPos, seq);
+			if (PackedSeq::canPackExactly(seq)) {
+				packed.assign(seq);
+				hashes[readPos] = packed.hash();
+				packable[readPos] = 1;
+			} else {
+				hashes[readPos] = strHasher(seq);
+			}
+		}
+	});
+	//each thread groups the reads whose hash falls in its shard, going through them in input order
+	std::vector<std::vector<std::vector<uint32_t>>> shardGroups(numThreads_);
+	runOnThreads([&](uint32_t threadNum) {
+		std::unordered_map<PackedSeq, uint32_t, PackedSeq::Hash> packedGroups;
+		std::unordered_map<std::string, uint32_t> strGroups;
+		auto & groups = shardGroups[threadNum];
+		PackedSeq packed;
+		std::string seq;
+		for (uint32_t readPos = 0; readPos < numReads; ++readPos) {
+			if (hashes[readPos] % numThreads_ != threadNum) {
+				continue;
+			}
+			reads.getSeq(readPos, seq);
+			uint32_t groupPos = groups.size();
+			bool added = false;
+			if (packable[readPos]) {
+				packed.assign(seq);
+				auto emplaced = packedGroups.emplace(packed, groupPos);
+				added = emplaced.second;
+				groupPos = emplaced.first->second;
+			} else {
+				auto search = strGroups.find(seq);
+				if (strGroups.end() == search) {
+					strGroups.emplace(seq, groupPos);
+					added = true;
+				} else {
+					groupPos = search->second;
+				}
+			}
+			if (added) {
+				groups.emplace_back();
+			}
+			groups[groupPos].emplace_back(readPos);
+		}
+	});
+	std::vector<std::vector<uint32_t>> ret;
+	for (auto & groups : shardGroups) {
+		for (auto & group : groups) {
+			ret.emplace_back(std::move(group));
+		}
+	}
+	std::sort(ret.begin(), ret.end(),
+			[](const std::vector<uint32_t> & group1, const std::vector<uint32_t> & group2) {
+				return group1.front() < group2.front();
+			});
+	return ret;
+}
+
+std::vector<IdenticalReadCollapser::UniqueSeq> IdenticalReadCollapser::collapseToUniqueSeqs(
+		const ReadArena & reads, const std::string & qualRep) const {
+	auto groups = groupIdenticalReads(reads);
+	std::vector<UniqueSeq> ret(groups.size());
+	std::atomic<uint32_t> nextGroup { 0 };
+	if (!QualityHistogram::handlesQualRep(qualRep)) {
+		runOnThreads([&](uint32_t threadNum) {
+			std::vector<readObject> groupReads;
+			for (uint32_t groupPos = nextGroup++; groupPos < groups.size(); groupPos = nextGroup++) {
+				auto & group = groups[groupPos];
+				groupReads.clear();
+				for (const auto readPos : group) {
+					groupReads.emplace_back(readObject(reads.getSeqInfo(readPos)));
+				}
+				auto clusters = clusterCollapser::collapseIdenticalReads(groupReads,
+						qualRep);
+				if (1 != clusters.size()) {
+					std::stringstream ss;
+					ss << __PRETTY_FUNCTION__ << ", error: reads with the same sequence as "
+							<< groupReads.front().seqBase_.name_ << " collapsed into "
+							<< clusters.size() << " clusters rather than one" << "\n";
+					throw std::runtime_error { ss.str() };
+				}
+				ret[groupPos].seqBase_ = clusters.front().seqBase_;
+				ret[groupPos].readPositions_ = std::move(group);
+			}
+		});
+		return ret;
+	}
+	runOnThreads([&](uint32_t threadNum) {
+		QualityHistogram hist;
+		std::vector<uint32_t> posQuals;
+		std::vector<uint32_t> readQual;
+		for (uint32_t groupPos = nextGroup++; groupPos < groups.size(); groupPos = nextGroup++) {
+			auto & group = groups[groupPos];
+			auto & uniqueSeq = ret[groupPos];
+			const auto & firstRead = reads.getEntry(group.front());
+			uniqueSeq.seqBase_.name_ = reads.getName(group.front());
+			reads.getSeq(group.front(), uniqueSeq.seqBase_.seq_);
+			uniqueSeq.seqBase_.frac_ = firstRead.frac_;
+			uniqueSeq.seqBase_.on_ = true;
+			uniqueSeq.seqBase_.cnt_ = 0;
+			for (const auto readPos : group) {
+				uniqueSeq.seqBase_.cnt_ += reads.getCnt(readPos);
+			}
+			setGroupQualities(reads, group, qualRep, hist, posQuals, readQual,
+					uniqueSeq.seqBase_.qual_);
+			uniqueSeq.readPositions_ = std::move(group);
+		}
+	});
+	return ret;
+}
+
+}  // namespace bibseq
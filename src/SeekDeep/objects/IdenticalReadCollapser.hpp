@@ -0,0 +1,68 @@
+#pragma once
+
+/*
+ * IdenticalReadCollapser.hpp
+ *
+ *  Created on: Mar 22, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+#include "SeekDeep/objects/PackedSeq.hpp"
+#include "SeekDeep/objects/QualityHistogram.hpp"
+#include "SeekDeep/objects/ReadArena.hpp"
+
+namespace bibseq {
+
+/**@brief Collapse identical reads by hashing their sequences on several threads rather than comparing sequences one at a time
+ *
+ * The reads are read from a ReadArena and only referred to by their positions in it, each thread owns the hash table for a share
+ * of the hashes so the grouping needs no locking, sequences of only A,C,G,T,N are keyed on their PackedSeq and anything else on the
+ * sequence itself, the clusters and their qualities are the same as collapsing all the reads at once with
+ * clusterCollapser::collapseIdenticalReads() and come out in the order of their first read same as well
+ *
+ */
+class IdenticalReadCollapser {
+public:
+	IdenticalReadCollapser(uint32_t numThreads);
+
+	uint32_t numThreads_;
+
+	/**@brief A unique sequence and the positions of its reads in the arena
+	 *
+	 */
+	struct UniqueSeq {
+		seqInfo seqBase_;
+		std::vector<uint32_t> readPositions_;
+	};
+
+	/**@brief Group reads with identical sequences
+	 *
+	 * @param reads the reads to group
+	 * @return the positions in reads of each group, groups are ordered by their first read and positions are in arena order
+	 */
+	std::vector<std::vector<uint32_t>> groupIdenticalReads(
+			const ReadArena & reads) const;
+
+	/**@brief Collapse identical reads into one seqInfo per unique sequence
+	 *
+	 * For median, average, worst or bestQual (see QualityHistogram::handlesQualRep()) the qualities are streamed into a
+	 * QualityHistogram per thread so a unique sequence's quality takes the same memory no matter how many reads it has, each seqInfo
+	 * is named after its first read and has the summed count of its reads, any other qualRep copies the reads of one group at a time
+	 * out of the arena for clusterCollapser::collapseIdenticalReads()
+	 *
+	 * @param reads the reads to collapse
+	 * @param qualRep how to get the unique sequence's quality from the reads', same as for clusterCollapser::collapseIdenticalReads()
+	 * @return the unique sequences in the order of their first read
+	 */
+	std::vector<UniqueSeq> collapseToUniqueSeqs(const ReadArena & reads,
+			const std::string & qualRep) const;
+
+private:
+	/**@brief run func(threadNum) on numThreads_ threads, re-throwing the first exception thrown
+	 *
+	 */
+	void runOnThreads(const std::function<void(uint32_t)> & func) const;
+};
+
+}  // namespace bibseq
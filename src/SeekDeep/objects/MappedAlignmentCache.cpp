@@ -0,0 +1,469 @@
+/*
+ * MappedAlignmentCache.cpp
+ *
+ *  Created on: Mar 23, 2017
+ *      Author: nick
+ */
+
+#include "MappedAlignmentCache.hpp"
+#include <cerrno>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace bibseq {
+
+namespace {
+
+const char logMagic[8] = { 'S', 'D', 'A', 'L', 'N', 'L', 'O', 'G' };
+const char idxMagic[8] = { 'S', 'D', 'A', 'L', 'N', 'I', 'D', 'X' };
+const uint64_t logHeaderSize = sizeof(logMagic);
+const uint64_t initialCapacity = 1024;
+const uint32_t recordCheckSeed = 0x5eed5eed;
+
+uint64_t mixHash(uint64_t h) {
+	h ^= h >> 30;
+	h *= 0xbf58476d1ce4e5b9ULL;
+	h ^= h >> 27;
+	h *= 0x94d049bb133111ebULL;
+	h ^= h >> 31;
+	return h;
+}
+
+//FNV-1a, fixed so keys are the same on every build and platform
+uint64_t hashBytes(const std::string & data, uint64_t seed) {
+	uint64_t h = 0xcbf29ce484222325ULL ^ mixHash(seed);
+	for (const auto c : data) {
+		h ^= static_cast<uint8_t>(c);
+		h *= 0x100000001b3ULL;
+	}
+	return mixHash(h ^ data.size());
+}
+
+//holds an exclusive flock on fd while in scope
+class FileLock {
+public:
+	FileLock(int fd) :
+			fd_(fd) {
+		while (0 != flock(fd_, LOCK_EX)) {
+			if (EINTR != errno) {
+				std::stringstream ss;
+				ss << __PRETTY_FUNCTION__ << ", error: couldn't lock alignment cache, "
+						<< std::strerror(errno) << "\n";
+				throw std::runtime_error { ss.str() };
+			}
+		}
+	}
+	~FileLock() {
+		flock(fd_, LOCK_UN);
+	}
+private:
+	int fd_;
+};
+
+}  // namespace
+
+MappedAlignmentCache::Alignment MappedAlignmentCache::Alignment::fromAlnInfo(
+		const alnInfoGlobal & info) {
+	Alignment ret;
+	ret.score_ = info.score_;
+	for (const auto & gap : info.gapInfos_) {
+		Gap cachedGap;
+		cachedGap.pos_ = gap.pos_;
+		cachedGap.size_ = gap.size_;
+		cachedGap.gapInA_ = gap.gapInA_;
+		ret.gaps_.emplace_back(cachedGap);
+	}
+	return ret;
+}
+
+alnInfoGlobal MappedAlignmentCache::Alignment::toAlnInfo() const {
+	std::vector<gapInfo> gapInfos;
+	for (const auto & gap : gaps_) {
+		gapInfos.emplace_back(gapInfo(gap.pos_, gap.size_, 0 != gap.gapInA_));
+	}
+	return alnInfoGlobal(gapInfos, score_, false);
+}
+
+MappedAlignmentCache::MappedAlignmentCache(const bfs::path & fnp) :
+		fnp_(fnp), idxFnp_(fnp.string() + ".idx") {
+	logFd_ = open(fnp_.c_str(), O_RDWR | O_CREAT, 0644);
+	if (logFd_ < 0) {
+		throwSysError(__PRETTY_FUNCTION__, "couldn't open " + fnp_.string());
+	}
+	FileLock lock(logFd_);
+	struct stat logStat;
+	if (0 != fstat(logFd_, &logStat)) {
+		throwSysError(__PRETTY_FUNCTION__, "couldn't stat " + fnp_.string());
+	}
+	if (0 == logStat.st_size) {
+		if (logHeaderSize != static_cast<uint64_t>(pwrite(logFd_, logMagic, logHeaderSize, 0))) {
+			throwSysError(__PRETTY_FUNCTION__, "couldn't write " + fnp_.string());
+		}
+	} else {
+		char magic[logHeaderSize];
+		if (logHeaderSize != static_cast<uint64_t>(pread(logFd_, magic, logHeaderSize, 0))
+				|| 0 != std::memcmp(magic, logMagic, logHeaderSize)) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error: " << fnp_
+					<< " isn't an alignment cache" << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+	}
+	mapIndex();
+	if (nullptr == idxMap_) {
+		rebuildIndex(initialCapacity);
+	}
+	indexLogTail();
+}
+
+MappedAlignmentCache::~MappedAlignmentCache() {
+	unmapIndex();
+	if (nullptr != logMap_) {
+		munmap(logMap_, logMapSize_);
+	}
+	if (logFd_ >= 0) {
+		close(logFd_);
+	}
+}
+
+void MappedAlignmentCache::throwSysError(const std::string & funcName,
+		const std::string & what) const {
+	std::stringstream ss;
+	ss << funcName << ", error: " << what << ", " << std::strerror(errno) << "\n";
+	throw std::runtime_error { ss.str() };
+}
+
+MappedAlignmentCache::IndexHeader * MappedAlignmentCache::header() {
+	return reinterpret_cast<IndexHeader *>(idxMap_);
+}
+
+MappedAlignmentCache::Slot * MappedAlignmentCache::slots() {
+	return reinterpret_cast<Slot *>(idxMap_ + sizeof(IndexHeader));
+}
+
+void MappedAlignmentCache::mapLog() {
+	struct stat logStat;
+	if (0 != fstat(logFd_, &logStat)) {
+		throwSysError(__PRETTY_FUNCTION__, "couldn't stat " + fnp_.string());
+	}
+	uint64_t logSize = logStat.st_size;
+	if (logSize == logMapSize_) {
+		return;
+	}
+	if (nullptr != logMap_) {
+		munmap(logMap_, logMapSize_);
+		logMap_ = nullptr;
+		logMapSize_ = 0;
+	}
+	void * map = mmap(nullptr, logSize, PROT_READ, MAP_SHARED, logFd_, 0);
+	if (MAP_FAILED == map) {
+		throwSysError(__PRETTY_FUNCTION__, "couldn't map " + fnp_.string());
+	}
+	logMap_ = static_cast<char *>(map);
+	logMapSize_ = logSize;
+}
+
+void MappedAlignmentCache::mapIndex() {
+	idxFd_ = open(idxFnp_.c_str(), O_RDWR);
+	if (idxFd_ < 0) {
+		return;
+	}
+	struct stat idxStat;
+	if (0 != fstat(idxFd_, &idxStat)
+			|| static_cast<uint64_t>(idxStat.st_size) < sizeof(IndexHeader)) {
+		unmapIndex();
+		return;
+	}
+	void * map = mmap(nullptr, idxStat.st_size, PROT_READ | PROT_WRITE,
+			MAP_SHARED, idxFd_, 0);
+	if (MAP_FAILED == map) {
+		unmapIndex();
+		return;
+	}
+	idxMap_ = static_cast<char *>(map);
+	idxMapSize_ = idxStat.st_size;
+	idxInode_ = idxStat.st_ino;
+	const auto capacity = header()->capacity_;
+	struct stat logStat;
+	if (0 != fstat(logFd_, &logStat)) {
+		throwSysError(__PRETTY_FUNCTION__, "couldn't stat " + fnp_.string());
+	}
+	//a table that isn't right is rebuilt from the log, including one covering more log than there is, which happens when the
+	//log was truncated or replaced without removing the table
+	if (0 != std::memcmp(header()->magic_, idxMagic, sizeof(idxMagic))
+			|| 0 == capacity || 0 != (capacity & (capacity - 1))
+			|| idxMapSize_ != sizeof(IndexHeader) + capacity * sizeof(Slot)
+			|| header()->logCovered_ < logHeaderSize
+			|| header()->logCovered_ > static_cast<uint64_t>(logStat.st_size)) {
+		unmapIndex();
+	}
+}
+
+void MappedAlignmentCache::unmapIndex() {
+	if (nullptr != idxMap_) {
+		munmap(idxMap_, idxMapSize_);
+		idxMap_ = nullptr;
+		idxMapSize_ = 0;
+	}
+	if (idxFd_ >= 0) {
+		close(idxFd_);
+		idxFd_ = -1;
+	}
+}
+
+void MappedAlignmentCache::rebuildIndex(uint64_t capacity) {
+	std::string tempFnp = idxFnp_ + ".tmp." + estd::to_string(getpid());
+	int tempFd = open(tempFnp.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (tempFd < 0) {
+		throwSysError(__PRETTY_FUNCTION__, "couldn't open " + tempFnp);
+	}
+	uint64_t tempSize = sizeof(IndexHeader) + capacity * sizeof(Slot);
+	if (0 != ftruncate(tempFd, tempSize)) {
+		close(tempFd);
+		throwSysError(__PRETTY_FUNCTION__, "couldn't size " + tempFnp);
+	}
+	void * map = mmap(nullptr, tempSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+			tempFd, 0);
+	if (MAP_FAILED == map) {
+		close(tempFd);
+		throwSysError(__PRETTY_FUNCTION__, "couldn't map " + tempFnp);
+	}
+	auto tempHeader = static_cast<IndexHeader *>(map);
+	auto tempSlots = reinterpret_cast<Slot *>(static_cast<char *>(map) + sizeof(IndexHeader));
+	std::memcpy(tempHeader->magic_, idxMagic, sizeof(idxMagic));
+	tempHeader->capacity_ = capacity;
+	tempHeader->count_ = 0;
+	tempHeader->logCovered_ = logHeaderSize;
+	if (nullptr != idxMap_) {
+		tempHeader->logCovered_ = header()->logCovered_;
+		for (uint64_t slotPos = 0; slotPos < header()->capacity_; ++slotPos) {
+			const auto & slot = slots()[slotPos];
+			if (0 == slot.offset_) {
+				continue;
+			}
+			uint64_t tempPos = slot.hash_ & (capacity - 1);
+			while (0 != tempSlots[tempPos].offset_) {
+				tempPos = (tempPos + 1) & (capacity - 1);
+			}
+			tempSlots[tempPos] = slot;
+			++tempHeader->count_;
+		}
+	}
+	if (0 != rename(tempFnp.c_str(), idxFnp_.c_str())) {
+		munmap(map, tempSize);
+		close(tempFd);
+		throwSysError(__PRETTY_FUNCTION__, "couldn't move " + tempFnp + " to " + idxFnp_);
+	}
+	unmapIndex();
+	struct stat idxStat;
+	if (0 != fstat(tempFd, &idxStat)) {
+		throwSysError(__PRETTY_FUNCTION__, "couldn't stat " + idxFnp_);
+	}
+	idxFd_ = tempFd;
+	idxMap_ = static_cast<char *>(map);
+	idxMapSize_ = tempSize;
+	idxInode_ = idxStat.st_ino;
+}
+
+bool MappedAlignmentCache::recordComplete(uint64_t offset, uint64_t logSize,
+		uint64_t & recordSize) {
+	if (offset + sizeof(RecordHeader) > logSize) {
+		return false;
+	}
+	RecordHeader record;
+	std::memcpy(&record, logMap_ + offset, sizeof(RecordHeader));
+	if (record.recordCheck_
+			!= (record.gapCount_ ^ static_cast<uint32_t>(record.hash_) ^ recordCheckSeed)) {
+		return false;
+	}
+	recordSize = sizeof(RecordHeader) + static_cast<uint64_t>(record.gapCount_) * sizeof(Gap);
+	return offset + recordSize <= logSize;
+}
+
+void MappedAlignmentCache::indexLogTail() {
+	mapLog();
+	uint64_t offset = header()->logCovered_;
+	uint64_t recordSize = 0;
+	while (offset < logMapSize_) {
+		if (!recordComplete(offset, logMapSize_, recordSize)) {
+			//a record cut off when a run stopped while adding, drop it so the next one is appended where it started
+			if (0 != ftruncate(logFd_, offset)) {
+				throwSysError(__PRETTY_FUNCTION__, "couldn't truncate " + fnp_.string());
+			}
+			mapLog();
+			break;
+		}
+		RecordHeader record;
+		std::memcpy(&record, logMap_ + offset, sizeof(RecordHeader));
+		Key key;
+		key.hash_ = record.hash_;
+		key.check_ = record.check_;
+		if (nullptr == findSlot(key)) {
+			Slot slot;
+			slot.hash_ = record.hash_;
+			slot.check_ = record.check_;
+			slot.offset_ = offset;
+			insertSlot(slot);
+		}
+		offset += recordSize;
+	}
+	header()->logCovered_ = offset;
+}
+
+void MappedAlignmentCache::insertSlot(const Slot & slot) {
+	if ((header()->count_ + 1) * 2 > header()->capacity_) {
+		rebuildIndex(header()->capacity_ * 2);
+	}
+	const uint64_t capacity = header()->capacity_;
+	uint64_t slotPos = slot.hash_ & (capacity - 1);
+	while (0 != slots()[slotPos].offset_) {
+		slotPos = (slotPos + 1) & (capacity - 1);
+	}
+	auto & emptySlot = slots()[slotPos];
+	emptySlot.hash_ = slot.hash_;
+	emptySlot.check_ = slot.check_;
+	//offset last, a slot is only used once it's set
+	emptySlot.offset_ = slot.offset_;
+	++header()->count_;
+}
+
+const MappedAlignmentCache::Slot * MappedAlignmentCache::findSlot(
+		const Key & key) {
+	const uint64_t capacity = header()->capacity_;
+	uint64_t slotPos = key.hash_ & (capacity - 1);
+	while (0 != slots()[slotPos].offset_) {
+		const auto & slot = slots()[slotPos];
+		if (slot.hash_ == key.hash_ && slot.check_ == key.check_) {
+			return &slot;
+		}
+		slotPos = (slotPos + 1) & (capacity - 1);
+	}
+	return nullptr;
+}
+
+uint64_t MappedAlignmentCache::scoringKey(const aligner & alignerObj) {
+	std::stringstream ss;
+	ss << alignerObj.parts_.gapScores_.toJson();
+	for (const auto & row : iter::range(len(alignerObj.parts_.scoring_.mat_))) {
+		for (const auto & col : iter::range(len(alignerObj.parts_.scoring_.mat_[row]))) {
+			ss << alignerObj.parts_.scoring_.mat_[row][col] << ",";
+		}
+	}
+	return hashBytes(ss.str(), 0);
+}
+
+MappedAlignmentCache::Key MappedAlignmentCache::genKey(uint64_t scoringKey,
+		const std::string & refSeq, const std::string & readSeq) {
+	Key ret;
+	ret.hash_ = hashBytes(readSeq, hashBytes(refSeq, scoringKey));
+	ret.check_ = hashBytes(readSeq,
+			hashBytes(refSeq, scoringKey ^ 0x9e3779b97f4a7c15ULL) ^ 0x9e3779b97f4a7c15ULL);
+	return ret;
+}
+
+bool MappedAlignmentCache::readRecord(uint64_t offset, const Key & key,
+		Alignment & aln) {
+	uint64_t recordSize = 0;
+	if (!recordComplete(offset, logMapSize_, recordSize)) {
+		return false;
+	}
+	RecordHeader record;
+	std::memcpy(&record, logMap_ + offset, sizeof(RecordHeader));
+	if (record.hash_ != key.hash_ || record.check_ != key.check_) {
+		return false;
+	}
+	aln.score_ = record.score_;
+	aln.gaps_.resize(record.gapCount_);
+	if (record.gapCount_ > 0) {
+		std::memcpy(aln.gaps_.data(), logMap_ + offset + sizeof(RecordHeader),
+				static_cast<uint64_t>(record.gapCount_) * sizeof(Gap));
+	}
+	return true;
+}
+
+bool MappedAlignmentCache::get(const Key & key, Alignment & aln) {
+	uint64_t offset = 0;
+	{
+		std::shared_lock<std::shared_timed_mutex> lock(mut_);
+		auto slot = findSlot(key);
+		if (nullptr == slot) {
+			++stats_.misses_;
+			return false;
+		}
+		offset = slot->offset_;
+		if (offset < logMapSize_ && readRecord(offset, key, aln)) {
+			++stats_.hits_;
+			return true;
+		}
+	}
+	//the record was added after the log was last mapped
+	std::unique_lock<std::shared_timed_mutex> lock(mut_);
+	mapLog();
+	if (readRecord(offset, key, aln)) {
+		++stats_.hits_;
+		return true;
+	}
+	++stats_.misses_;
+	return false;
+}
+
+void MappedAlignmentCache::add(const Key & key, const Alignment & aln) {
+	std::unique_lock<std::shared_timed_mutex> lock(mut_);
+	FileLock fileLock(logFd_);
+	//another process may have grown the table into a new file
+	struct stat idxStat;
+	if (0 == stat(idxFnp_.c_str(), &idxStat)
+			&& static_cast<uint64_t>(idxStat.st_ino) != idxInode_) {
+		unmapIndex();
+		mapIndex();
+		if (nullptr == idxMap_) {
+			rebuildIndex(initialCapacity);
+		}
+	}
+	indexLogTail();
+	if (nullptr != findSlot(key)) {
+		return;
+	}
+	RecordHeader record;
+	std::memset(&record, 0, sizeof(RecordHeader));
+	record.hash_ = key.hash_;
+	record.check_ = key.check_;
+	record.score_ = aln.score_;
+	record.gapCount_ = aln.gaps_.size();
+	record.recordCheck_ = record.gapCount_ ^ static_cast<uint32_t>(record.hash_) ^ recordCheckSeed;
+	std::string buffer(reinterpret_cast<const char *>(&record), sizeof(RecordHeader));
+	if (!aln.gaps_.empty()) {
+		buffer.append(reinterpret_cast<const char *>(aln.gaps_.data()),
+				aln.gaps_.size() * sizeof(Gap));
+	}
+	uint64_t offset = header()->logCovered_;
+	uint64_t written = 0;
+	while (written < buffer.size()) {
+		auto ret = pwrite(logFd_, buffer.data() + written, buffer.size() - written,
+				offset + written);
+		if (ret < 0) {
+			if (EINTR == errno) {
+				continue;
+			}
+			throwSysError(__PRETTY_FUNCTION__, "couldn't write " + fnp_.string());
+		}
+		written += ret;
+	}
+	Slot slot;
+	slot.hash_ = key.hash_;
+	slot.check_ = key.check_;
+	slot.offset_ = offset;
+	insertSlot(slot);
+	header()->logCovered_ = offset + buffer.size();
+	++stats_.added_;
+}
+
+uint64_t MappedAlignmentCache::size() {
+	std::shared_lock<std::shared_timed_mutex> lock(mut_);
+	return header()->count_;
+}
+
+}  // namespace bibseq
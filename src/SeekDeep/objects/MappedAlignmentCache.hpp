@@ -0,0 +1,153 @@
+#pragma once
+
+/*
+ * MappedAlignmentCache.hpp
+ *
+ *  Created on: Mar 23, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+#include <shared_mutex>
+
+namespace bibseq {
+
+/**@brief A persistent cache of global alignments keyed on a hash of the two sequences and the aligner's scoring, kept in an
+ * append-only log of alignments with a memory mapped open addressing hash table of where each alignment is in the log
+ *
+ * Opening the cache only maps the two files, nothing is parsed unless the table has to be rebuilt (it's missing, or the log has
+ * alignments past what the table covers because a run stopped while adding), lookups are a probe of the mapped table, adding
+ * takes an exclusive flock on the log so several processes can share a cache, threads can look up and add at the same time
+ *
+ * The table is in fnp + ".idx", when the table is grown it's replaced by a new file so other processes already open keep seeing
+ * the old table until they re-open
+ *
+ */
+class MappedAlignmentCache {
+public:
+	struct Gap {
+		uint32_t pos_ = 0;
+		uint32_t size_ = 0;
+		uint32_t gapInA_ = 0;
+	};
+	struct Alignment {
+		double score_ = 0;
+		std::vector<Gap> gaps_;
+
+		static Alignment fromAlnInfo(const alnInfoGlobal & info);
+		alnInfoGlobal toAlnInfo() const;
+	};
+	struct Key {
+		uint64_t hash_ = 0;
+		//a second independent hash so a collision of hash_ doesn't return the wrong alignment
+		uint64_t check_ = 0;
+	};
+	struct Stats {
+		std::atomic<uint64_t> hits_ { 0 };
+		std::atomic<uint64_t> misses_ { 0 };
+		std::atomic<uint64_t> added_ { 0 };
+	};
+
+	/**@brief open the cache at fnp, creating it if it doesn't exist
+	 *
+	 * @param fnp the log file, the table is fnp + ".idx"
+	 */
+	MappedAlignmentCache(const bfs::path & fnp);
+	~MappedAlignmentCache();
+
+	MappedAlignmentCache(const MappedAlignmentCache & other) = delete;
+	MappedAlignmentCache & operator=(const MappedAlignmentCache & other) = delete;
+
+	const bfs::path fnp_;
+	Stats stats_;
+
+	/**@brief a hash of what determines the alignment other than the sequences, the gap scores and the scoring matrix
+	 *
+	 */
+	static uint64_t scoringKey(const aligner & alignerObj);
+
+	static Key genKey(uint64_t scoringKey, const std::string & refSeq,
+			const std::string & readSeq);
+
+	/**@brief look up an alignment
+	 *
+	 * @param key the key from genKey()
+	 * @param aln set to the alignment if found
+	 * @return whether it was found
+	 */
+	bool get(const Key & key, Alignment & aln);
+
+	/**@brief add an alignment, nothing is done if it's already in the cache
+	 *
+	 */
+	void add(const Key & key, const Alignment & aln);
+
+	/**@brief the number of alignments in the cache
+	 *
+	 */
+	uint64_t size();
+
+private:
+	struct IndexHeader {
+		char magic_[8];
+		uint64_t capacity_;
+		uint64_t count_;
+		//the log has been indexed up to here
+		uint64_t logCovered_;
+	};
+	struct Slot {
+		uint64_t hash_;
+		uint64_t check_;
+		//0 for an empty slot, the log header means no record starts at 0
+		uint64_t offset_;
+	};
+	struct RecordHeader {
+		uint64_t hash_;
+		uint64_t check_;
+		double score_;
+		uint32_t gapCount_;
+		//gapCount_ ^ the low bits of hash_, to catch a record cut off part way through
+		uint32_t recordCheck_;
+	};
+
+	const std::string idxFnp_;
+	int logFd_ = -1;
+	int idxFd_ = -1;
+	char * logMap_ = nullptr;
+	uint64_t logMapSize_ = 0;
+	char * idxMap_ = nullptr;
+	uint64_t idxMapSize_ = 0;
+	uint64_t idxInode_ = 0;
+
+	std::shared_timed_mutex mut_;
+
+	IndexHeader * header();
+	Slot * slots();
+
+	void mapLog();
+	void mapIndex();
+	void unmapIndex();
+	/**@brief create a new table of capacity slots holding the current entries (if any) and put it in place of the current one
+	 *
+	 */
+	void rebuildIndex(uint64_t capacity);
+	/**@brief index the log records from the table's logCovered_ on, truncating a record cut off part way through
+	 *
+	 */
+	void indexLogTail();
+	void insertSlot(const Slot & slot);
+	const Slot * findSlot(const Key & key);
+
+	/**@brief whether the record at offset is complete within the first logSize bytes of the log, sets its size
+	 *
+	 */
+	bool recordComplete(uint64_t offset, uint64_t logSize, uint64_t & recordSize);
+	/**@brief read the record at offset into aln if it's complete within the mapped log and has key
+	 *
+	 */
+	bool readRecord(uint64_t offset, const Key & key, Alignment & aln);
+
+	void throwSysError(const std::string & funcName, const std::string & what) const;
+};
+
+}  // namespace bibseq
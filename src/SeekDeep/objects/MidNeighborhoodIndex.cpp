@@ -0,0 +1,217 @@
+/*
+ * MidNeighborhoodIndex.cpp
+ *
+ *  Created on: Mar 6, 2017
+ *      Author: nick
+ */
+
+#include "MidNeighborhoodIndex.hpp"
+
+namespace bibseq {
+
+const uint32_t MidNeighborhoodIndex::ambiguousMid_ = std::numeric_limits<uint32_t>::max();
+const uint32_t MidNeighborhoodIndex::maxAllowableErrors_;
+
+void MidNeighborhoodIndex::Stats::increase(lookUpStatus status) {
+	switch (status) {
+	case lookUpStatus::UNIQUE:
+		++unique_;
+		break;
+	case lookUpStatus::AMBIGUOUS:
+		++ambiguous_;
+		break;
+	case lookUpStatus::MISS:
+		++miss_;
+		break;
+	}
+}
+
+void MidNeighborhoodIndex::Stats::addOtherStats(const Stats & other) {
+	unique_ += other.unique_;
+	uniqueFailed_ += other.uniqueFailed_;
+	ambiguous_ += other.ambiguous_;
+	miss_ += other.miss_;
+}
+
+bool MidNeighborhoodIndex::encode(const std::string & seq, uint32_t len,
+		uint64_t & key) {
+	if (seq.size() < len) {
+		return false;
+	}
+	key = 0;
+	for (uint32_t pos = 0; pos < len; ++pos) {
+		auto code = PackedSeq::baseCode(seq[pos]);
+		if (code > 3) {
+			return false;
+		}
+		key = (key << 2) | code;
+	}
+	return true;
+}
+
+MidNeighborhoodIndex::MidNeighborhoodIndex(
+		const std::vector<std::pair<std::string, std::string>> & midBarcodes,
+		uint32_t allowableErrors, bool oneBaseIndel) :
+		allowableErrors_(allowableErrors), oneBaseIndel_(oneBaseIndel) {
+	if (allowableErrors_ > maxAllowableErrors_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: can only index up to "
+				<< maxAllowableErrors_ << " errors, not " << allowableErrors_ << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	const std::string bases = "ACGT";
+	for (const auto & mid : midBarcodes) {
+		uint32_t midPos = midNames_.size();
+		midNames_.emplace_back(mid.first);
+		barcodes_.emplace_back(mid.second);
+		auto barcode = mid.second;
+		stringToUpper(barcode);
+		uint64_t key = 0;
+		if (barcode.size() > 32 || !encode(barcode, barcode.size(), key)) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error: can only index barcodes of 32 or less bases made of A,C,G,T, barcode for "
+					<< mid.first << " is " << mid.second << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		addVariant(barcode.size(), key, midPos);
+		addSubstitutionVariants(barcode, midPos, 0, allowableErrors_, key);
+		if (oneBaseIndel_ && allowableErrors_ > 0) {
+			for (uint32_t pos = 0; pos < barcode.size(); ++pos) {
+				for (const auto & base : bases) {
+					//deletion of the base at pos, the next base in the read fills in the end
+					std::string deletion = barcode.substr(0, pos)
+							+ barcode.substr(pos + 1) + base;
+					//insertion of a base before pos, pushing the last base out
+					std::string insertion = barcode.substr(0, pos) + base
+							+ barcode.substr(pos, barcode.size() - pos - 1);
+					uint64_t indelKey = 0;
+					encode(deletion, barcode.size(), indelKey);
+					addVariant(barcode.size(), indelKey, midPos);
+					encode(insertion, barcode.size(), indelKey);
+					addVariant(barcode.size(), indelKey, midPos);
+				}
+			}
+		}
+	}
+}
+
+void MidNeighborhoodIndex::addVariant(uint32_t len, uint64_t key,
+		uint32_t midPos) {
+	auto & lenIndex = index_[len];
+	auto search = lenIndex.find(key);
+	if (lenIndex.end() == search) {
+		lenIndex.emplace(key, midPos);
+	} else if (ambiguousMid_ == search->second) {
+		auto & owners = ambiguousOwners_[len][key];
+		if (!bib::in(midPos, owners)) {
+			owners.emplace_back(midPos);
+		}
+	} else if (midPos != search->second) {
+		ambiguousOwners_[len][key] = std::vector<uint32_t> { search->second, midPos };
+		search->second = ambiguousMid_;
+	}
+}
+
+void MidNeighborhoodIndex::addSubstitutionVariants(const std::string & barcode,
+		uint32_t midPos, uint32_t start, uint32_t errorsLeft, uint64_t key) {
+	if (0 == errorsLeft) {
+		return;
+	}
+	uint32_t len = barcode.size();
+	for (uint32_t pos = start; pos < len; ++pos) {
+		uint32_t shift = 2 * (len - 1 - pos);
+		uint64_t original = (key >> shift) & 3;
+		for (uint64_t code = 0; code < 4; ++code) {
+			if (code == original) {
+				continue;
+			}
+			uint64_t variantKey = (key & ~(static_cast<uint64_t>(3) << shift))
+					| (code << shift);
+			addVariant(len, variantKey, midPos);
+			addSubstitutionVariants(barcode, midPos, pos + 1, errorsLeft - 1,
+					variantKey);
+		}
+	}
+}
+
+std::pair<MidNeighborhoodIndex::lookUpStatus, uint32_t> MidNeighborhoodIndex::lookUp(
+		const std::string & seq) const {
+	uint32_t found = ambiguousMid_;
+	bool hit = false;
+	for (const auto & lenIndex : index_) {
+		uint64_t key = 0;
+		if (!encode(seq, lenIndex.first, key)) {
+			continue;
+		}
+		auto search = lenIndex.second.find(key);
+		if (lenIndex.second.end() == search) {
+			continue;
+		}
+		if (ambiguousMid_ == search->second || (hit && found != search->second)) {
+			return {lookUpStatus::AMBIGUOUS, ambiguousMid_};
+		}
+		hit = true;
+		found = search->second;
+	}
+	if (hit) {
+		return {lookUpStatus::UNIQUE, found};
+	}
+	return {lookUpStatus::MISS, ambiguousMid_};
+}
+
+uint64_t MidNeighborhoodIndex::numberOfVariants() const {
+	uint64_t ret = 0;
+	for (const auto & lenIndex : index_) {
+		ret += lenIndex.second.size();
+	}
+	return ret;
+}
+
+uint64_t MidNeighborhoodIndex::numberOfAmbiguousVariants() const {
+	uint64_t ret = 0;
+	for (const auto & lenOwners : ambiguousOwners_) {
+		ret += lenOwners.second.size();
+	}
+	return ret;
+}
+
+void MidNeighborhoodIndex::writeCollisionReport(std::ostream & out) const {
+	std::map<std::pair<uint32_t, uint32_t>, uint32_t> sharedCounts;
+	for (const auto & lenOwners : ambiguousOwners_) {
+		for (const auto & variant : lenOwners.second) {
+			for (uint32_t first = 0; first < variant.second.size(); ++first) {
+				for (uint32_t second = first + 1; second < variant.second.size();
+						++second) {
+					auto midPair = std::make_pair(
+							std::min(variant.second[first], variant.second[second]),
+							std::max(variant.second[first], variant.second[second]));
+					++sharedCounts[midPair];
+				}
+			}
+		}
+	}
+	out << "mid1\tbarcode1\tmid2\tbarcode2\tsharedVariants" << "\n";
+	for (const auto & shared : sharedCounts) {
+		out << midNames_[shared.first.first] << "\t"
+				<< barcodes_[shared.first.first] << "\t"
+				<< midNames_[shared.first.second] << "\t"
+				<< barcodes_[shared.first.second] << "\t" << shared.second << "\n";
+	}
+}
+
+void MidNeighborhoodIndex::writeStats(std::ostream & out,
+		const Stats & stats) const {
+	uint64_t total = stats.unique_ + stats.ambiguous_ + stats.miss_;
+	out << "allowableErrors\toneBaseIndel\tvariants\tambiguousVariants\treads\tunique\tuniqueFailed\tambiguous\tmiss" << "\n";
+	out << allowableErrors_
+			<< "\t" << (oneBaseIndel_ ? "true" : "false")
+			<< "\t" << numberOfVariants()
+			<< "\t" << numberOfAmbiguousVariants()
+			<< "\t" << total
+			<< "\t" << getPercentageString(stats.unique_, total)
+			<< "\t" << getPercentageString(stats.uniqueFailed_, total)
+			<< "\t" << getPercentageString(stats.ambiguous_, total)
+			<< "\t" << getPercentageString(stats.miss_, total) << "\n";
+}
+
+}  // namespace bibseq
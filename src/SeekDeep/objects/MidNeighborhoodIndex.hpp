@@ -0,0 +1,78 @@
+#pragma once
+
+/*
+ * MidNeighborhoodIndex.hpp
+ *
+ *  Created on: Mar 6, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+#include "SeekDeep/objects/PackedSeq.hpp"
+
+namespace bibseq {
+
+/**@brief An index of every sequence within a number of substitutions (and optionally one indel) of the barcodes
+ *
+ * Built once so that the barcode of most reads can be found with a single hash look up of the start of the read,
+ * variants that are within the allowed errors of more than one barcode are marked ambiguous and
+ * reads that hit them (or don't hit the index at all) should go through the full MidDeterminator
+ *
+ */
+class MidNeighborhoodIndex {
+public:
+	enum class lookUpStatus {
+		UNIQUE, AMBIGUOUS, MISS
+	};
+
+	struct Stats {
+		uint64_t unique_ = 0;
+		uint64_t uniqueFailed_ = 0;
+		uint64_t ambiguous_ = 0;
+		uint64_t miss_ = 0;
+
+		void increase(lookUpStatus status);
+		void addOtherStats(const Stats & other);
+	};
+
+	/**@brief Build the index
+	 *
+	 * @param midBarcodes pairs of mid names and their barcodes
+	 * @param allowableErrors the number of substitutions to allow
+	 * @param oneBaseIndel also index variants with a single one base insertion or deletion
+	 */
+	MidNeighborhoodIndex(
+			const std::vector<std::pair<std::string, std::string>> & midBarcodes,
+			uint32_t allowableErrors, bool oneBaseIndel);
+
+	VecStr midNames_;
+	VecStr barcodes_;
+	uint32_t allowableErrors_;
+	bool oneBaseIndel_;
+
+	static const uint32_t maxAllowableErrors_ = 3;
+
+	std::pair<lookUpStatus, uint32_t> lookUp(const std::string & seq) const;
+
+	uint64_t numberOfVariants() const;
+	uint64_t numberOfAmbiguousVariants() const;
+
+	void writeCollisionReport(std::ostream & out) const;
+	void writeStats(std::ostream & out, const Stats & stats) const;
+
+private:
+	static const uint32_t ambiguousMid_;
+
+	//keyed by barcode length, then by the 2bit packed sequence
+	std::map<uint32_t, std::unordered_map<uint64_t, uint32_t>> index_;
+	//the mids that share an ambiguous variant
+	std::map<uint32_t, std::unordered_map<uint64_t, std::vector<uint32_t>>> ambiguousOwners_;
+
+	void addVariant(uint32_t len, uint64_t key, uint32_t midPos);
+	void addSubstitutionVariants(const std::string & barcode, uint32_t midPos,
+			uint32_t start, uint32_t errorsLeft, uint64_t key);
+
+	static bool encode(const std::string & seq, uint32_t len, uint64_t & key);
+};
+
+}  // namespace bibseq
@@ -0,0 +1,142 @@
+/*
+ * MinSpanningTreeBuilder.cpp
+ *
+ *  Created on: Mar 23, 2017
+ *      Author: nick
+ */
+
+#include "MinSpanningTreeBuilder.hpp"
+
+namespace bibseq {
+
+MinSpanningTreeBuilder::MinSpanningTreeBuilder(uint32_t numThreads,
+		bool countEndGaps) :
+		numThreads_(std::max<uint32_t>(1, numThreads)), countEndGaps_(countEndGaps) {
+}
+
+uint64_t MinSpanningTreeBuilder::differences(const comparison & comp) {
+	uint64_t ret = static_cast<uint64_t>(std::round(
+			comp.hqMismatches_ + comp.lqMismatches_ + comp.lowKmerMismatches_));
+	for (const auto & g : comp.distances_.alignmentGaps_) {
+		ret += g.second.size_;
+	}
+	return ret;
+}
+
+comparisonGraph MinSpanningTreeBuilder::build(
+		const std::vector<cluster> & clusters, aligner & alignerObj) {
+	if (clusters.size() > std::numeric_limits<uint32_t>::max()) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: can't build a tree of more than "
+				<< std::numeric_limits<uint32_t>::max() << " clusters" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	comparisonGraph ret;
+	for (const auto & clus : clusters) {
+		ret.addNode(clus.seqBase_.name_, std::make_shared<seqInfo>(clus.seqBase_));
+	}
+	if (clusters.size() < 2) {
+		return ret;
+	}
+	concurrent::AlignerPool alnPool(alignerObj, numThreads_);
+	alnPool.initAligners();
+	std::vector<decltype(alnPool.popAligner())> threadAligners;
+	for (uint32_t t = 0; t < numThreads_; ++t) {
+		threadAligners.emplace_back(alnPool.popAligner());
+	}
+	std::vector<uint32_t> positions(clusters.size());
+	std::iota(positions.begin(), positions.end(), 0);
+	kmerIndex_.build(clusters, positions);
+
+	//for each cluster not in the tree, the fewest differences to a cluster in the tree, that cluster and their comparison
+	const uint64_t unreached = std::numeric_limits<uint64_t>::max();
+	std::vector<uint8_t> inTree(clusters.size(), 0);
+	std::vector<uint64_t> bestDiffs(clusters.size(), unreached);
+	std::vector<uint32_t> bestParent(clusters.size(), 0);
+	std::vector<comparison> bestComps(clusters.size());
+
+	std::vector<uint32_t> candidates;
+	std::vector<uint64_t> candDiffs;
+	std::vector<comparison> candComps;
+	std::vector<std::exception_ptr> exceptions(numThreads_);
+	uint32_t added = 0;
+	for (uint32_t step = 1; step < clusters.size(); ++step) {
+		inTree[added] = 1;
+		kmerIndex_.setQuery(added);
+		candidates.clear();
+		for (uint32_t pos = 0; pos < clusters.size(); ++pos) {
+			if (inTree[pos] || 0 == bestDiffs[pos]) {
+				continue;
+			}
+			//only worth aligning if it could have fewer differences than it already has to the tree
+			if (unreached != bestDiffs[pos]
+					&& !kmerIndex_.couldMatch(pos, bestDiffs[pos] - 1, countEndGaps_)) {
+				++kmerSkipped_;
+				continue;
+			}
+			candidates.emplace_back(pos);
+		}
+		candDiffs.assign(candidates.size(), 0);
+		candComps.resize(candidates.size());
+		std::atomic<uint32_t> nextCandidate { 0 };
+		auto alignCandidates = [&](uint32_t threadNum) {
+			try {
+				auto & threadAligner = *threadAligners[threadNum];
+				for (uint32_t candPos = nextCandidate++; candPos < candidates.size(); candPos = nextCandidate++) {
+					const auto & read = clusters[candidates[candPos]];
+					threadAligner.alignCacheGlobal(clusters[added], read);
+					threadAligner.profileAlignment(clusters[added], read, false, true, false);
+					candComps[candPos] = threadAligner.comp_;
+					candDiffs[candPos] = differences(threadAligner.comp_);
+				}
+			} catch (...) {
+				exceptions[threadNum] = std::current_exception();
+			}
+		};
+		if (1 == numThreads_) {
+			alignCandidates(0);
+		} else {
+			std::vector<std::thread> threads;
+			for (uint32_t t = 0; t < numThreads_; ++t) {
+				threads.emplace_back(alignCandidates, t);
+			}
+			for (auto & t : threads) {
+				t.join();
+			}
+		}
+		for (const auto & e : exceptions) {
+			if (nullptr != e) {
+				std::rethrow_exception(e);
+			}
+		}
+		for (uint32_t candPos = 0; candPos < candidates.size(); ++candPos) {
+			const auto pos = candidates[candPos];
+			if (candDiffs[candPos] < bestDiffs[pos]) {
+				bestDiffs[pos] = candDiffs[candPos];
+				bestParent[pos] = added;
+				bestComps[pos] = candComps[candPos];
+			}
+		}
+		//the closest cluster not in the tree joins it next, the first one on ties
+		uint32_t next = std::numeric_limits<uint32_t>::max();
+		for (uint32_t pos = 0; pos < clusters.size(); ++pos) {
+			if (!inTree[pos]
+					&& (std::numeric_limits<uint32_t>::max() == next
+							|| bestDiffs[pos] < bestDiffs[next])) {
+				next = pos;
+			}
+		}
+		ret.addEdge(clusters[bestParent[next]].seqBase_.name_,
+				clusters[next].seqBase_.name_, bestComps[next]);
+		added = next;
+	}
+	//the thread aligners started as copies so their counts past alignerObj's are the alignments they did
+	uint64_t startingAlignments = alignerObj.numberOfAlingmentsDone_;
+	for (uint32_t t = 0; t < numThreads_; ++t) {
+		alignmentsDone_ += threadAligners[t]->numberOfAlingmentsDone_ - startingAlignments;
+	}
+	alignerObj.numberOfAlingmentsDone_ += alignmentsDone_;
+	return ret;
+}
+
+}  // namespace bibseq
@@ -0,0 +1,62 @@
+#pragma once
+
+/*
+ * MinSpanningTreeBuilder.hpp
+ *
+ *  Created on: Mar 23, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+#include "SeekDeep/objects/ClusterKmerIndex.hpp"
+
+namespace bibseq {
+
+/**@brief Builds a minimum spanning tree of clusters by the number of differences between them with Prim's algorithm, only the
+ * tree's edges are kept rather than a comparison of every pair, used by clusterDown's --minTreeByDifferences
+ *
+ * Unlike the pseudo minimum spanning trees made from a comparison of every pair, differences are counted by base rather than by
+ * event, so a three base gap weighs three, and each cluster joins the tree by a single edge, other edges of the same weight aren't
+ * kept
+ *
+ * Each time a cluster joins the tree it's aligned on several threads to the clusters not in the tree yet, skipping the ones whose
+ * shared kmers show they can't be closer to it than to the cluster they're already closest to in the tree, which can't change the
+ * tree
+ *
+ */
+class MinSpanningTreeBuilder {
+public:
+	/**@brief
+	 *
+	 * @param numThreads the number of threads to align on
+	 * @param countEndGaps whether gaps at the ends count as differences, should be what alignerObj was made with
+	 */
+	MinSpanningTreeBuilder(uint32_t numThreads, bool countEndGaps);
+
+	const uint32_t numThreads_;
+	const bool countEndGaps_;
+	//alignments done by the threads, also added to the aligner's numberOfAlingmentsDone_
+	uint64_t alignmentsDone_ = 0;
+	//alignments the kmer bound showed weren't needed
+	uint64_t kmerSkipped_ = 0;
+
+	/**@brief the number of differences in a profiled alignment, each mismatch and each gap base is one difference
+	 *
+	 */
+	static uint64_t differences(const comparison & comp);
+
+	/**@brief build the tree, it's started from the first cluster and ties are broken by position so the tree doesn't depend on
+	 * the number of threads
+	 *
+	 * @param clusters the clusters to connect
+	 * @param alignerObj the aligner to copy for each thread
+	 * @return a graph of the clusters with only the tree's edges
+	 */
+	comparisonGraph build(const std::vector<cluster> & clusters,
+			aligner & alignerObj);
+
+private:
+	ClusterKmerIndex kmerIndex_;
+};
+
+}  // namespace bibseq
@@ -0,0 +1,230 @@
+/*
+ * PackedSeq.cpp
+ *
+ *  Created on: Mar 22, 2017
+ *      Author: nick
+ */
+
+#include "PackedSeq.hpp"
+
+namespace bibseq {
+
+namespace {
+
+//the low bit of each base
+const uint64_t baseLowBits = 0x5555555555555555ULL;
+
+//shift of the base at pos within its word
+inline uint32_t baseShift(uint32_t pos) {
+	return 62 - 2 * (pos % 32);
+}
+
+}  // namespace
+
+PackedSeq::PackedSeq() {
+}
+
+PackedSeq::PackedSeq(const std::string & seq) {
+	assign(seq);
+}
+
+uint64_t PackedSeq::baseCode(char base) {
+	switch (base) {
+	case 'A':
+	case 'a':
+		return 0;
+	case 'C':
+	case 'c':
+		return 1;
+	case 'G':
+	case 'g':
+		return 2;
+	case 'T':
+	case 't':
+		return 3;
+	default:
+		return 4;
+	}
+}
+
+bool PackedSeq::canPackExactly(const std::string & seq) {
+	for (const auto base : seq) {
+		if ('A' != base && 'C' != base && 'G' != base && 'T' != base
+				&& 'N' != base) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void PackedSeq::assign(const std::string & seq) {
+	if (seq.size() > std::numeric_limits<uint32_t>::max()) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: can't pack a sequence longer than "
+				<< std::numeric_limits<uint32_t>::max() << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	len_ = seq.size();
+	words_.assign((len_ + 31) / 32, 0);
+	nMask_.clear();
+	for (uint32_t pos = 0; pos < len_; ++pos) {
+		auto code = baseCode(seq[pos]);
+		if (code > 3) {
+			if (nMask_.empty()) {
+				nMask_.assign(words_.size(), 0);
+			}
+			nMask_[pos / 32] |= static_cast<uint64_t>(1) << baseShift(pos);
+		} else {
+			words_[pos / 32] |= code << baseShift(pos);
+		}
+	}
+}
+
+uint32_t PackedSeq::size() const {
+	return len_;
+}
+
+bool PackedSeq::hasN() const {
+	return !nMask_.empty();
+}
+
+uint32_t PackedSeq::numberOfNs() const {
+	uint32_t ret = 0;
+	for (const auto word : nMask_) {
+		ret += __builtin_popcountll(word);
+	}
+	return ret;
+}
+
+char PackedSeq::getBase(uint32_t pos) const {
+	if (pos >= len_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: pos, " << pos
+				<< ", is out of range, size is " << len_ << "\n";
+		throw std::out_of_range { ss.str() };
+	}
+	if (!nMask_.empty() && (nMask_[pos / 32] >> baseShift(pos)) & 1) {
+		return 'N';
+	}
+	return "ACGT"[(words_[pos / 32] >> baseShift(pos)) & 3];
+}
+
+std::string PackedSeq::toString() const {
+	std::string ret(len_, 'N');
+	for (uint32_t pos = 0; pos < len_; ++pos) {
+		if (nMask_.empty() || !((nMask_[pos / 32] >> baseShift(pos)) & 1)) {
+			ret[pos] = "ACGT"[(words_[pos / 32] >> baseShift(pos)) & 3];
+		}
+	}
+	return ret;
+}
+
+bool PackedSeq::operator==(const PackedSeq & other) const {
+	return len_ == other.len_ && words_ == other.words_ && nMask_ == other.nMask_;
+}
+
+bool PackedSeq::operator!=(const PackedSeq & other) const {
+	return !(*this == other);
+}
+
+uint64_t PackedSeq::hash() const {
+	uint64_t ret = len_;
+	auto combine = [&ret](uint64_t word) {
+		ret ^= word + 0x9e3779b97f4a7c15ULL + (ret << 6) + (ret >> 2);
+	};
+	for (const auto word : words_) {
+		combine(word);
+	}
+	for (const auto word : nMask_) {
+		combine(word);
+	}
+	return ret;
+}
+
+size_t PackedSeq::Hash::operator()(const PackedSeq & seq) const {
+	return seq.hash();
+}
+
+uint32_t PackedSeq::hammingDistance(const PackedSeq & other) const {
+	if (len_ != other.len_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: sequences have to be the same length, not "
+				<< len_ << " and " << other.len_ << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	bool eitherHasN = !nMask_.empty() || !other.nMask_.empty();
+	uint32_t ret = 0;
+	for (uint32_t wordPos = 0; wordPos < words_.size(); ++wordPos) {
+		uint64_t diff = words_[wordPos] ^ other.words_[wordPos];
+		//one bit per differing base
+		diff = (diff | (diff >> 1)) & baseLowBits;
+		if (eitherHasN) {
+			//an N against anything but an N is a difference, even an A which has the same bits
+			diff |= (nMask_.empty() ? 0 : nMask_[wordPos])
+					^ (other.nMask_.empty() ? 0 : other.nMask_[wordPos]);
+		}
+		ret += __builtin_popcountll(diff);
+	}
+	return ret;
+}
+
+uint64_t PackedSeq::getBits(const std::vector<uint64_t> & words, uint32_t pos,
+		uint32_t kLen) {
+	uint32_t wordPos = pos / 32;
+	uint32_t offset = 2 * (pos % 32);
+	uint64_t bits = words[wordPos] << offset;
+	if (offset > 0 && wordPos + 1 < words.size()) {
+		bits |= words[wordPos + 1] >> (64 - offset);
+	}
+	return bits >> (64 - 2 * kLen);
+}
+
+void PackedSeq::checkKmer(uint32_t pos, uint32_t kLen,
+		const std::string & funcName) const {
+	if (0 == kLen || kLen > 32 || pos + kLen > len_) {
+		std::stringstream ss;
+		ss << funcName << ", error: a kmer of length " << kLen << " at " << pos
+				<< " doesn't fit in a sequence of length " << len_
+				<< ", the length has to be 1 to 32" << "\n";
+		throw std::out_of_range { ss.str() };
+	}
+}
+
+uint64_t PackedSeq::getKmer(uint32_t pos, uint32_t kLen) const {
+	checkKmer(pos, kLen, __PRETTY_FUNCTION__);
+	return getBits(words_, pos, kLen);
+}
+
+bool PackedSeq::kmerHasN(uint32_t pos, uint32_t kLen) const {
+	checkKmer(pos, kLen, __PRETTY_FUNCTION__);
+	return !nMask_.empty() && 0 != getBits(nMask_, pos, kLen);
+}
+
+uint32_t PackedSeq::kmers(uint32_t kLen, std::vector<uint64_t> & kmers) const {
+	kmers.clear();
+	if (0 == kLen || kLen > 32) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: kLen should be between 1 and 32, not "
+				<< kLen << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	uint32_t kmersWithN = 0;
+	if (len_ < kLen) {
+		return kmersWithN;
+	}
+	kmers.reserve(len_ - kLen + 1);
+	for (uint32_t pos = 0; pos + kLen <= len_; ++pos) {
+		if (!nMask_.empty() && 0 != getBits(nMask_, pos, kLen)) {
+			++kmersWithN;
+		} else {
+			kmers.emplace_back(getBits(words_, pos, kLen));
+		}
+	}
+	return kmersWithN;
+}
+
+uint64_t PackedSeq::bytesUsed() const {
+	return sizeof(PackedSeq) + (words_.capacity() + nMask_.capacity()) * sizeof(uint64_t);
+}
+
+}  // namespace bibseq
@@ -0,0 +1,102 @@
+#pragma once
+
+/*
+ * PackedSeq.hpp
+ *
+ *  Created on: Mar 22, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+
+namespace bibseq {
+
+/**@brief A nucleotide sequence packed 2 bits a base, 32 bases to a 64 bit word with the first base in the highest bits, anything other
+ * than A,C,G,T (either case) is an N and is marked in a mask laid out the same way that's only allocated if there are any Ns
+ *
+ * Since the first base is in the highest bits a kmer is the same number as a kmer packed a base at a time with key = (key << 2) | code,
+ * so identity, hamming distance and kmers are a word at a time rather than a base at a time
+ *
+ */
+class PackedSeq {
+public:
+	PackedSeq();
+	explicit PackedSeq(const std::string & seq);
+
+	/**@brief pack seq, re-using the storage
+	 *
+	 * @param seq the sequence to pack
+	 */
+	void assign(const std::string & seq);
+
+	uint32_t size() const;
+	bool hasN() const;
+	uint32_t numberOfNs() const;
+
+	/**@brief unpack, bases come back upper case and anything that wasn't A,C,G,T comes back as N
+	 *
+	 */
+	std::string toString() const;
+
+	char getBase(uint32_t pos) const;
+
+	bool operator==(const PackedSeq & other) const;
+	bool operator!=(const PackedSeq & other) const;
+
+	uint64_t hash() const;
+
+	struct Hash {
+		size_t operator()(const PackedSeq & seq) const;
+	};
+
+	/**@brief number of positions that differ, an N only matches another N, both have to be the same length
+	 *
+	 * @param other the sequence to compare to
+	 * @return the number of differing positions
+	 */
+	uint32_t hammingDistance(const PackedSeq & other) const;
+
+	/**@brief the kmer starting at pos, Ns are read as A so check kmerHasN() if that matters
+	 *
+	 * @param pos the start of the kmer
+	 * @param kLen the kmer length, 1 to 32
+	 * @return the packed kmer
+	 */
+	uint64_t getKmer(uint32_t pos, uint32_t kLen) const;
+	bool kmerHasN(uint32_t pos, uint32_t kLen) const;
+
+	/**@brief all the kmers without an N, in order
+	 *
+	 * @param kLen the kmer length, 1 to 32
+	 * @param kmers filled with the packed kmers
+	 * @return the number of kmers with an N
+	 */
+	uint32_t kmers(uint32_t kLen, std::vector<uint64_t> & kmers) const;
+
+	uint64_t bytesUsed() const;
+
+	/**@brief 2bit code of a base, 4 for anything other than A,C,G,T
+	 *
+	 */
+	static uint64_t baseCode(char base);
+
+	/**@brief whether seq is only upper case A,C,G,T and N so toString() gives back the same sequence
+	 *
+	 */
+	static bool canPackExactly(const std::string & seq);
+
+private:
+	uint32_t len_ = 0;
+	std::vector<uint64_t> words_;
+	//empty if there are no Ns
+	std::vector<uint64_t> nMask_;
+
+	/**@brief the 2*kLen bits of words starting at base pos in the lowest bits
+	 *
+	 */
+	static uint64_t getBits(const std::vector<uint64_t> & words, uint32_t pos,
+			uint32_t kLen);
+	void checkKmer(uint32_t pos, uint32_t kLen, const std::string & funcName) const;
+};
+
+}  // namespace bibseq
@@ -0,0 +1,277 @@
+/*
+ * PairedReadStitcher.cpp
+ *
+ *  Created on: Mar 21, 2017
+ *      Author: nick
+ */
+
+#include "PairedReadStitcher.hpp"
+
+namespace bibseq {
+
+namespace {
+
+const uint64_t lowBits = 0x7f7f7f7f7f7f7f7fULL;
+const uint64_t highBits = 0x8080808080808080ULL;
+const uint64_t allNs = 0x4e4e4e4e4e4e4e4eULL;
+
+//the high bit of each byte is set if that byte isn't zero
+inline uint64_t nonZeroBytes(uint64_t word) {
+	return (((word & lowBits) + lowBits) | word) & highBits;
+}
+
+//the high bit of each byte is set if that byte is an N
+inline uint64_t nBytes(uint64_t word) {
+	return ~nonZeroBytes(word ^ allNs) & highBits;
+}
+
+}  // namespace
+
+uint64_t PairedReadStitcher::Stats::uncombinedPairs() const {
+	return totalPairs_ - combinedPairs_;
+}
+
+double PairedReadStitcher::Stats::percentCombined() const {
+	return 0 == totalPairs_ ? 0 : 100.0 * combinedPairs_ / totalPairs_;
+}
+
+void PairedReadStitcher::Stats::addOtherStats(const Stats & other) {
+	totalPairs_ += other.totalPairs_;
+	combinedPairs_ += other.combinedPairs_;
+	overMaxOverlap_ += other.overMaxOverlap_;
+	for (const auto & lenCount : other.combinedLengths_) {
+		combinedLengths_[lenCount.first] += lenCount.second;
+	}
+}
+
+std::string PairedReadStitcher::Stats::flashLog() const {
+	std::stringstream ss;
+	ss << "[FLASH] Read combination statistics:" << "\n";
+	ss << "[FLASH]     Total pairs:      " << totalPairs_ << "\n";
+	ss << "[FLASH]     Combined pairs:   " << combinedPairs_ << "\n";
+	ss << "[FLASH]     Uncombined pairs: " << uncombinedPairs() << "\n";
+	ss << "[FLASH]     Percent combined: " << std::fixed << std::setprecision(2)
+			<< percentCombined() << "%" << "\n";
+	ss << "[FLASH]  " << "\n";
+	ss << "[FLASH] Writing histogram files." << "\n";
+	return ss.str();
+}
+
+Json::Value PairedReadStitcher::Stats::toJson() const {
+	Json::Value ret;
+	ret["totalPairs"] = bib::json::toJson(totalPairs_);
+	ret["combinedPairs"] = bib::json::toJson(combinedPairs_);
+	ret["uncombinedPairs"] = bib::json::toJson(uncombinedPairs());
+	ret["percentCombined"] = bib::json::toJson(percentCombined());
+	ret["overMaxOverlap"] = bib::json::toJson(overMaxOverlap_);
+	return ret;
+}
+
+PairedReadStitcher::PairedReadStitcher(const StitchPars & pars) :
+		pars_(pars) {
+	if (0 == pars_.minOverlap_ || pars_.minOverlap_ > pars_.maxOverlap_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: minOverlap should be between 1 and maxOverlap ("
+				<< pars_.maxOverlap_ << ") not " << pars_.minOverlap_ << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+}
+
+uint32_t PairedReadStitcher::countMismatches(const char * seq1,
+		const char * seq2, uint32_t len, uint32_t maxMismatches,
+		uint32_t & uncalled) {
+	uint32_t mismatches = 0;
+	uncalled = 0;
+	uint32_t pos = 0;
+	for (; pos + 8 <= len; pos += 8) {
+		uint64_t word1 = 0;
+		uint64_t word2 = 0;
+		std::memcpy(&word1, seq1 + pos, 8);
+		std::memcpy(&word2, seq2 + pos, 8);
+		uint64_t ns = nBytes(word1) | nBytes(word2);
+		mismatches += __builtin_popcountll(nonZeroBytes(word1 ^ word2) & ~ns);
+		uncalled += __builtin_popcountll(ns);
+		if (mismatches > maxMismatches) {
+			return mismatches;
+		}
+	}
+	for (; pos < len; ++pos) {
+		if ('N' == seq1[pos] || 'N' == seq2[pos]) {
+			++uncalled;
+		} else if (seq1[pos] != seq2[pos]) {
+			++mismatches;
+		}
+	}
+	return mismatches;
+}
+
+PairedReadStitcher::Overlap PairedReadStitcher::findOverlap(const seqInfo & r1,
+		const seqInfo & r2RevComp) const {
+	Overlap best;
+	const uint32_t len1 = r1.seq_.size();
+	const uint32_t len2 = r2RevComp.seq_.size();
+	double bestDensity = pars_.maxMismatchDensity_;
+	auto scoreOverlap = [&](uint32_t start, uint32_t mateStart, uint32_t overlapLen) {
+		if (overlapLen < pars_.minOverlap_) {
+			return;
+		}
+		uint32_t scoredLen = std::min(overlapLen, pars_.maxOverlap_);
+		uint32_t maxMismatches = static_cast<uint32_t>(bestDensity * scoredLen);
+		uint32_t uncalled = 0;
+		uint32_t mismatches = countMismatches(r1.seq_.data() + start,
+				r2RevComp.seq_.data() + mateStart, overlapLen, maxMismatches, uncalled);
+		if (mismatches > maxMismatches) {
+			return;
+		}
+		uint32_t effectiveLen = std::min(overlapLen - uncalled, pars_.maxOverlap_);
+		if (effectiveLen < pars_.minOverlap_) {
+			return;
+		}
+		double density = static_cast<double>(mismatches) / effectiveLen;
+		if (best.found_ ? density < bestDensity : density <= bestDensity) {
+			best.found_ = true;
+			best.start_ = start;
+			best.mateStart_ = mateStart;
+			best.length_ = overlapLen;
+			best.mismatches_ = mismatches;
+			bestDensity = density;
+		}
+	};
+	//longest overlaps first so ties go to the longer overlap
+	for (uint32_t start = 0; start + pars_.minOverlap_ <= len1; ++start) {
+		scoreOverlap(start, 0, std::min(len1 - start, len2));
+	}
+	//insert shorter than the reads, the mate starts before the first read so both read into the adapter,
+	//only taken when strictly better than the overlaps above
+	for (uint32_t mateStart = 1; mateStart + pars_.minOverlap_ <= len2; ++mateStart) {
+		scoreOverlap(0, mateStart, std::min(len1, len2 - mateStart));
+	}
+	return best;
+}
+
+bool PairedReadStitcher::stitch(const seqInfo & r1, const seqInfo & r2,
+		seqInfo & stitched) {
+	++stats_.totalPairs_;
+	r2RevComp_ = r2;
+	r2RevComp_.reverseComplementRead(false, true);
+	auto overlap = findOverlap(r1, r2RevComp_);
+	if (!overlap.found_) {
+		return false;
+	}
+	++stats_.combinedPairs_;
+	if (overlap.length_ > pars_.maxOverlap_) {
+		++stats_.overMaxOverlap_;
+	}
+	const uint32_t len1 = r1.seq_.size();
+	const uint32_t len2 = r2RevComp_.seq_.size();
+	//when the mate starts before the first read what hangs off the front of the mate and off the end of the first read is
+	//adapter so the stitched read starts at the first read and ends with the mate
+	const uint32_t stitchedLen = overlap.mateStart_ > 0 ?
+			len2 - overlap.mateStart_ : std::max(len1, overlap.start_ + len2);
+	stitched.name_ = r1.name_;
+	stitched.seq_.assign(stitchedLen, 'N');
+	stitched.qual_.assign(stitchedLen, 0);
+	std::copy(r1.seq_.begin(), r1.seq_.begin() + overlap.start_,
+			stitched.seq_.begin());
+	std::copy(r1.qual_.begin(), r1.qual_.begin() + overlap.start_,
+			stitched.qual_.begin());
+	for (uint32_t pos = 0; pos < overlap.length_; ++pos) {
+		const uint32_t stitchedPos = overlap.start_ + pos;
+		const char base1 = r1.seq_[stitchedPos];
+		const char base2 = r2RevComp_.seq_[overlap.mateStart_ + pos];
+		const uint32_t qual1 = r1.qual_[stitchedPos];
+		const uint32_t qual2 = r2RevComp_.qual_[overlap.mateStart_ + pos];
+		if ('N' == base2 || (base1 != base2 && 'N' != base1 && qual1 >= qual2)) {
+			stitched.seq_[stitchedPos] = base1;
+			stitched.qual_[stitchedPos] =
+					'N' == base2 ? qual1 : std::max<uint32_t>(2, qual1 - qual2);
+		} else if ('N' == base1 || base1 != base2) {
+			stitched.seq_[stitchedPos] = base2;
+			stitched.qual_[stitchedPos] =
+					'N' == base1 ? qual2 : std::max<uint32_t>(2, qual2 - qual1);
+		} else {
+			stitched.seq_[stitchedPos] = base1;
+			stitched.qual_[stitchedPos] = std::max(qual1, qual2);
+		}
+	}
+	//whichever read extends past the overlap
+	for (uint32_t pos = overlap.start_ + overlap.length_; pos < stitchedLen; ++pos) {
+		if (pos < len1) {
+			stitched.seq_[pos] = r1.seq_[pos];
+			stitched.qual_[pos] = r1.qual_[pos];
+		} else {
+			stitched.seq_[pos] = r2RevComp_.seq_[pos - overlap.start_ + overlap.mateStart_];
+			stitched.qual_[pos] = r2RevComp_.qual_[pos - overlap.start_ + overlap.mateStart_];
+		}
+	}
+	++stats_.combinedLengths_[stitchedLen];
+	return true;
+}
+
+void PairedReadStitcher::stitchFiles(const VecStr & r1Files,
+		const VecStr & r2Files, const std::string & outStub) {
+	if (r1Files.size() != r2Files.size()) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: the number of first read files, "
+				<< r1Files.size() << ", doesn't match the number of mate files, "
+				<< r2Files.size() << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	SeqOutput extendedOut(SeqIOOptions::genFastqOut(outStub + ".extendedFrags.fastq"));
+	SeqOutput notCombined1Out(SeqIOOptions::genFastqOut(outStub + ".notCombined_1.fastq"));
+	SeqOutput notCombined2Out(SeqIOOptions::genFastqOut(outStub + ".notCombined_2.fastq"));
+	extendedOut.openOut();
+	notCombined1Out.openOut();
+	notCombined2Out.openOut();
+	seqInfo r1;
+	seqInfo r2;
+	seqInfo stitched;
+	for (uint32_t filePos = 0; filePos < r1Files.size(); ++filePos) {
+		//gzipped input is read straight from the file
+		auto r1Opts = SeqIOOptions::genFastqIn(r1Files[filePos]);
+		auto r2Opts = SeqIOOptions::genFastqIn(r2Files[filePos]);
+		if (bib::endsWith(r1Files[filePos], ".gz")) {
+			r1Opts.inFormat_ = SeqIOOptions::inFormats::FASTQGZ;
+		}
+		if (bib::endsWith(r2Files[filePos], ".gz")) {
+			r2Opts.inFormat_ = SeqIOOptions::inFormats::FASTQGZ;
+		}
+		SeqInput r1In(r1Opts);
+		SeqInput r2In(r2Opts);
+		r1In.openIn();
+		r2In.openIn();
+		while (r1In.readNextRead(r1)) {
+			if (!r2In.readNextRead(r2)) {
+				std::stringstream ss;
+				ss << __PRETTY_FUNCTION__ << ", error: " << r2Files[filePos]
+						<< " has fewer reads than " << r1Files[filePos] << "\n";
+				throw std::runtime_error { ss.str() };
+			}
+			if (std::numeric_limits<uint32_t>::max() != pars_.r1Trim_) {
+				readVecTrimmer::trimToMaxLength(r1, pars_.r1Trim_);
+			}
+			if (std::numeric_limits<uint32_t>::max() != pars_.r2Trim_) {
+				readVecTrimmer::trimToMaxLength(r2, pars_.r2Trim_);
+			}
+			if (stitch(r1, r2, stitched)) {
+				extendedOut.write(stitched);
+			} else {
+				notCombined1Out.write(r1);
+				notCombined2Out.write(r2);
+			}
+		}
+		if (r2In.readNextRead(r2)) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error: " << r1Files[filePos]
+					<< " has fewer reads than " << r2Files[filePos] << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+	}
+	std::ofstream histFile;
+	openTextFile(histFile, outStub + ".hist", ".hist", true, false);
+	for (const auto & lenCount : stats_.combinedLengths_) {
+		histFile << lenCount.first << "\t" << lenCount.second << "\n";
+	}
+}
+
+}  // namespace bibseq
@@ -0,0 +1,117 @@
+#pragma once
+
+/*
+ * PairedReadStitcher.hpp
+ *
+ *  Created on: Mar 21, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+
+namespace bibseq {
+
+/**@brief Stitches overlapping illumina read pairs into single reads in process, a replacement for running flash on unzipped copies
+ * of the reads
+ *
+ * The reverse complement of the mate is slid along the end of the first read, and for inserts shorter than the reads the first
+ * read is slid along the mate, and the overlap with the lowest mismatch density
+ * (mismatches over overlap length not counting Ns, the length is capped at maxOverlap_ same as flash) is taken if it's under
+ * maxMismatchDensity_, mismatches are counted 8 bases at a time, in the overlap agreeing bases get the higher quality and
+ * disagreeing bases take the higher quality base with the difference of the qualities as the new quality
+ *
+ */
+class PairedReadStitcher {
+public:
+	struct StitchPars {
+		uint32_t minOverlap_ = 10;
+		uint32_t maxOverlap_ = 65;
+		double maxMismatchDensity_ = 0.25;
+		//trim the reads to these lengths before stitching
+		uint32_t r1Trim_ = std::numeric_limits<uint32_t>::max();
+		uint32_t r2Trim_ = std::numeric_limits<uint32_t>::max();
+	};
+
+	struct Stats {
+		uint64_t totalPairs_ = 0;
+		uint64_t combinedPairs_ = 0;
+		//combined pairs whose overlap was longer than maxOverlap_
+		uint64_t overMaxOverlap_ = 0;
+		//length of the combined reads to count
+		std::map<uint32_t, uint64_t> combinedLengths_;
+
+		uint64_t uncombinedPairs() const;
+		double percentCombined() const;
+
+		void addOtherStats(const Stats & other);
+
+		/**@brief The stats written the same way as flash's log so they can be read by the same code
+		 *
+		 * @return the log
+		 */
+		std::string flashLog() const;
+		Json::Value toJson() const;
+	};
+
+	struct Overlap {
+		bool found_ = false;
+		//position in the first read where the mate starts
+		uint32_t start_ = 0;
+		//position in the mate where the first read starts, only above 0 when the insert is shorter than the reads and the
+		//mate starts before the first read, start_ is then 0
+		uint32_t mateStart_ = 0;
+		uint32_t length_ = 0;
+		uint32_t mismatches_ = 0;
+	};
+
+	PairedReadStitcher(const StitchPars & pars);
+
+	StitchPars pars_;
+	Stats stats_;
+
+	/**@brief Find the best overlap of the end of r1 with the start of the reverse complemented mate, or of the start of r1 with
+	 * the middle of the mate when the mate starts before r1
+	 *
+	 * @param r1 the first read
+	 * @param r2RevComp the reverse complement of the mate
+	 * @return the overlap, found_ is false if no overlap passed
+	 */
+	Overlap findOverlap(const seqInfo & r1, const seqInfo & r2RevComp) const;
+
+	/**@brief Stitch a pair of reads, the stats are updated
+	 *
+	 * @param r1 the first read
+	 * @param r2 the mate as sequenced
+	 * @param stitched the stitched read, named after r1
+	 * @return whether the reads could be stitched
+	 */
+	bool stitch(const seqInfo & r1, const seqInfo & r2, seqInfo & stitched);
+
+	/**@brief Stitch the pairs from fastq files, which can be gzipped, writing outStub.extendedFrags.fastq, outStub.notCombined_1.fastq,
+	 * outStub.notCombined_2.fastq and a histogram of the stitched lengths to outStub.hist, same as flash
+	 *
+	 * @param r1Files the first reads files
+	 * @param r2Files the mate files, in the same order as r1Files
+	 * @param outStub the start of the output file names
+	 */
+	void stitchFiles(const VecStr & r1Files, const VecStr & r2Files,
+			const std::string & outStub);
+
+	/**@brief Count mismatches between seq1 and seq2 ignoring Ns, 8 bases at a time, stops early once over maxMismatches
+	 *
+	 * @param seq1 the first sequence
+	 * @param seq2 the second sequence
+	 * @param len the number of bases to compare
+	 * @param maxMismatches stop counting once more than this many mismatches are found
+	 * @param uncalled set to the number of positions where either base was N
+	 * @return the mismatches
+	 */
+	static uint32_t countMismatches(const char * seq1, const char * seq2,
+			uint32_t len, uint32_t maxMismatches, uint32_t & uncalled);
+
+private:
+	//re-used for the reverse complement of the mate
+	seqInfo r2RevComp_;
+};
+
+}  // namespace bibseq
@@ -0,0 +1,264 @@
+/*
+ * PrimerEditScreen.cpp
+ *
+ *  Created on: Mar 10, 2017
+ *      Author: nick
+ */
+
+#include "PrimerEditScreen.hpp"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace bibseq {
+
+#if defined(__AVX2__)
+const uint32_t PrimerEditScreen::lanes_ = 16;
+#elif defined(__SSE2__)
+const uint32_t PrimerEditScreen::lanes_ = 8;
+#else
+const uint32_t PrimerEditScreen::lanes_ = 8;
+#endif
+
+const uint16_t PrimerEditScreen::noLimit_ = std::numeric_limits<uint16_t>::max();
+
+std::string PrimerEditScreen::simdType() {
+#if defined(__AVX2__)
+	return "AVX2";
+#elif defined(__SSE2__)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
+
+uint16_t PrimerEditScreen::primerBaseMask(char base) {
+	switch (std::toupper(base)) {
+	case 'A':
+		return 1;
+	case 'C':
+		return 2;
+	case 'G':
+		return 4;
+	case 'T':
+	case 'U':
+		return 8;
+	case 'R':
+		return 1 | 4;
+	case 'Y':
+		return 2 | 8;
+	case 'S':
+		return 2 | 4;
+	case 'W':
+		return 1 | 8;
+	case 'K':
+		return 4 | 8;
+	case 'M':
+		return 1 | 2;
+	case 'B':
+		return 2 | 4 | 8;
+	case 'D':
+		return 1 | 4 | 8;
+	case 'H':
+		return 1 | 2 | 8;
+	case 'V':
+		return 1 | 2 | 4;
+	default:
+		return 15;
+	}
+}
+
+uint16_t PrimerEditScreen::readBaseMask(char base) {
+	switch (std::toupper(base)) {
+	case 'A':
+		return 1;
+	case 'C':
+		return 2;
+	case 'G':
+		return 4;
+	case 'T':
+		return 8;
+	default:
+		return 15;
+	}
+}
+
+PrimerEditScreen::PrimerEditScreen(const VecStr & primers,
+		uint32_t windowPadding) :
+		primers_(primers), windowPadding_(windowPadding) {
+	for (const auto & primer : primers_) {
+		if (primer.size() >= noLimit_) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error: primer is too long: " << primer
+					<< "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		maxPrimerLen_ = std::max<uint32_t>(maxPrimerLen_, primer.size());
+	}
+	groups_ = (primers_.size() + lanes_ - 1) / lanes_;
+	//rows past a primer's length are filled with matches to everything, those rows aren't used for that primer
+	primerMasks_ = std::vector<uint16_t>(groups_ * maxPrimerLen_ * lanes_, 15);
+	primerLens_ = std::vector<uint16_t>(groups_ * lanes_, 0);
+	for (uint32_t primerPos = 0; primerPos < primers_.size(); ++primerPos) {
+		uint32_t group = primerPos / lanes_;
+		uint32_t lane = primerPos % lanes_;
+		primerLens_[group * lanes_ + lane] = primers_[primerPos].size();
+		for (uint32_t row = 0; row < primers_[primerPos].size(); ++row) {
+			primerMasks_[(group * maxPrimerLen_ + row) * lanes_ + lane] =
+					primerBaseMask(primers_[primerPos][row]);
+		}
+	}
+}
+
+std::unique_ptr<PrimerEditScreen> PrimerEditScreen::forwardPrimerScreen(
+		const PrimersAndMids & ids) {
+	auto targetNames = ids.getTargets();
+	bib::sort(targetNames);
+	VecStr primers;
+	for (const auto & targetName : targetNames) {
+		primers.emplace_back(ids.targets_.at(targetName).info_.forwardPrimer_);
+	}
+	return std::make_unique<PrimerEditScreen>(primers);
+}
+
+std::unique_ptr<PrimerEditScreen> PrimerEditScreen::reversePrimerScreen(
+		const PrimersAndMids & ids) {
+	auto targetNames = ids.getTargets();
+	bib::sort(targetNames);
+	VecStr primers;
+	VecStr primersComp;
+	for (const auto & targetName : targetNames) {
+		const auto & reversePrimer = ids.targets_.at(targetName).info_.reversePrimer_;
+		primers.emplace_back(reversePrimer);
+		primersComp.emplace_back(seqUtil::reverseComplement(reversePrimer, "DNA"));
+	}
+	addOtherVec(primers, primersComp);
+	return std::make_unique<PrimerEditScreen>(primers);
+}
+
+uint16_t PrimerEditScreen::maxDistance(const comparison & allowable,
+		uint32_t primerLen) {
+	if (allowable.largeBaseIndel_ >= 1) {
+		return noLimit_;
+	}
+	double uncovered = (1.0 - allowable.distances_.query_.coverage_) * primerLen;
+	uint32_t ret = allowable.hqMismatches_ + allowable.lqMismatches_
+			+ allowable.oneBaseIndel_ + 2 * allowable.twoBaseIndel_
+			+ (uncovered > 0 ? static_cast<uint32_t>(std::ceil(uncovered)) : 0);
+	return std::min<uint32_t>(ret, noLimit_ - 1);
+}
+
+void PrimerEditScreen::readMasks(const std::string & seq, uint32_t withinPos,
+		std::vector<uint16_t> & masks) const {
+	uint32_t windowLen = std::min<uint32_t>(seq.size(),
+			withinPos + maxPrimerLen_ + windowPadding_);
+	masks.resize(windowLen);
+	for (uint32_t pos = 0; pos < windowLen; ++pos) {
+		masks[pos] = readBaseMask(seq[pos]);
+	}
+}
+
+void PrimerEditScreen::lowerBoundDistancesScalar(const std::string & seq,
+		uint32_t withinPos, std::vector<uint16_t> & distances) const {
+	std::vector<uint16_t> masks;
+	readMasks(seq, withinPos, masks);
+	distances.assign(primers_.size(), 0);
+	std::vector<uint16_t> row(masks.size() + 1);
+	for (uint32_t primerPos = 0; primerPos < primers_.size(); ++primerPos) {
+		const auto & primer = primers_[primerPos];
+		//first row, the primer can start anywhere in the window
+		std::fill(row.begin(), row.end(), 0);
+		uint16_t best = primer.empty() ? 0 : noLimit_;
+		for (uint32_t i = 1; i <= primer.size(); ++i) {
+			auto primerMask = primerBaseMask(primer[i - 1]);
+			uint16_t diag = row[0];
+			row[0] = i;
+			uint16_t rowMin = noLimit_;
+			for (uint32_t j = 1; j <= masks.size(); ++j) {
+				uint16_t up = row[j];
+				uint16_t val = diag + (0 == (primerMask & masks[j - 1]) ? 1 : 0);
+				val = std::min<uint16_t>(val, up + 1);
+				val = std::min<uint16_t>(val, row[j - 1] + 1);
+				diag = up;
+				row[j] = val;
+				rowMin = std::min(rowMin, val);
+			}
+			if (i == primer.size()) {
+				best = std::min<uint16_t>(rowMin, row[0]);
+			}
+		}
+		distances[primerPos] = best;
+	}
+}
+
+void PrimerEditScreen::lowerBoundDistances(const std::string & seq,
+		uint32_t withinPos, std::vector<uint16_t> & distances) const {
+#if defined(__AVX2__) || defined(__SSE2__)
+	std::vector<uint16_t> masks;
+	readMasks(seq, withinPos, masks);
+	distances.assign(primers_.size(), 0);
+#if defined(__AVX2__)
+	typedef __m256i vec;
+	auto set1 = [](uint16_t val) {return _mm256_set1_epi16(static_cast<short>(val));};
+	auto load = [](const uint16_t * ptr) {return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));};
+	auto store = [](uint16_t * ptr, vec val) {_mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), val);};
+	auto add = [](vec a, vec b) {return _mm256_adds_epu16(a, b);};
+	auto minVec = [](vec a, vec b) {return _mm256_min_epu16(a, b);};
+	auto andVec = [](vec a, vec b) {return _mm256_and_si256(a, b);};
+	auto cmpeq = [](vec a, vec b) {return _mm256_cmpeq_epi16(a, b);};
+	auto blend = [](vec a, vec b, vec mask) {return _mm256_blendv_epi8(a, b, mask);};
+#else
+	typedef __m128i vec;
+	auto set1 = [](uint16_t val) {return _mm_set1_epi16(static_cast<short>(val));};
+	auto load = [](const uint16_t * ptr) {return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));};
+	auto store = [](uint16_t * ptr, vec val) {_mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), val);};
+	auto add = [](vec a, vec b) {return _mm_adds_epu16(a, b);};
+	//no unsigned 16 bit min in SSE2, values stay well below 2^15 so signed min is fine
+	auto minVec = [](vec a, vec b) {return _mm_min_epi16(a, b);};
+	auto andVec = [](vec a, vec b) {return _mm_and_si128(a, b);};
+	auto cmpeq = [](vec a, vec b) {return _mm_cmpeq_epi16(a, b);};
+	auto blend = [](vec a, vec b, vec mask) {return _mm_or_si128(_mm_andnot_si128(mask, a), _mm_and_si128(mask, b));};
+#endif
+	const vec zero = set1(0);
+	const vec one = set1(1);
+	//kept below 2^15 so the signed min in SSE2 works
+	const uint16_t big = std::numeric_limits<int16_t>::max();
+	//rows are kept as plain arrays and loaded unaligned, vectors of __m256i aren't guaranteed to be aligned
+	std::vector<uint16_t> row(masks.size() * lanes_);
+	std::vector<uint16_t> laneResults(lanes_);
+	for (uint32_t group = 0; group < groups_; ++group) {
+		std::fill(row.begin(), row.end(), 0);
+		vec lens = load(primerLens_.data() + group * lanes_);
+		//primers of length 0 have a distance of 0
+		vec result = blend(set1(big), zero, cmpeq(lens, zero));
+		for (uint32_t i = 1; i <= maxPrimerLen_; ++i) {
+			vec primerMask = load(primerMasks_.data() + (group * maxPrimerLen_ + i - 1) * lanes_);
+			vec diag = set1(i - 1);
+			vec left = set1(i);
+			vec rowMin = left;
+			for (uint32_t j = 0; j < masks.size(); ++j) {
+				vec up = load(row.data() + j * lanes_);
+				vec mismatch = andVec(cmpeq(andVec(primerMask, set1(masks[j])), zero), one);
+				vec val = minVec(add(diag, mismatch), minVec(add(up, one), add(left, one)));
+				diag = up;
+				store(row.data() + j * lanes_, val);
+				left = val;
+				rowMin = minVec(rowMin, val);
+			}
+			result = blend(result, rowMin, cmpeq(lens, set1(i)));
+		}
+		store(laneResults.data(), result);
+		for (uint32_t lane = 0; lane < lanes_; ++lane) {
+			uint32_t primerPos = group * lanes_ + lane;
+			if (primerPos < primers_.size()) {
+				distances[primerPos] = laneResults[lane];
+			}
+		}
+	}
+#else
+	lowerBoundDistancesScalar(seq, withinPos, distances);
+#endif
+}
+
+}  // namespace bibseq
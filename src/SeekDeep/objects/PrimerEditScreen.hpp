@@ -0,0 +1,95 @@
+#pragma once
+
+/*
+ * PrimerEditScreen.hpp
+ *
+ *  Created on: Mar 10, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+#include "SeekDeep/objects/PrimersAndMids.hpp"
+
+namespace bibseq {
+
+/**@brief Computes a lower bound on the number of errors between each primer and the start of a read
+ *
+ * A semi-global edit distance (primer fully aligned, free read ends) over only the first bases of the read where
+ * the primer can be, computed for several primers at once with SIMD (AVX2 or SSE2 when compiled with them, a scalar
+ * fallback otherwise), degenerative bases in the primers and N in the read count as matches so the distance
+ * is never more than the errors the full aligner would find, primers whose distance is more than what
+ * a comparison allows can then be skipped without aligning
+ *
+ */
+class PrimerEditScreen {
+public:
+
+	/**@brief
+	 *
+	 * @param primers the primers to screen, distances are given in this order
+	 * @param windowPadding bases past withinPos + primer length to search to allow for insertions
+	 */
+	PrimerEditScreen(const VecStr & primers, uint32_t windowPadding = 5);
+
+	VecStr primers_;
+	uint32_t windowPadding_;
+	uint32_t maxPrimerLen_ = 0;
+
+	static const uint32_t lanes_;
+	static const uint16_t noLimit_;
+
+	/**@brief the lower bound edit distance of every primer to the start of seq
+	 *
+	 * @param seq the read sequence
+	 * @param withinPos the farthest into seq the primer can start
+	 * @param distances filled with the distances in the order of primers_
+	 */
+	void lowerBoundDistances(const std::string & seq, uint32_t withinPos,
+			std::vector<uint16_t> & distances) const;
+
+	/**@brief non-SIMD version of lowerBoundDistances() for checking and benchmarking
+	 *
+	 */
+	void lowerBoundDistancesScalar(const std::string & seq, uint32_t withinPos,
+			std::vector<uint16_t> & distances) const;
+
+	/**@brief The max edit distance a primer could have and still pass the allowable errors
+	 *
+	 * @param allowable the errors allowed
+	 * @param primerLen the length of the primer
+	 * @return the max distance or noLimit_ if large indels are allowed
+	 */
+	static uint16_t maxDistance(const comparison & allowable, uint32_t primerLen);
+
+	/**@brief A screen of the forward primers of the targets in ids, in the order of the sorted target names
+	 *
+	 */
+	static std::unique_ptr<PrimerEditScreen> forwardPrimerScreen(
+			const PrimersAndMids & ids);
+
+	/**@brief A screen of the reverse primers of the targets in ids followed by their reverse complements, in the order of the sorted target names
+	 *
+	 */
+	static std::unique_ptr<PrimerEditScreen> reversePrimerScreen(
+			const PrimersAndMids & ids);
+
+	/**@brief which instruction set the lowerBoundDistances() is compiled with
+	 *
+	 */
+	static std::string simdType();
+
+private:
+	uint32_t groups_ = 0;
+	//the base masks of the primers by group, then by row, then by lane
+	std::vector<uint16_t> primerMasks_;
+	//the primer lengths by group, then by lane
+	std::vector<uint16_t> primerLens_;
+
+	static uint16_t primerBaseMask(char base);
+	static uint16_t readBaseMask(char base);
+
+	void readMasks(const std::string & seq, uint32_t withinPos,
+			std::vector<uint16_t> & masks) const;
+};
+
+}  // namespace bibseq
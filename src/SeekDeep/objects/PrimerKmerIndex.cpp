@@ -0,0 +1,109 @@
+/*
+ * PrimerKmerIndex.cpp
+ *
+ *  Created on: Mar 8, 2017
+ *      Author: nick
+ */
+
+#include "PrimerKmerIndex.hpp"
+
+namespace bibseq {
+
+namespace {
+/**@brief Call func with the packed kmer for every kmer in seq up to len that is only A,C,G,T
+ *
+ */
+template<typename FUNC>
+void forEachPackedKmer(const std::string & seq, uint32_t len, uint32_t kLen,
+		FUNC func) {
+	len = std::min<uint32_t>(len, seq.size());
+	uint64_t mask = 32 == kLen ? std::numeric_limits<uint64_t>::max() :
+			(static_cast<uint64_t>(1) << (2 * kLen)) - 1;
+	uint64_t key = 0;
+	uint32_t validLen = 0;
+	for (uint32_t pos = 0; pos < len; ++pos) {
+		auto code = PackedSeq::baseCode(seq[pos]);
+		if (code > 3) {
+			validLen = 0;
+			key = 0;
+			continue;
+		}
+		key = ((key << 2) | code) & mask;
+		++validLen;
+		if (validLen >= kLen) {
+			func(key);
+		}
+	}
+}
+}  // namespace
+
+PrimerKmerIndex::PrimerKmerIndex(const PrimersAndMids & ids, uint32_t kLen) :
+		kLen_(kLen) {
+	if (0 == kLen_ || kLen_ > 32) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: kLen should be between 1 and 32, not "
+				<< kLen_ << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	targetNames_ = ids.getTargets();
+	bib::sort(targetNames_);
+	for (uint32_t targetPos = 0; targetPos < targetNames_.size(); ++targetPos) {
+		const auto & info = ids.targets_.at(targetNames_[targetPos]).info_;
+		maxPrimerLen_ = std::max<uint32_t>(maxPrimerLen_, info.forwardPrimer_.size());
+		maxPrimerLen_ = std::max<uint32_t>(maxPrimerLen_, info.reversePrimer_.size());
+		if (0 == indexPrimer(info.forwardPrimer_, targetPos, forwardIndex_)) {
+			forwardAlwaysCheck_.emplace_back(targetPos);
+		}
+		//index the reverse primer in both directions so the shortlist doesn't depend on how it was written
+		uint32_t reverseKmers = indexPrimer(info.reversePrimer_, targetPos, reverseIndex_);
+		reverseKmers += indexPrimer(seqUtil::reverseComplement(info.reversePrimer_, "DNA"),
+				targetPos, reverseIndex_);
+		if (0 == reverseKmers) {
+			reverseAlwaysCheck_.emplace_back(targetPos);
+		}
+	}
+}
+
+uint32_t PrimerKmerIndex::indexPrimer(const std::string & primer,
+		uint32_t targetPos,
+		std::unordered_map<uint64_t, std::vector<uint32_t>> & index) {
+	uint32_t kmersIndexed = 0;
+	forEachPackedKmer(primer, primer.size(), kLen_,
+			[&index,&targetPos,&kmersIndexed](uint64_t key) {
+				auto & targets = index[key];
+				if(targets.empty() || targets.back() != targetPos) {
+					targets.emplace_back(targetPos);
+				}
+				++kmersIndexed;
+			});
+	return kmersIndexed;
+}
+
+std::vector<uint32_t> PrimerKmerIndex::shortlist(const std::string & seq,
+		uint32_t start,
+		const std::unordered_map<uint64_t, std::vector<uint32_t>> & index,
+		const std::vector<uint32_t> & alwaysCheck) const {
+	std::vector<uint32_t> ret = alwaysCheck;
+	forEachPackedKmer(seq, start + maxPrimerLen_ + windowPadding_, kLen_,
+			[&index,&ret](uint64_t key) {
+				auto search = index.find(key);
+				if(index.end() != search) {
+					ret.insert(ret.end(), search->second.begin(), search->second.end());
+				}
+			});
+	std::sort(ret.begin(), ret.end());
+	ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+	return ret;
+}
+
+std::vector<uint32_t> PrimerKmerIndex::shortlistForward(const std::string & seq,
+		uint32_t start) const {
+	return shortlist(seq, start, forwardIndex_, forwardAlwaysCheck_);
+}
+
+std::vector<uint32_t> PrimerKmerIndex::shortlistReverse(const std::string & seq,
+		uint32_t start) const {
+	return shortlist(seq, start, reverseIndex_, reverseAlwaysCheck_);
+}
+
+}  // namespace bibseq
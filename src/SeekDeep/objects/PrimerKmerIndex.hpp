@@ -0,0 +1,72 @@
+#pragma once
+
+/*
+ * PrimerKmerIndex.hpp
+ *
+ *  Created on: Mar 8, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+#include "SeekDeep/objects/PrimersAndMids.hpp"
+#include "SeekDeep/objects/PackedSeq.hpp"
+
+namespace bibseq {
+
+/**@brief An index of the kmers in the forward and reverse primers of the targets in an id file
+ *
+ * Used to shortlist which primers are worth aligning to the start of a read, primers with no kmers made of only A,C,G,T
+ * (e.g. very short or heavily degenerative primers) can't be indexed and are always put on the shortlist
+ *
+ */
+class PrimerKmerIndex {
+public:
+
+	/**@brief Build the index
+	 *
+	 * @param ids the id file targets
+	 * @param kLen the kmer length to index, has to be 32 or less
+	 */
+	PrimerKmerIndex(const PrimersAndMids & ids, uint32_t kLen);
+
+	uint32_t kLen_;
+	VecStr targetNames_;
+	uint32_t maxPrimerLen_ = 0;
+	/**@brief bases past the primer length to search, to allow for indels
+	 *
+	 */
+	uint32_t windowPadding_ = 5;
+
+	/**@brief Get the targets whose forward primer shares a kmer with the start of seq
+	 *
+	 * @param seq the sequence to search
+	 * @param start the farthest into seq the primer can start
+	 * @return the positions in targetNames_ of the candidate targets, sorted
+	 */
+	std::vector<uint32_t> shortlistForward(const std::string & seq,
+			uint32_t start) const;
+
+	/**@brief Get the targets whose reverse primer shares a kmer with the start of seq
+	 *
+	 * @param seq the sequence to search
+	 * @param start the farthest into seq the primer can start
+	 * @return the positions in targetNames_ of the candidate targets, sorted
+	 */
+	std::vector<uint32_t> shortlistReverse(const std::string & seq,
+			uint32_t start) const;
+
+private:
+	std::unordered_map<uint64_t, std::vector<uint32_t>> forwardIndex_;
+	std::unordered_map<uint64_t, std::vector<uint32_t>> reverseIndex_;
+	std::vector<uint32_t> forwardAlwaysCheck_;
+	std::vector<uint32_t> reverseAlwaysCheck_;
+
+	uint32_t indexPrimer(const std::string & primer, uint32_t targetPos,
+			std::unordered_map<uint64_t, std::vector<uint32_t>> & index);
+
+	std::vector<uint32_t> shortlist(const std::string & seq, uint32_t start,
+			const std::unordered_map<uint64_t, std::vector<uint32_t>> & index,
+			const std::vector<uint32_t> & alwaysCheck) const;
+};
+
+}  // namespace bibseq
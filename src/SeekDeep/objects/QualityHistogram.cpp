@@ -0,0 +1,140 @@
+/*
+ * QualityHistogram.cpp
+ *
+ *  Created on: Mar 23, 2017
+ *      Author: nick
+ */
+
+#include "QualityHistogram.hpp"
+
+namespace bibseq {
+
+QualityHistogram::QualityHistogram(uint32_t maxQual) :
+		bins_(maxQual + 1) {
+}
+
+void QualityHistogram::reset(uint32_t len) {
+	len_ = len;
+	total_ = 0;
+	counts_.assign(static_cast<uint64_t>(len_) * bins_, 0);
+}
+
+void QualityHistogram::grow(uint32_t maxQual) {
+	uint32_t newBins = maxQual + 1;
+	std::vector<uint32_t> newCounts(static_cast<uint64_t>(len_) * newBins, 0);
+	for (uint32_t pos = 0; pos < len_; ++pos) {
+		std::copy(counts_.begin() + static_cast<uint64_t>(pos) * bins_,
+				counts_.begin() + static_cast<uint64_t>(pos + 1) * bins_,
+				newCounts.begin() + static_cast<uint64_t>(pos) * newBins);
+	}
+	counts_.swap(newCounts);
+	bins_ = newBins;
+}
+
+void QualityHistogram::add(const std::vector<uint32_t> & quals) {
+	if (quals.size() != len_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: quality length, " << quals.size()
+				<< ", doesn't match the histogram length, " << len_ << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	for (uint32_t pos = 0; pos < len_; ++pos) {
+		if (quals[pos] >= bins_) {
+			grow(*std::max_element(quals.begin(), quals.end()));
+		}
+		++counts_[static_cast<uint64_t>(pos) * bins_ + quals[pos]];
+	}
+	++total_;
+}
+
+uint32_t QualityHistogram::size() const {
+	return len_;
+}
+
+uint64_t QualityHistogram::total() const {
+	return total_;
+}
+
+void QualityHistogram::checkPos(uint32_t pos,
+		const std::string & funcName) const {
+	if (pos >= len_) {
+		std::stringstream ss;
+		ss << funcName << ", error: pos, " << pos << ", is out of range, size is "
+				<< len_ << "\n";
+		throw std::out_of_range { ss.str() };
+	}
+	if (0 == total_) {
+		std::stringstream ss;
+		ss << funcName << ", error: no qualities have been added" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+}
+
+uint32_t QualityHistogram::nthQual(uint32_t pos, uint64_t nth) const {
+	auto row = counts_.begin() + static_cast<uint64_t>(pos) * bins_;
+	uint64_t seen = 0;
+	for (uint32_t qual = 0; qual < bins_; ++qual) {
+		seen += row[qual];
+		if (seen > nth) {
+			return qual;
+		}
+	}
+	return bins_ - 1;
+}
+
+uint32_t QualityHistogram::median(uint32_t pos) const {
+	checkPos(pos, __PRETTY_FUNCTION__);
+	if (0 == total_ % 2) {
+		return (nthQual(pos, total_ / 2 - 1) + nthQual(pos, total_ / 2)) / 2;
+	}
+	return nthQual(pos, total_ / 2);
+}
+
+uint32_t QualityHistogram::mean(uint32_t pos) const {
+	checkPos(pos, __PRETTY_FUNCTION__);
+	auto row = counts_.begin() + static_cast<uint64_t>(pos) * bins_;
+	uint64_t sum = 0;
+	for (uint32_t qual = 0; qual < bins_; ++qual) {
+		sum += static_cast<uint64_t>(qual) * row[qual];
+	}
+	return sum / total_;
+}
+
+uint32_t QualityHistogram::min(uint32_t pos) const {
+	checkPos(pos, __PRETTY_FUNCTION__);
+	return nthQual(pos, 0);
+}
+
+uint32_t QualityHistogram::max(uint32_t pos) const {
+	checkPos(pos, __PRETTY_FUNCTION__);
+	return nthQual(pos, total_ - 1);
+}
+
+bool QualityHistogram::handlesQualRep(const std::string & qualRep) {
+	return "median" == qualRep || "average" == qualRep || "worst" == qualRep
+			|| "bestQual" == qualRep;
+}
+
+void QualityHistogram::setQualities(const std::string & qualRep,
+		std::vector<uint32_t> & quals) const {
+	if (!handlesQualRep(qualRep)) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: unrecognized qualRep: " << qualRep
+				<< ", options are median, average, worst or bestQual" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	quals.resize(len_);
+	for (uint32_t pos = 0; pos < len_; ++pos) {
+		if ("median" == qualRep) {
+			quals[pos] = median(pos);
+		} else if ("average" == qualRep) {
+			quals[pos] = mean(pos);
+		} else if ("worst" == qualRep) {
+			quals[pos] = min(pos);
+		} else {
+			quals[pos] = max(pos);
+		}
+	}
+}
+
+}  // namespace bibseq
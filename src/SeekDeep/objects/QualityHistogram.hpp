@@ -0,0 +1,74 @@
+#pragma once
+
+/*
+ * QualityHistogram.hpp
+ *
+ *  Created on: Mar 23, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+
+namespace bibseq {
+
+/**@brief Counts of each quality score at each position of a set of same length quality vectors, so the median, mean, min and max
+ * qualities of each position can be had without keeping all the quality vectors
+ *
+ * Starts with bins for qualities 0 to 60 and grows if a higher quality is added
+ *
+ */
+class QualityHistogram {
+public:
+	QualityHistogram(uint32_t maxQual = 60);
+
+	/**@brief clear the counts and set the length of the quality vectors to be added
+	 *
+	 * @param len the length
+	 */
+	void reset(uint32_t len);
+
+	void add(const std::vector<uint32_t> & quals);
+
+	uint32_t size() const;
+	uint64_t total() const;
+
+	/**@brief the median quality at pos, with an even number of qualities the middle two are averaged and rounded down
+	 *
+	 */
+	uint32_t median(uint32_t pos) const;
+	/**@brief the mean quality at pos, rounded down
+	 *
+	 */
+	uint32_t mean(uint32_t pos) const;
+	uint32_t min(uint32_t pos) const;
+	uint32_t max(uint32_t pos) const;
+
+	/**@brief set quals to the median, average, worst (min) or bestQual (max) at each position
+	 *
+	 * @param qualRep which quality to use
+	 * @param quals the qualities to set
+	 */
+	void setQualities(const std::string & qualRep,
+			std::vector<uint32_t> & quals) const;
+
+	/**@brief whether qualRep is one setQualities() can do
+	 *
+	 */
+	static bool handlesQualRep(const std::string & qualRep);
+
+private:
+	uint32_t len_ = 0;
+	uint32_t bins_;
+	uint64_t total_ = 0;
+	//len_ rows of bins_ counts
+	std::vector<uint32_t> counts_;
+
+	void grow(uint32_t maxQual);
+	/**@brief the quality of the nth (0 based) lowest quality at pos
+	 *
+	 */
+	uint32_t nthQual(uint32_t pos, uint64_t nth) const;
+	void checkPos(uint32_t pos, const std::string & funcName) const;
+};
+
+}  // namespace bibseq
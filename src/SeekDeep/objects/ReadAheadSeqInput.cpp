@@ -0,0 +1,350 @@
+/*
+ * ReadAheadSeqInput.cpp
+ *
+ *  Created on: Mar 21, 2017
+ *      Author: nick
+ */
+
+#include "ReadAheadSeqInput.hpp"
+
+namespace bibseq {
+
+std::string ReadAheadSeqInput::TextView::str() const {
+	if (nullptr == data_) {
+		return std::string();
+	}
+	return std::string(data_, size_);
+}
+
+ReadAheadSeqInput::ReadAheadSeqInput(const SeqIOOptions & opts,
+		uint64_t bufferSize, uint32_t numBuffers) :
+		opts_(opts), bufferSize_(bufferSize), numBuffers_(numBuffers) {
+	if (!canReadAhead(opts_)) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: can only read ahead on fasta or fastq input, not "
+				<< opts_.firstName_ << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	if (0 == bufferSize_ || numBuffers_ < 2) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: need at least 2 buffers of at least 1 byte, not "
+				<< numBuffers_ << " of " << bufferSize_ << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+}
+
+ReadAheadSeqInput::~ReadAheadSeqInput() {
+	closeIn();
+}
+
+bool ReadAheadSeqInput::canReadAhead(const SeqIOOptions & opts) {
+	return SeqIOOptions::inFormats::FASTQ == opts.inFormat_
+			|| SeqIOOptions::inFormats::FASTQGZ == opts.inFormat_
+			|| SeqIOOptions::inFormats::FASTA == opts.inFormat_
+			|| SeqIOOptions::inFormats::FASTAGZ == opts.inFormat_;
+}
+
+void ReadAheadSeqInput::openIn() {
+	if (inOpen()) {
+		return;
+	}
+	//gzread reads plain files as is and gzip files with several members (e.g. bgzf) all the way through
+	file_ = gzopen(opts_.firstName_.string().c_str(), "rb");
+	if (nullptr == file_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: couldn't open " << opts_.firstName_
+				<< "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	gzbuffer(file_, 256 * 1024);
+	buffers_.assign(numBuffers_, std::vector<char>(bufferSize_));
+	bufferFills_.assign(numBuffers_, 0);
+	filledBuffers_ = 0;
+	readAheadPos_ = 0;
+	readAheadDone_ = false;
+	stop_ = false;
+	readAheadError_.clear();
+	stats_ = Stats();
+	haveBuffer_ = false;
+	parsePos_ = 0;
+	bufferPos_ = 0;
+	pendingLines_ = 0;
+	haveNextHeader_ = false;
+	readAheadThread_ = std::thread([this]() {readAhead();});
+}
+
+void ReadAheadSeqInput::closeIn() {
+	if (!inOpen()) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mut_);
+		stop_ = true;
+	}
+	bufferFreed_.notify_all();
+	readAheadThread_.join();
+	gzclose(file_);
+	file_ = nullptr;
+	buffers_.clear();
+}
+
+bool ReadAheadSeqInput::inOpen() const {
+	return nullptr != file_;
+}
+
+ReadAheadSeqInput::Stats ReadAheadSeqInput::getStats() const {
+	std::lock_guard<std::mutex> lock(mut_);
+	return stats_;
+}
+
+void ReadAheadSeqInput::readAhead() {
+	while (true) {
+		uint32_t fillPos = 0;
+		{
+			std::unique_lock<std::mutex> lock(mut_);
+			if (!stop_ && filledBuffers_ == numBuffers_) {
+				++stats_.readAheadWaits_;
+				bufferFreed_.wait(lock, [this]() {return stop_ || filledBuffers_ < numBuffers_;});
+			}
+			if (stop_) {
+				return;
+			}
+			fillPos = readAheadPos_;
+		}
+		//the buffer at fillPos isn't being parsed so it can be filled without the lock
+		auto & buffer = buffers_[fillPos];
+		uint64_t filled = 0;
+		std::string error;
+		while (filled < bufferSize_) {
+			int bytes = gzread(file_, buffer.data() + filled,
+					static_cast<unsigned>(std::min<uint64_t>(bufferSize_ - filled,
+							std::numeric_limits<int32_t>::max())));
+			if (bytes < 0) {
+				int errnum = 0;
+				error = gzerror(file_, &errnum);
+				break;
+			}
+			if (0 == bytes) {
+				break;
+			}
+			filled += bytes;
+		}
+		{
+			std::lock_guard<std::mutex> lock(mut_);
+			if (filled > 0) {
+				bufferFills_[fillPos] = filled;
+				++filledBuffers_;
+				readAheadPos_ = (readAheadPos_ + 1) % numBuffers_;
+				stats_.bytesRead_ += filled;
+			}
+			if (filled < bufferSize_) {
+				readAheadDone_ = true;
+				readAheadError_ = error;
+			}
+		}
+		bufferFilled_.notify_one();
+		if (filled < bufferSize_) {
+			return;
+		}
+	}
+}
+
+bool ReadAheadSeqInput::inCurrentBuffer(const TextView & view) const {
+	if (!haveBuffer_ || nullptr == view.data_) {
+		return false;
+	}
+	const char * start = buffers_[parsePos_].data();
+	return view.data_ >= start && view.data_ <= start + bufferSize_;
+}
+
+bool ReadAheadSeqInput::nextBuffer() {
+	//the lines of the record already read have to be copied out before their buffer can be re-filled
+	for (uint32_t linePos = 0; linePos < pendingLines_; ++linePos) {
+		if (inCurrentBuffer(lines_[linePos])) {
+			spills_[linePos].assign(lines_[linePos].data_, lines_[linePos].size_);
+			lines_[linePos].data_ = spills_[linePos].data();
+		}
+	}
+	std::unique_lock<std::mutex> lock(mut_);
+	if (haveBuffer_) {
+		haveBuffer_ = false;
+		--filledBuffers_;
+		parsePos_ = (parsePos_ + 1) % numBuffers_;
+		bufferFreed_.notify_one();
+	}
+	if (0 == filledBuffers_ && !readAheadDone_) {
+		++stats_.parserWaits_;
+		bufferFilled_.wait(lock, [this]() {return 0 < filledBuffers_ || readAheadDone_;});
+	}
+	if (0 == filledBuffers_) {
+		if (!readAheadError_.empty()) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error: reading " << opts_.firstName_
+					<< " failed, " << readAheadError_ << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		return false;
+	}
+	haveBuffer_ = true;
+	bufferPos_ = 0;
+	return true;
+}
+
+bool ReadAheadSeqInput::nextLine(uint32_t linePos) {
+	auto & line = lines_[linePos];
+	auto & spill = spills_[linePos];
+	bool spilled = false;
+	while (true) {
+		if (!haveBuffer_ || bufferPos_ >= bufferFills_[parsePos_]) {
+			pendingLines_ = linePos;
+			if (!nextBuffer()) {
+				if (!spilled) {
+					return false;
+				}
+				//last line without a new line
+				line.data_ = spill.data();
+				line.size_ = spill.size();
+				break;
+			}
+		}
+		const char * start = buffers_[parsePos_].data() + bufferPos_;
+		const char * end = buffers_[parsePos_].data() + bufferFills_[parsePos_];
+		auto newLine = static_cast<const char *>(std::memchr(start, '\n', end - start));
+		if (nullptr == newLine) {
+			//the line goes into the next buffer
+			if (!spilled) {
+				spill.clear();
+				spilled = true;
+			}
+			spill.append(start, end);
+			bufferPos_ = bufferFills_[parsePos_];
+			continue;
+		}
+		bufferPos_ += newLine - start + 1;
+		if (spilled) {
+			spill.append(start, newLine);
+			line.data_ = spill.data();
+			line.size_ = spill.size();
+		} else {
+			line.data_ = start;
+			line.size_ = newLine - start;
+		}
+		break;
+	}
+	if (line.size_ > 0 && '\r' == line.data_[line.size_ - 1]) {
+		--line.size_;
+	}
+	return true;
+}
+
+bool ReadAheadSeqInput::readNextRecord(RecordView & record) {
+	if (!inOpen()) {
+		openIn();
+	}
+	if (haveNextHeader_) {
+		//the header was read at the end of the last fasta record
+		haveNextHeader_ = false;
+		if (lines_[2].data_ == spills_[2].data()) {
+			spills_[0].swap(spills_[2]);
+			lines_[0].data_ = spills_[0].data();
+			lines_[0].size_ = lines_[2].size_;
+		} else {
+			lines_[0] = lines_[2];
+		}
+	} else {
+		do {
+			if (!nextLine(0)) {
+				return false;
+			}
+		} while (0 == lines_[0].size_);
+	}
+	if ('@' == lines_[0].data_[0]) {
+		if (!nextLine(1) || !nextLine(2) || !nextLine(3)) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error: " << opts_.firstName_
+					<< " ended in the middle of the record for " << lines_[0].str() << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		if (lines_[3].size_ != lines_[1].size_) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error: in " << opts_.firstName_
+					<< " the quality length doesn't match the sequence length for "
+					<< lines_[0].str() << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		record.seq_ = lines_[1];
+		record.qual_ = lines_[3];
+	} else if ('>' == lines_[0].data_[0]) {
+		lines_[1] = TextView();
+		uint32_t seqLines = 0;
+		while (nextLine(2)) {
+			if (lines_[2].size_ > 0 && '>' == lines_[2].data_[0]) {
+				haveNextHeader_ = true;
+				break;
+			}
+			if (0 == seqLines) {
+				//single line sequences aren't copied
+				if (lines_[2].data_ == spills_[2].data()) {
+					spills_[1].swap(spills_[2]);
+					lines_[1].data_ = spills_[1].data();
+					lines_[1].size_ = lines_[2].size_;
+				} else {
+					lines_[1] = lines_[2];
+				}
+			} else {
+				if (1 == seqLines) {
+					fastaSeq_.assign(lines_[1].data_, lines_[1].size_);
+				}
+				fastaSeq_.append(lines_[2].data_, lines_[2].size_);
+				lines_[1].data_ = fastaSeq_.data();
+				lines_[1].size_ = fastaSeq_.size();
+			}
+			++seqLines;
+		}
+		record.seq_ = lines_[1];
+		record.qual_ = TextView();
+	} else {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: in " << opts_.firstName_
+				<< " expected a record to start with @ or > but found " << lines_[0].str()
+				<< "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	record.name_.data_ = lines_[0].data_ + 1;
+	record.name_.size_ = lines_[0].size_ - 1;
+	return true;
+}
+
+void ReadAheadSeqInput::materialize(const RecordView & record,
+		seqInfo & read) const {
+	read.name_.assign(record.name_.data_, record.name_.size_);
+	read.seq_.assign(record.seq_.data_, record.seq_.size_);
+	if (0 == record.qual_.size_) {
+		//fasta gets the same default quality seqInfo gives it
+		read.qual_.assign(read.seq_.size(), 40);
+	} else {
+		read.qual_.resize(record.qual_.size_);
+		for (uint64_t pos = 0; pos < record.qual_.size_; ++pos) {
+			read.qual_[pos] = static_cast<uint32_t>(record.qual_.data_[pos]) - qualOffset_;
+		}
+	}
+	read.cnt_ = 1;
+	read.frac_ = 0;
+	read.on_ = true;
+	if ("remove" == opts_.lowerCaseBases_) {
+		read.removeLowerCase();
+	} else if ("upper" == opts_.lowerCaseBases_) {
+		stringToUpper(read.seq_);
+	}
+	read.processRead(opts_.processed_);
+}
+
+bool ReadAheadSeqInput::readNextRead(seqInfo & read) {
+	if (!readNextRecord(record_)) {
+		return false;
+	}
+	materialize(record_, read);
+	return true;
+}
+
+}  // namespace bibseq
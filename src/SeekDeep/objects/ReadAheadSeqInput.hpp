@@ -0,0 +1,180 @@
+#pragma once
+
+/*
+ * ReadAheadSeqInput.hpp
+ *
+ *  Created on: Mar 21, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+#include <zlib.h>
+
+namespace bibseq {
+
+/**@brief Read fasta or fastq reads, plain or gzipped, with a background thread reading and decompressing the file into a ring of
+ * large buffers while the reads are parsed out of the filled buffers on the calling thread
+ *
+ * Records can be read as views into the buffers so a read only has to be copied out if it's going to be used, only lines that
+ * span two buffers (and multi-line fasta sequences) are copied and into strings that are kept between records
+ *
+ */
+class ReadAheadSeqInput {
+public:
+	ReadAheadSeqInput(const SeqIOOptions & opts,
+			uint64_t bufferSize = 4 * 1024 * 1024, uint32_t numBuffers = 4);
+	~ReadAheadSeqInput();
+
+	struct Stats {
+		//bytes after decompression
+		uint64_t bytesRead_ = 0;
+		//number of times the parser had to wait on the read ahead thread
+		uint64_t parserWaits_ = 0;
+		//number of times the read ahead thread had to wait for a free buffer
+		uint64_t readAheadWaits_ = 0;
+	};
+
+	/**@brief A piece of text that isn't owned
+	 *
+	 */
+	struct TextView {
+		const char * data_ = nullptr;
+		uint64_t size_ = 0;
+
+		std::string str() const;
+	};
+
+	/**@brief A record as views into the read ahead buffers, only good until the next record is read
+	 *
+	 */
+	struct RecordView {
+		//without the @ or >
+		TextView name_;
+		TextView seq_;
+		//quality characters, empty for fasta
+		TextView qual_;
+	};
+
+	SeqIOOptions opts_;
+	const uint64_t bufferSize_;
+	const uint32_t numBuffers_;
+	//fastq quality characters are decoded with the offset SeqInput decodes them with
+	const uint32_t qualOffset_ = SangerQualOffset;
+
+	void openIn();
+	void closeIn();
+	bool inOpen() const;
+
+	Stats getStats() const;
+
+	/**@brief Get the next record without copying it out of the buffers
+	 *
+	 * @param record the record to set, good until the next call to readNextRecord() or readNextRead()
+	 * @return false once the file is done
+	 */
+	bool readNextRecord(RecordView & record);
+
+	/**@brief Set read to record, re-using the read's strings, and handle lower case bases and processed names like SeqInput does
+	 *
+	 * @param record the record
+	 * @param read the read to set
+	 */
+	void materialize(const RecordView & record, seqInfo & read) const;
+
+	bool readNextRead(seqInfo & read);
+
+	template<typename T>
+	bool readNextRead(T & read) {
+		if (!readNextRead(info_)) {
+			return false;
+		}
+		read = T(info_);
+		return true;
+	}
+
+	template<typename T>
+	bool readNextRead(std::shared_ptr<T> & read) {
+		if (!readNextRead(info_)) {
+			return false;
+		}
+		//re-use the read if nothing else is holding on to it
+		if (nullptr != read && 1 == read.use_count()) {
+			*read = T(info_);
+		} else {
+			read = std::make_shared<T>(info_);
+		}
+		return true;
+	}
+
+	template<typename T>
+	std::vector<T> readAllReads() {
+		std::vector<T> ret;
+		openIn();
+		T read;
+		while (readNextRead(read)) {
+			ret.emplace_back(read);
+		}
+		closeIn();
+		return ret;
+	}
+
+	/**@brief whether the input in opts is a plain or gzipped fasta or fastq file that this can read
+	 *
+	 */
+	static bool canReadAhead(const SeqIOOptions & opts);
+
+private:
+	/**@brief fill the buffers until the file is done or closeIn() is called, run on readAheadThread_
+	 *
+	 */
+	void readAhead();
+
+	/**@brief hand the current buffer back to the read ahead thread and wait for the next filled one
+	 *
+	 * @return false once the file is done
+	 */
+	bool nextBuffer();
+
+	/**@brief set lines_[linePos] to the next line, without the new line, lines spanning buffers are copied to spills_[linePos]
+	 *
+	 * @param linePos the line of the record being read, the lines before it are copied out before their buffer is handed back
+	 * @return false once the file is done
+	 */
+	bool nextLine(uint32_t linePos);
+
+	bool inCurrentBuffer(const TextView & view) const;
+
+	gzFile file_ = nullptr;
+	std::thread readAheadThread_;
+
+	std::vector<std::vector<char>> buffers_;
+	//number of bytes put in each buffer
+	std::vector<uint64_t> bufferFills_;
+	//buffers filled and not yet handed back by the parser, including the one being parsed
+	uint32_t filledBuffers_ = 0;
+	uint32_t readAheadPos_ = 0;
+	bool readAheadDone_ = false;
+	bool stop_ = false;
+	std::string readAheadError_;
+	mutable std::mutex mut_;
+	std::condition_variable bufferFilled_;
+	std::condition_variable bufferFreed_;
+	Stats stats_;
+
+	//only touched by the parsing thread
+	bool haveBuffer_ = false;
+	uint32_t parsePos_ = 0;
+	uint64_t bufferPos_ = 0;
+	//the lines of the record being read
+	std::array<TextView, 4> lines_;
+	std::array<std::string, 4> spills_;
+	uint32_t pendingLines_ = 0;
+	//a fasta header already read with the end of the previous record is in lines_[2]
+	bool haveNextHeader_ = false;
+	//multi-line fasta sequences are joined here
+	std::string fastaSeq_;
+	RecordView record_;
+	seqInfo info_;
+};
+
+}  // namespace bibseq
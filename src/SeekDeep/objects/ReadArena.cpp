@@ -0,0 +1,198 @@
+/*
+ * ReadArena.cpp
+ *
+ *  Created on: Mar 22, 2017
+ *      Author: nick
+ */
+
+#include "ReadArena.hpp"
+
+namespace bibseq {
+
+uint32_t ReadArena::add(const seqInfo & read) {
+	if (read.qual_.size() != read.seq_.size()) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: " << read.name_
+				<< " has a quality length, " << read.qual_.size()
+				<< ", that doesn't match it's sequence length, " << read.seq_.size()
+				<< "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	if (entries_.size() >= std::numeric_limits<uint32_t>::max()) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: can't hold more than "
+				<< std::numeric_limits<uint32_t>::max() << " reads" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	Entry entry;
+	entry.nameStart_ = names_.size();
+	entry.nameLen_ = read.name_.size();
+	entry.seqStart_ = seqs_.size();
+	entry.seqLen_ = read.seq_.size();
+	entry.cnt_ = read.cnt_;
+	entry.frac_ = read.frac_;
+	names_.append(read.name_);
+	seqs_.append(read.seq_);
+	for (const auto qual : read.qual_) {
+		if (qual > std::numeric_limits<uint8_t>::max()) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error: " << read.name_
+					<< " has a quality of " << qual << ", qualities have to be under "
+					<< static_cast<uint32_t>(std::numeric_limits<uint8_t>::max()) + 1
+					<< "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		quals_.emplace_back(static_cast<uint8_t>(qual));
+	}
+	entries_.emplace_back(entry);
+	return entries_.size() - 1;
+}
+
+uint32_t ReadArena::size() const {
+	return entries_.size();
+}
+
+bool ReadArena::empty() const {
+	return entries_.empty();
+}
+
+void ReadArena::checkPos(uint32_t pos, const std::string & funcName) const {
+	if (pos >= entries_.size()) {
+		std::stringstream ss;
+		ss << funcName << ", error: pos, " << pos
+				<< ", is out of range, size is " << entries_.size() << "\n";
+		throw std::out_of_range { ss.str() };
+	}
+}
+
+const ReadArena::Entry & ReadArena::getEntry(uint32_t pos) const {
+	checkPos(pos, __PRETTY_FUNCTION__);
+	return entries_[pos];
+}
+
+std::string ReadArena::getName(uint32_t pos) const {
+	const auto & entry = getEntry(pos);
+	return names_.substr(entry.nameStart_, entry.nameLen_);
+}
+
+double ReadArena::getCnt(uint32_t pos) const {
+	return getEntry(pos).cnt_;
+}
+
+bool ReadArena::nameContains(uint32_t pos, const std::string & str) const {
+	const auto & entry = getEntry(pos);
+	auto nameStart = names_.begin() + entry.nameStart_;
+	auto nameEnd = nameStart + entry.nameLen_;
+	return std::search(nameStart, nameEnd, str.begin(), str.end()) != nameEnd;
+}
+
+uint32_t ReadArena::getSeqLen(uint32_t pos) const {
+	return getEntry(pos).seqLen_;
+}
+
+void ReadArena::getSeq(uint32_t pos, std::string & seq) const {
+	const auto & entry = getEntry(pos);
+	seq.assign(seqs_, entry.seqStart_, entry.seqLen_);
+}
+
+void ReadArena::getQual(uint32_t pos, std::vector<uint32_t> & quals) const {
+	const auto & entry = getEntry(pos);
+	quals.assign(quals_.begin() + entry.seqStart_,
+			quals_.begin() + entry.seqStart_ + entry.seqLen_);
+}
+
+uint32_t ReadArena::getBaseQual(uint32_t pos, uint32_t basePos) const {
+	const auto & entry = getEntry(pos);
+	if (basePos >= entry.seqLen_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: basePos, " << basePos
+				<< ", is out of range, length is " << entry.seqLen_ << "\n";
+		throw std::out_of_range { ss.str() };
+	}
+	return quals_[entry.seqStart_ + basePos];
+}
+
+void ReadArena::getSeqInfo(uint32_t pos, seqInfo & read) const {
+	const auto & entry = getEntry(pos);
+	read.name_.assign(names_, entry.nameStart_, entry.nameLen_);
+	read.seq_.assign(seqs_, entry.seqStart_, entry.seqLen_);
+	read.qual_.assign(quals_.begin() + entry.seqStart_,
+			quals_.begin() + entry.seqStart_ + entry.seqLen_);
+	read.cnt_ = entry.cnt_;
+	read.frac_ = entry.frac_;
+	read.on_ = true;
+}
+
+seqInfo ReadArena::getSeqInfo(uint32_t pos) const {
+	seqInfo ret;
+	getSeqInfo(pos, ret);
+	return ret;
+}
+
+uint64_t ReadArena::bytesUsed() const {
+	return entries_.capacity() * sizeof(Entry) + names_.capacity()
+			+ seqs_.capacity() + quals_.capacity();
+}
+
+void ReadArena::reorder(const std::vector<uint32_t> & order) {
+	if (order.size() != entries_.size()) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: order has " << order.size()
+				<< " positions but there are " << entries_.size() << " reads" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	std::vector<uint8_t> seen(entries_.size(), 0);
+	std::vector<Entry> entries;
+	std::string names;
+	std::string seqs;
+	std::vector<uint8_t> quals;
+	entries.reserve(entries_.size());
+	names.reserve(names_.size());
+	seqs.reserve(seqs_.size());
+	quals.reserve(quals_.size());
+	for (const auto pos : order) {
+		checkPos(pos, __PRETTY_FUNCTION__);
+		if (seen[pos]) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error: pos, " << pos
+					<< ", is in order more than once" << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		seen[pos] = 1;
+		Entry entry = entries_[pos];
+		entry.nameStart_ = names.size();
+		entry.seqStart_ = seqs.size();
+		names.append(names_, entries_[pos].nameStart_, entry.nameLen_);
+		seqs.append(seqs_, entries_[pos].seqStart_, entry.seqLen_);
+		quals.insert(quals.end(), quals_.begin() + entries_[pos].seqStart_,
+				quals_.begin() + entries_[pos].seqStart_ + entry.seqLen_);
+		entries.emplace_back(entry);
+	}
+	entries_.swap(entries);
+	names_.swap(names);
+	seqs_.swap(seqs);
+	quals_.swap(quals);
+}
+
+void ReadArena::reserve(uint32_t reads, uint64_t nameBytes, uint64_t bases) {
+	entries_.reserve(reads);
+	names_.reserve(nameBytes);
+	seqs_.reserve(bases);
+	quals_.reserve(bases);
+}
+
+void ReadArena::shrinkToFit() {
+	entries_.shrink_to_fit();
+	names_.shrink_to_fit();
+	seqs_.shrink_to_fit();
+	quals_.shrink_to_fit();
+}
+
+void ReadArena::clear() {
+	entries_.clear();
+	names_.clear();
+	seqs_.clear();
+	quals_.clear();
+}
+
+}  // namespace bibseq
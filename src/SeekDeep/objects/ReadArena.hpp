@@ -0,0 +1,101 @@
+#pragma once
+
+/*
+ * ReadArena.hpp
+ *
+ *  Created on: Mar 22, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+
+namespace bibseq {
+
+/**@brief Store reads packed together, all the names in one string, all the sequences in another and the qualities as one byte each,
+ * with reads referred to by their position rather than each read owning its own strings
+ *
+ */
+class ReadArena {
+public:
+	struct Entry {
+		uint64_t nameStart_ = 0;
+		//start of the sequence, the qualities start at the same position
+		uint64_t seqStart_ = 0;
+		uint32_t nameLen_ = 0;
+		uint32_t seqLen_ = 0;
+		double cnt_ = 1;
+		double frac_ = 0;
+	};
+
+	/**@brief add a read
+	 *
+	 * @param read the read to add
+	 * @return the position of the read
+	 */
+	uint32_t add(const seqInfo & read);
+
+	template<typename T>
+	uint32_t add(const T & read) {
+		return add(read.seqBase_);
+	}
+
+	template<typename T>
+	uint32_t add(const std::shared_ptr<T> & read) {
+		return add(*read);
+	}
+
+	uint32_t size() const;
+	bool empty() const;
+
+	const Entry & getEntry(uint32_t pos) const;
+	std::string getName(uint32_t pos) const;
+	double getCnt(uint32_t pos) const;
+	bool nameContains(uint32_t pos, const std::string & str) const;
+	uint32_t getSeqLen(uint32_t pos) const;
+
+	/**@brief set seq to the sequence at pos, re-using seq
+	 *
+	 */
+	void getSeq(uint32_t pos, std::string & seq) const;
+	/**@brief set quals to the qualities at pos, re-using quals
+	 *
+	 */
+	void getQual(uint32_t pos, std::vector<uint32_t> & quals) const;
+	/**@brief the quality of the base at basePos of the read at pos
+	 *
+	 */
+	uint32_t getBaseQual(uint32_t pos, uint32_t basePos) const;
+
+	/**@brief set read to the read at pos, re-using read's strings
+	 *
+	 * @param pos the position of the read
+	 * @param read the read to set
+	 */
+	void getSeqInfo(uint32_t pos, seqInfo & read) const;
+	seqInfo getSeqInfo(uint32_t pos) const;
+
+	/**@brief the bytes used to hold the reads
+	 *
+	 */
+	uint64_t bytesUsed() const;
+
+	/**@brief put the reads in the order given, the read at order[0] ends up at position 0 and so on
+	 *
+	 * @param order positions of every read, each once
+	 */
+	void reorder(const std::vector<uint32_t> & order);
+
+	void reserve(uint32_t reads, uint64_t nameBytes, uint64_t bases);
+	void shrinkToFit();
+	void clear();
+
+private:
+	std::vector<Entry> entries_;
+	std::string names_;
+	std::string seqs_;
+	std::vector<uint8_t> quals_;
+
+	void checkPos(uint32_t pos, const std::string & funcName) const;
+};
+
+}  // namespace bibseq
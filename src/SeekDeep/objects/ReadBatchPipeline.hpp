@@ -0,0 +1,261 @@
+#pragma once
+
+/*
+ * ReadBatchPipeline.hpp
+ *
+ *  Created on: Mar 2, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+#include <condition_variable>
+#include <exception>
+
+namespace bibseq {
+
+/**@brief A reader -> workers -> ordered writer pipeline for processing reads in batches
+ *
+ * One thread fills batches of reads, numThreads_ threads process them and the calling thread
+ * hands the processed reads to the write function in the order they were read in so output is the same
+ * as processing the reads serially, with one thread the three steps are just called one after the other
+ *
+ */
+template<typename READ, typename RESULT>
+class ReadBatchPipeline {
+public:
+	typedef std::function<bool(READ &)> ReadFunc;
+	typedef std::function<void(uint32_t, READ &, RESULT &)> WorkFunc;
+	typedef std::function<void(READ &, RESULT &)> WriteFunc;
+
+	struct Batch {
+		uint64_t id_ = 0;
+		uint32_t size_ = 0;
+		std::vector<READ> reads_;
+		std::vector<RESULT> results_;
+	};
+
+	ReadBatchPipeline(uint32_t numThreads, uint32_t batchSize = 1000,
+			uint32_t batchesPerThread = 4) :
+			numThreads_(numThreads), batchSize_(batchSize), batchesPerThread_(
+					batchesPerThread) {
+		if (0 == numThreads_) {
+			numThreads_ = 1;
+		}
+		if (0 == batchSize_) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error: batchSize can't be 0" << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		if (0 == batchesPerThread_) {
+			batchesPerThread_ = 1;
+		}
+	}
+
+	uint32_t numThreads_;
+	uint32_t batchSize_;
+	uint32_t batchesPerThread_;
+	/**@brief how to create a read to be filled, for pointer types this should allocate the object
+	 *
+	 */
+	std::function<READ()> readFactory_ = []() {return READ {};};
+
+	uint64_t readsProcessed_ = 0;
+
+	void run(const ReadFunc & readFunc, const WorkFunc & workFunc,
+			const WriteFunc & writeFunc) {
+		readsProcessed_ = 0;
+		if (numThreads_ <= 1) {
+			READ read = readFactory_();
+			RESULT result;
+			while (readFunc(read)) {
+				result = RESULT { };
+				workFunc(0, read, result);
+				writeFunc(read, result);
+				++readsProcessed_;
+			}
+			return;
+		}
+		runThreaded(readFunc, workFunc, writeFunc);
+	}
+
+private:
+
+	std::mutex mut_;
+	std::condition_variable freeCv_;
+	std::condition_variable workCv_;
+	std::condition_variable doneCv_;
+
+	std::vector<std::unique_ptr<Batch>> freeBatches_;
+	std::deque<std::unique_ptr<Batch>> workBatches_;
+	std::map<uint64_t, std::unique_ptr<Batch>> doneBatches_;
+	bool inputDone_ = false;
+	bool failed_ = false;
+	uint64_t totalBatches_ = 0;
+	std::exception_ptr exception_;
+
+	void setFailed(std::exception_ptr e) {
+		{
+			std::lock_guard<std::mutex> lock(mut_);
+			if (!failed_) {
+				exception_ = e;
+			}
+			failed_ = true;
+		}
+		freeCv_.notify_all();
+		workCv_.notify_all();
+		doneCv_.notify_all();
+	}
+
+	void readBatches(const ReadFunc & readFunc) {
+		try {
+			uint64_t batchId = 0;
+			bool moreReads = true;
+			while (moreReads) {
+				std::unique_ptr<Batch> batch;
+				{
+					std::unique_lock<std::mutex> lock(mut_);
+					freeCv_.wait(lock, [this]() {return failed_ || !freeBatches_.empty();});
+					if (failed_) {
+						return;
+					}
+					batch = std::move(freeBatches_.back());
+					freeBatches_.pop_back();
+				}
+				batch->id_ = batchId;
+				batch->size_ = 0;
+				while (batch->size_ < batchSize_) {
+					if (!readFunc(batch->reads_[batch->size_])) {
+						moreReads = false;
+						break;
+					}
+					++batch->size_;
+				}
+				{
+					std::lock_guard<std::mutex> lock(mut_);
+					if (batch->size_ > 0) {
+						workBatches_.emplace_back(std::move(batch));
+						++batchId;
+					} else {
+						freeBatches_.emplace_back(std::move(batch));
+					}
+					if (!moreReads) {
+						inputDone_ = true;
+						totalBatches_ = batchId;
+					}
+				}
+				workCv_.notify_one();
+			}
+			workCv_.notify_all();
+			doneCv_.notify_all();
+		} catch (...) {
+			setFailed(std::current_exception());
+		}
+	}
+
+	void processBatches(uint32_t threadNum, const WorkFunc & workFunc) {
+		try {
+			while (true) {
+				std::unique_ptr<Batch> batch;
+				{
+					std::unique_lock<std::mutex> lock(mut_);
+					workCv_.wait(lock,
+							[this]() {return failed_ || inputDone_ || !workBatches_.empty();});
+					if (failed_) {
+						return;
+					}
+					if (workBatches_.empty()) {
+						//input is done and there's nothing left to do
+						return;
+					}
+					batch = std::move(workBatches_.front());
+					workBatches_.pop_front();
+				}
+				for (uint32_t pos = 0; pos < batch->size_; ++pos) {
+					batch->results_[pos] = RESULT { };
+					workFunc(threadNum, batch->reads_[pos], batch->results_[pos]);
+				}
+				{
+					std::lock_guard<std::mutex> lock(mut_);
+					uint64_t batchId = batch->id_;
+					doneBatches_.emplace(batchId, std::move(batch));
+				}
+				doneCv_.notify_one();
+			}
+		} catch (...) {
+			setFailed(std::current_exception());
+		}
+	}
+
+	void runThreaded(const ReadFunc & readFunc, const WorkFunc & workFunc,
+			const WriteFunc & writeFunc) {
+		freeBatches_.clear();
+		workBatches_.clear();
+		doneBatches_.clear();
+		inputDone_ = false;
+		failed_ = false;
+		totalBatches_ = 0;
+		exception_ = nullptr;
+		for (uint32_t batchNum = 0; batchNum < numThreads_ * batchesPerThread_;
+				++batchNum) {
+			auto batch = std::make_unique<Batch>();
+			for (uint32_t pos = 0; pos < batchSize_; ++pos) {
+				batch->reads_.emplace_back(readFactory_());
+			}
+			batch->results_.resize(batchSize_);
+			freeBatches_.emplace_back(std::move(batch));
+		}
+
+		std::thread readerThread([this, &readFunc]() {readBatches(readFunc);});
+		std::vector<std::thread> threads;
+		for (uint32_t t = 0; t < numThreads_; ++t) {
+			threads.emplace_back(
+					std::thread([this, t, &workFunc]() {processBatches(t, workFunc);}));
+		}
+		//write out in the order read in
+		uint64_t nextBatchId = 0;
+		try {
+			while (true) {
+				std::unique_ptr<Batch> batch;
+				{
+					std::unique_lock<std::mutex> lock(mut_);
+					doneCv_.wait(lock,
+							[this, &nextBatchId]() {
+								return failed_ || doneBatches_.end() != doneBatches_.find(nextBatchId) ||
+								(inputDone_ && nextBatchId >= totalBatches_);
+							});
+					if (failed_) {
+						break;
+					}
+					auto search = doneBatches_.find(nextBatchId);
+					if (doneBatches_.end() == search) {
+						//all batches written
+						break;
+					}
+					batch = std::move(search->second);
+					doneBatches_.erase(search);
+				}
+				for (uint32_t pos = 0; pos < batch->size_; ++pos) {
+					writeFunc(batch->reads_[pos], batch->results_[pos]);
+				}
+				readsProcessed_ += batch->size_;
+				++nextBatchId;
+				{
+					std::lock_guard<std::mutex> lock(mut_);
+					freeBatches_.emplace_back(std::move(batch));
+				}
+				freeCv_.notify_one();
+			}
+		} catch (...) {
+			setFailed(std::current_exception());
+		}
+		readerThread.join();
+		for (auto & t : threads) {
+			t.join();
+		}
+		if (nullptr != exception_) {
+			std::rethrow_exception(exception_);
+		}
+	}
+};
+
+}  // namespace bibseq
@@ -0,0 +1,159 @@
+/*
+ * ShortlistPrimerDeterminator.cpp
+ *
+ *  Created on: Mar 8, 2017
+ *      Author: nick
+ */
+
+#include "ShortlistPrimerDeterminator.hpp"
+
+namespace bibseq {
+
+void ShortlistPrimerDeterminator::Stats::addOtherStats(const Stats & other) {
+	lookUps_ += other.lookUps_;
+	candidates_ += other.candidates_;
+	screenedOut_ += other.screenedOut_;
+	emptyShortlists_ += other.emptyShortlists_;
+	checked_ += other.checked_;
+	checkedRecognized_ += other.checkedRecognized_;
+	shortlistMissed_ += other.shortlistMissed_;
+}
+
+ShortlistPrimerDeterminator::ShortlistPrimerDeterminator(
+		const table & primerTable, PrimerDeterminator & fullDeterminator,
+		uint32_t checkEvery, const PrimerKmerIndex * kmerIndex,
+		const PrimerEditScreen * forwardScreen,
+		const PrimerEditScreen * reverseScreen) :
+		primerTable_(primerTable), fullDeterminator_(fullDeterminator), checkEvery_(
+				checkEvery), kmerIndex_(kmerIndex), forwardScreen_(forwardScreen), reverseScreen_(
+				reverseScreen) {
+	targetNames_ = primerTable_.getColumn("geneName");
+	bib::sort(targetNames_);
+	targetNames_.erase(std::unique(targetNames_.begin(), targetNames_.end()),
+			targetNames_.end());
+	if (nullptr != kmerIndex_ && kmerIndex_->targetNames_ != targetNames_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__
+				<< ", error: kmer index targets don't match the primer table targets"
+				<< "\n";
+		ss << "index: " << bib::conToStr(kmerIndex_->targetNames_, ",") << "\n";
+		ss << "table: " << bib::conToStr(targetNames_, ",") << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	if (nullptr != forwardScreen_ && forwardScreen_->primers_.size() != targetNames_.size()) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__
+				<< ", error: forward screen should have one primer per target, has "
+				<< forwardScreen_->primers_.size() << ", expected "
+				<< targetNames_.size() << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	if (nullptr != reverseScreen_ && reverseScreen_->primers_.size() != 2 * targetNames_.size()) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__
+				<< ", error: reverse screen should have two primers per target, has "
+				<< reverseScreen_->primers_.size() << ", expected "
+				<< 2 * targetNames_.size() << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	for (uint32_t targetPos = 0; targetPos < targetNames_.size(); ++targetPos) {
+		allTargets_.emplace_back(targetPos);
+	}
+}
+
+PrimerDeterminator & ShortlistPrimerDeterminator::getDeterminator(
+		const std::vector<uint32_t> & candidates) {
+	std::string key = bib::conToStr(candidates, ",");
+	auto search = determinators_.find(key);
+	if (determinators_.end() != search) {
+		return *search->second;
+	}
+	if (determinators_.size() >= maxCachedDeterminators_) {
+		determinators_.clear();
+	}
+	table candidateTable(primerTable_.columnNames_);
+	auto geneNamePos = primerTable_.getColPos("geneName");
+	for (const auto & row : primerTable_.content_) {
+		auto targetPos = std::lower_bound(targetNames_.begin(),
+				targetNames_.end(), row[geneNamePos]);
+		if (targetNames_.end() != targetPos && *targetPos == row[geneNamePos]
+				&& std::binary_search(candidates.begin(), candidates.end(),
+						targetPos - targetNames_.begin())) {
+			candidateTable.content_.emplace_back(row);
+		}
+	}
+	auto emplaced = determinators_.emplace(key,
+			std::make_unique<PrimerDeterminator>(candidateTable));
+	return *emplaced.first->second;
+}
+
+void ShortlistPrimerDeterminator::screen(const std::string & seq,
+		uint32_t withinPos, const comparison & allowable, bool forward,
+		std::vector<uint32_t> & candidates) {
+	const PrimerEditScreen * editScreen = forward ? forwardScreen_ : reverseScreen_;
+	if (nullptr == editScreen || candidates.empty()) {
+		return;
+	}
+	editScreen->lowerBoundDistances(seq, withinPos, distances_);
+	uint32_t numTargets = targetNames_.size();
+	auto passEnd = std::remove_if(candidates.begin(), candidates.end(),
+			[&](uint32_t targetPos) {
+				uint16_t distance = distances_[targetPos];
+				if(!forward) {
+					//reverse primers are screened in both directions
+					distance = std::min(distance, distances_[targetPos + numTargets]);
+				}
+				return distance > PrimerEditScreen::maxDistance(allowable,
+						editScreen->primers_[targetPos].size());
+			});
+	stats_.screenedOut_ += candidates.end() - passEnd;
+	candidates.erase(passEnd, candidates.end());
+}
+
+std::vector<uint32_t> ShortlistPrimerDeterminator::shortlist(
+		const std::string & seq, uint32_t withinPos, const comparison & allowable,
+		bool forward) {
+	std::vector<uint32_t> candidates;
+	if (nullptr != kmerIndex_) {
+		candidates = forward ?
+				kmerIndex_->shortlistForward(seq, withinPos) :
+				kmerIndex_->shortlistReverse(seq, withinPos);
+	} else {
+		candidates = allTargets_;
+	}
+	screen(seq, withinPos, allowable, forward, candidates);
+	++stats_.lookUps_;
+	stats_.candidates_ += candidates.size();
+	return candidates;
+}
+
+void ShortlistPrimerDeterminator::recordCheck(const std::string & fullPrimerName,
+		const std::vector<uint32_t> & candidates) {
+	++stats_.checked_;
+	if ("unrecognized" != fullPrimerName) {
+		++stats_.checkedRecognized_;
+		auto targetPos = std::lower_bound(targetNames_.begin(),
+				targetNames_.end(), fullPrimerName);
+		if (targetNames_.end() == targetPos
+				|| !std::binary_search(candidates.begin(), candidates.end(),
+						targetPos - targetNames_.begin())) {
+			++stats_.shortlistMissed_;
+		}
+	}
+}
+
+void ShortlistPrimerDeterminator::writeStats(std::ostream & out,
+		const Stats & stats) {
+	out << "lookUps\tmeanCandidates\tscreenedOut\temptyShortlists\tchecked\tcheckedRecognized\tshortlistMissed\tshortlistMissRate" << "\n";
+	out << stats.lookUps_
+			<< "\t" << (0 == stats.lookUps_ ? 0 : static_cast<double>(stats.candidates_)/stats.lookUps_)
+			<< "\t" << stats.screenedOut_
+			<< "\t" << stats.emptyShortlists_
+			<< "\t" << stats.checked_
+			<< "\t" << stats.checkedRecognized_
+			<< "\t" << stats.shortlistMissed_
+			<< "\t" << (0 == stats.checkedRecognized_ ? 0 : static_cast<double>(stats.shortlistMissed_)/stats.checkedRecognized_)
+			<< "\n";
+}
+
+}  // namespace bibseq
@@ -0,0 +1,146 @@
+#pragma once
+
+/*
+ * ShortlistPrimerDeterminator.hpp
+ *
+ *  Created on: Mar 8, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+#include "SeekDeep/objects/PrimerKmerIndex.hpp"
+#include "SeekDeep/objects/PrimerEditScreen.hpp"
+
+namespace bibseq {
+
+/**@brief Determines primers like PrimerDeterminator but only aligns against a shortlist of the primers
+ *
+ * The shortlist is the primers sharing a kmer with the read in a PrimerKmerIndex and/or the primers whose lower bound
+ * edit distance from a PrimerEditScreen is within what the comparison allows, a PrimerDeterminator is made for each
+ * set of shortlisted primers so which primer is picked between the shortlisted primers is the same as with the
+ * full PrimerDeterminator, not thread safe so each thread should have it's own
+ *
+ */
+class ShortlistPrimerDeterminator {
+public:
+	struct Stats {
+		uint64_t lookUps_ = 0;
+		uint64_t candidates_ = 0;
+		uint64_t screenedOut_ = 0;
+		uint64_t emptyShortlists_ = 0;
+		uint64_t checked_ = 0;
+		uint64_t checkedRecognized_ = 0;
+		uint64_t shortlistMissed_ = 0;
+
+		void addOtherStats(const Stats & other);
+	};
+
+	/**@brief
+	 *
+	 * @param primerTable the primer table the full determinator was made from
+	 * @param fullDeterminator a determinator with all primers, used to check how often the shortlist misses the primer
+	 * @param checkEvery check every this many look ups against the full determinator, 0 to never check
+	 * @param kmerIndex the primer kmer index, nullptr to start with all primers
+	 * @param forwardScreen edit screen of the forward primers in the order of targetNames_, nullptr to not screen
+	 * @param reverseScreen edit screen of the reverse primers followed by their reverse complements in the order of targetNames_, nullptr to not screen
+	 */
+	ShortlistPrimerDeterminator(const table & primerTable,
+			PrimerDeterminator & fullDeterminator, uint32_t checkEvery,
+			const PrimerKmerIndex * kmerIndex,
+			const PrimerEditScreen * forwardScreen,
+			const PrimerEditScreen * reverseScreen);
+
+	/**@brief the target names from the primer table, sorted, shortlists are positions in this
+	 *
+	 */
+	VecStr targetNames_;
+
+	Stats stats_;
+	/**@brief the number of different shortlists to keep determinators for before starting over
+	 *
+	 */
+	uint32_t maxCachedDeterminators_ = 512;
+
+	/**@brief Works on the same read types as PrimerDeterminator, readObject and PairedRead
+	 *
+	 */
+	template<typename READ>
+	std::string determineForwardPrimer(std::shared_ptr<READ> & seq,
+			uint32_t withinPos, aligner & alignObj, const comparison & allowable,
+			bool primerToLowerCase) {
+		return determine(seq, withinPos, alignObj, allowable, primerToLowerCase, true);
+	}
+
+	template<typename READ>
+	std::string determineWithReversePrimer(std::shared_ptr<READ> & seq,
+			uint32_t withinPos, aligner & alignObj, const comparison & allowable,
+			bool primerToLowerCase) {
+		return determine(seq, withinPos, alignObj, allowable, primerToLowerCase, false);
+	}
+
+	static void writeStats(std::ostream & out, const Stats & stats);
+
+private:
+	table primerTable_;
+	PrimerDeterminator & fullDeterminator_;
+	uint32_t checkEvery_;
+	const PrimerKmerIndex * kmerIndex_;
+	const PrimerEditScreen * forwardScreen_;
+	const PrimerEditScreen * reverseScreen_;
+	std::vector<uint32_t> allTargets_;
+	std::vector<uint16_t> distances_;
+
+	void screen(const std::string & seq, uint32_t withinPos,
+			const comparison & allowable, bool forward,
+			std::vector<uint32_t> & candidates);
+
+	std::unordered_map<std::string, std::unique_ptr<PrimerDeterminator>> determinators_;
+
+	PrimerDeterminator & getDeterminator(const std::vector<uint32_t> & candidates);
+
+	std::vector<uint32_t> shortlist(const std::string & seq, uint32_t withinPos,
+			const comparison & allowable, bool forward);
+
+	void recordCheck(const std::string & fullPrimerName,
+			const std::vector<uint32_t> & candidates);
+
+	template<typename READ>
+	std::string determine(std::shared_ptr<READ> & seq, uint32_t withinPos,
+			aligner & alignObj, const comparison & allowable, bool primerToLowerCase,
+			bool forward) {
+		auto candidates = shortlist(seq->seqBase_.seq_, withinPos, allowable, forward);
+		bool checking = checkEvery_ > 0 && 0 == stats_.lookUps_ % checkEvery_;
+		std::shared_ptr<READ> checkSeq;
+		if (checking) {
+			checkSeq = std::make_shared<READ>(*seq);
+		}
+		std::string primerName = "unrecognized";
+		if (candidates.empty()) {
+			++stats_.emptyShortlists_;
+			seq->seqBase_.on_ = false;
+		} else {
+			auto & determinator = getDeterminator(candidates);
+			if (forward) {
+				primerName = determinator.determineForwardPrimer(seq, withinPos, alignObj,
+						allowable, primerToLowerCase);
+			} else {
+				primerName = determinator.determineWithReversePrimer(seq, withinPos,
+						alignObj, allowable, primerToLowerCase);
+			}
+		}
+		if (checking) {
+			std::string fullPrimerName = "";
+			if (forward) {
+				fullPrimerName = fullDeterminator_.determineForwardPrimer(checkSeq,
+						withinPos, alignObj, allowable, primerToLowerCase);
+			} else {
+				fullPrimerName = fullDeterminator_.determineWithReversePrimer(checkSeq,
+						withinPos, alignObj, allowable, primerToLowerCase);
+			}
+			recordCheck(fullPrimerName, candidates);
+		}
+		return primerName;
+	}
+};
+
+}  // namespace bibseq
@@ -0,0 +1,94 @@
+/*
+ * StageTimingProfile.cpp
+ *
+ *  Created on: Mar 18, 2017
+ *      Author: nick
+ */
+
+#include "StageTimingProfile.hpp"
+
+namespace bibseq {
+
+void StageTimingProfile::Stage::addOther(const Stage & other) {
+	wallSeconds_ += other.wallSeconds_;
+	cpuSeconds_ += other.cpuSeconds_;
+	reads_ += other.reads_;
+	bytesIn_ += other.bytesIn_;
+	bytesOut_ += other.bytesOut_;
+}
+
+Json::Value StageTimingProfile::Stage::toJson() const {
+	Json::Value ret;
+	ret["wallSeconds"] = bib::json::toJson(wallSeconds_);
+	ret["cpuSeconds"] = bib::json::toJson(cpuSeconds_);
+	ret["reads"] = bib::json::toJson(reads_);
+	ret["readsPerSecond"] = bib::json::toJson(
+			wallSeconds_ > 0 ? reads_ / wallSeconds_ : 0);
+	ret["bytesIn"] = bib::json::toJson(bytesIn_);
+	ret["bytesOut"] = bib::json::toJson(bytesOut_);
+	return ret;
+}
+
+StageTimingProfile::Timer::Timer(StageTimingProfile * profile,
+		const char * stage, uint64_t bytesIn) :
+		bytesIn_(bytesIn), profile_(profile), stage_(stage) {
+	if (nullptr != profile_) {
+		wallStart_ = std::chrono::steady_clock::now();
+		cpuStart_ = threadCpuSeconds();
+	}
+}
+
+StageTimingProfile::Timer::~Timer() {
+	stop();
+}
+
+void StageTimingProfile::Timer::stop() {
+	if (nullptr == profile_) {
+		return;
+	}
+	Stage times;
+	times.wallSeconds_ = std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - wallStart_).count();
+	times.cpuSeconds_ = threadCpuSeconds() - cpuStart_;
+	times.reads_ = reads_;
+	times.bytesIn_ = bytesIn_;
+	times.bytesOut_ = bytesOut_;
+	profile_->add(stage_, times);
+	profile_ = nullptr;
+}
+
+void StageTimingProfile::add(const std::string & stage, const Stage & times) {
+	auto search = stages_.find(stage);
+	if (stages_.end() == search) {
+		stageOrder_.emplace_back(stage);
+		search = stages_.emplace(stage, Stage()).first;
+	}
+	search->second.addOther(times);
+}
+
+void StageTimingProfile::addOther(const StageTimingProfile & other) {
+	for (const auto & stage : other.stageOrder_) {
+		add(stage, other.stages_.at(stage));
+	}
+}
+
+Json::Value StageTimingProfile::toJson() const {
+	Json::Value ret;
+	auto & stages = ret["stages"];
+	for (const auto & stage : stageOrder_) {
+		auto stageJson = stages_.at(stage).toJson();
+		stageJson["stage"] = bib::json::toJson(stage);
+		stages.append(stageJson);
+	}
+	return ret;
+}
+
+double StageTimingProfile::threadCpuSeconds() {
+	timespec ts;
+	if (0 != clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts)) {
+		return 0;
+	}
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+}  // namespace bibseq
@@ -0,0 +1,72 @@
+#pragma once
+
+/*
+ * StageTimingProfile.hpp
+ *
+ *  Created on: Mar 18, 2017
+ *      Author: nick
+ */
+
+#include <bibseq.h>
+#include <ctime>
+
+namespace bibseq {
+
+/**@brief Tallies wall time, cpu time, reads and bytes in and out per named processing stage
+ *
+ * Each thread should fill its own profile and the profiles added together with addOther() when done, times are
+ * summed over the threads so for a stage done on several threads the wall time is the total time spent by all threads
+ *
+ */
+class StageTimingProfile {
+public:
+	struct Stage {
+		double wallSeconds_ = 0;
+		double cpuSeconds_ = 0;
+		uint64_t reads_ = 0;
+		uint64_t bytesIn_ = 0;
+		uint64_t bytesOut_ = 0;
+
+		void addOther(const Stage & other);
+		Json::Value toJson() const;
+	};
+
+	/**@brief Times a stage from construction until stop() is called or it goes out of scope, does nothing if profile is nullptr
+	 *
+	 */
+	class Timer {
+	public:
+		Timer(StageTimingProfile * profile, const char * stage,
+				uint64_t bytesIn = 0);
+		~Timer();
+
+		uint64_t reads_ = 1;
+		uint64_t bytesIn_;
+		uint64_t bytesOut_ = 0;
+
+		void stop();
+
+	private:
+		StageTimingProfile * profile_;
+		const char * stage_;
+		std::chrono::steady_clock::time_point wallStart_;
+		double cpuStart_ = 0;
+	};
+
+	std::map<std::string, Stage> stages_;
+	//the stages in the order they were first seen
+	VecStr stageOrder_;
+
+	void add(const std::string & stage, const Stage & times);
+	void addOther(const StageTimingProfile & other);
+
+	Json::Value toJson() const;
+
+	/**@brief cpu time used by the calling thread
+	 *
+	 * @return seconds
+	 */
+	static double threadCpuSeconds();
+};
+
+}  // namespace bibseq
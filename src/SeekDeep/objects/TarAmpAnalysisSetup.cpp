@@ -90,8 +90,13 @@ bool TarAmpAnalysisSetup::TarAmpPars::allChecks(VecStr & warnings) const {
 	bool status = true;
 	status = status && checkForRequiredFnpPars(warnings);
 	status = status && checkForOptionalFnpPars(warnings);
-	status = status && checkForStitcher(warnings);
-	status = status && checkForZcat(warnings);
+	if (techIsIllumina() && useFlash) {
+		status = status && checkForStitcher(warnings);
+	}
+	//illumina reads are read gzipped when stitching in process
+	if (!techIsIllumina() || useFlash) {
+		status = status && checkForZcat(warnings);
+	}
 	return status;
 }
 
@@ -36,6 +36,10 @@ public:
 		//Illumina specific
 		//paired end specific
 		uint32_t maxOverlap = 250;
+		uint32_t minOverlap = 10;
+		double maxMismatchDensity = 0.25;
+		//stitch with the external stitcherCmd on zcat'd copies of the reads instead of in process
+		bool useFlash = false;
 		uint32_t r1Trim = std::numeric_limits<uint32_t>::max();
 		uint32_t r2Trim = std::numeric_limits<uint32_t>::max();
 		//
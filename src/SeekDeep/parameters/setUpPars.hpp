@@ -44,6 +44,8 @@ struct extractorPars{
   bool trimTcag = false;
 
   uint32_t barcodeErrors = 0;
+  bool barcodeIndex = false;
+  bool barcodeIndexIndel = false;
   bool midEndsRevComp = false;
   bool rename = false;
 
@@ -55,9 +57,15 @@ struct extractorPars{
   bool forwardPrimerToUpperCase = false;
   comparison fPrimerErrors;
 
+  bool primerKmerIndex = false;
+  uint32_t primerKmerLen = 8;
+  uint32_t primerKmerIndexCheckEvery = 1000;
+  bool primerEditScreen = false;
+
 
   double kmerCutOff = .20;
   uint32_t contaminationKLen = 7;
+  bool contaminationKmerIndex = false;
 
   MidDeterminator::MidDeterminePars mDetPars;
   uint32_t qualCheck = 30;
@@ -80,6 +88,29 @@ struct extractorPars{
 	uint32_t trimAtQualCutOff = 2;
 	bool trimAtQual = false;
 
+	uint32_t numThreads = 1;
+	uint32_t batchSize = 1000;
+
+	bool singlePass = false;
+	uint32_t singlePassSampleSize = 10000;
+	bool keepUnfilteredReads = false;
+
+	uint32_t maxOpenOutputs = 256;
+	uint64_t outputBufferSize = 1024 * 1024;
+	uint64_t outputTotalBufferSize = 512 * 1024 * 1024;
+
+	bool bgzfOutput = false;
+	uint32_t bgzfThreads = 2;
+	int32_t bgzfLevel = 1;
+
+	bool readAhead = false;
+	uint64_t readAheadBufferSize = 4 * 1024 * 1024;
+
+	bool timingProfile = false;
+
+	uint64_t checkpointEvery = 0;
+	bool resume = false;
+
 };
 
 struct clusterDownPars {
@@ -105,6 +136,7 @@ struct clusterDownPars {
   uint32_t singletCutOff = 1;
 
   bool createMinTree = false;
+  bool minTreeByDifferences = false;
   std::string diffCutOffStr = "0.1";
 
   bool writeOutFinalInternalSnps = false;
@@ -124,6 +156,16 @@ struct clusterDownPars {
 
 	bool writeOutInitalSeqs = false;
 
+	bool bgzfOutput = false;
+	uint32_t bgzfThreads = 2;
+	int32_t bgzfLevel = 1;
+
+	bool readAhead = false;
+	uint64_t readAheadBufferSize = 4 * 1024 * 1024;
+
+	uint32_t numThreads = 1;
+	bfs::path alnCacheFnp = "";
+
 	SnapShotsOpts snapShotsOpts_;
 };
 
@@ -72,35 +72,98 @@ int SeekDeepRunner::qluster(const bib::progutils::CmdArgs & inputCommands) {
 	}
 
 	// read in the sequences
-	SeqInput reader(setUp.pars_.ioOptions_);
-	reader.openIn();
-	auto reads = reader.readAllReads<readObject>();
+	//the reads are read a batch at a time and packed into inputReads, the clusters only refer to them by their positions in it, so
+	//the reads are never all held as readObjects
+	ReadArena inputReads;
+	std::vector<readObject> smallReads;
+	auto readInputReads = [&setUp, &pars, &inputReads, &smallReads](auto & reader) {
+		const uint32_t batchSize = 10000;
+		std::vector<readObject> batch;
+		batch.reserve(batchSize);
+		auto addBatch = [&]() {
+			auto splitOnSize = readVecSplitter::splitVectorBellowLength(batch,
+					pars.smallReadSize);
+			addOtherVec(smallReads, splitOnSize.second);
+			if (setUp.pars_.colOpts_.iTOpts_.removeLowQualityBases_) {
+				readVec::allRemoveLowQualityBases(splitOnSize.first, setUp.pars_.colOpts_.iTOpts_.lowQualityBaseTrim_);
+			}
+			if (setUp.pars_.colOpts_.iTOpts_.adjustHomopolyerRuns_) {
+				readVec::allAdjustHomopolymerRunsQualities(splitOnSize.first);
+			}
+			for (const auto & read : splitOnSize.first) {
+				inputReads.add(read);
+			}
+			batch.clear();
+		};
+		reader.openIn();
+		seqInfo read;
+		while (reader.readNextRead(read)) {
+			batch.emplace_back(readObject(read));
+			if (batch.size() >= batchSize) {
+				addBatch();
+			}
+		}
+		addBatch();
+		reader.closeIn();
+	};
+	if (BgzfSeqInput::isBgzfInput(setUp.pars_.ioOptions_)) {
+		//bgzf input, e.g. from extractor --bgzfOutput, can be decompressed on several threads
+		BgzfSeqInput reader(setUp.pars_.ioOptions_, pars.bgzfThreads);
+		readInputReads(reader);
+	} else if (pars.readAhead) {
+		//the input is read and decompressed on its own thread while the reads are parsed
+		ReadAheadSeqInput reader(setUp.pars_.ioOptions_, pars.readAheadBufferSize);
+		readInputReads(reader);
+	} else {
+		SeqInput reader(setUp.pars_.ioOptions_);
+		readInputReads(reader);
+	}
 	setUp.rLog_.logCurrentTime("Various filtering and little modifications");
-	auto splitOnSize = readVecSplitter::splitVectorBellowLength(reads,
-			pars.smallReadSize);
-	reads = splitOnSize.first;
-	if (!splitOnSize.second.empty()) {
-		SeqOutput::write(splitOnSize.second,SeqIOOptions(setUp.pars_.directoryName_ + "smallReads",
+	if (!smallReads.empty()) {
+		SeqOutput::write(smallReads,SeqIOOptions(setUp.pars_.directoryName_ + "smallReads",
 				setUp.pars_.ioOptions_.outFormat_,setUp.pars_.ioOptions_.out_));
 	}
-	if (setUp.pars_.colOpts_.iTOpts_.removeLowQualityBases_) {
-		readVec::allRemoveLowQualityBases(reads, setUp.pars_.colOpts_.iTOpts_.lowQualityBaseTrim_);
-	}
-	if (setUp.pars_.colOpts_.iTOpts_.adjustHomopolyerRuns_) {
-		readVec::allAdjustHomopolymerRunsQualities(reads);
-	}
+	std::vector<readObject>().swap(smallReads);
 	bool containsCompReads = false;
-	int compCount = 0;
-	readVec::getCountOfReadNameContaining(reads, "_Comp", compCount);
-	if (compCount > 0) {
-		containsCompReads = true;
+	for (uint32_t readPos = 0; readPos < inputReads.size(); ++readPos) {
+		if (inputReads.nameContains(readPos, "_Comp")) {
+			containsCompReads = true;
+			break;
+		}
 	}
-
-	readVecSorter::sortReadVector(reads, pars.sortBy);
+	{
+		std::vector<uint32_t> readOrder(inputReads.size());
+		std::iota(readOrder.begin(), readOrder.end(), 0);
+		if ("totalCount" == pars.sortBy) {
+			//same comparison readVecSorter::sortReadVector() does for totalCount so the reads end up in the same order
+			std::sort(readOrder.begin(), readOrder.end(),
+					[&inputReads](uint32_t pos1, uint32_t pos2) {
+						return inputReads.getCnt(pos1) > inputReads.getCnt(pos2);
+					});
+			inputReads.reorder(readOrder);
+		} else {
+			//other orders are sorted by readVecSorter on a copy of the reads
+			std::vector<readObject> reads;
+			reads.reserve(inputReads.size());
+			for (const auto readPos : readOrder) {
+				reads.emplace_back(readObject(inputReads.getSeqInfo(readPos)));
+			}
+			readVecSorter::sortReadVector(reads, pars.sortBy);
+			inputReads.clear();
+			for (const auto & read : reads) {
+				inputReads.add(read);
+			}
+		}
+	}
+	inputReads.shrinkToFit();
 	// get the count of reads read in and the max length so far
-	int counter = readVec::getTotalReadCount(reads);
+	double totalReadCount = 0;
 	uint64_t maxSize = 0;
-	readVec::getMaxLength(reads, maxSize);
+	for (uint32_t readPos = 0; readPos < inputReads.size(); ++readPos) {
+		totalReadCount += inputReads.getCnt(readPos);
+		maxSize = std::max<uint64_t>(maxSize, inputReads.getSeqLen(readPos));
+	}
+	int counter = totalReadCount;
 	std::vector<readObject> refSequences;
 	if (setUp.pars_.refIoOptions_.firstName_ != "") {
 		refSequences = SeqInput::getReferenceSeq(setUp.pars_.refIoOptions_, maxSize);
@@ -108,7 +171,7 @@ int SeekDeepRunner::qluster(const bib::progutils::CmdArgs & inputCommands) {
 	maxSize = maxSize * 2;
 	// calculate the runCutoff if necessary
 	processRunCutoff(setUp.pars_.colOpts_.kmerOpts_.runCutOff_, setUp.pars_.colOpts_.kmerOpts_.runCutOffString_,
-			readVec::getTotalReadCount(reads));
+			totalReadCount);
 	if (setUp.pars_.verbose_ && !pars.onPerId) {
 		std::cout << "Kmer Low Frequency Error Cut off Is: " << setUp.pars_.colOpts_.kmerOpts_.runCutOff_
 				<< std::endl;
@@ -127,17 +190,31 @@ int SeekDeepRunner::qluster(const bib::progutils::CmdArgs & inputCommands) {
 	setUp.rLog_ << "Read in " << counter << " reads" << "\n";
 	setUp.rLog_.logCurrentTime("Collapsing to unique sequences");
 	// create cluster vector
-	std::vector<identicalCluster> identicalClusters;
 	std::vector<cluster> clusters;
+	//the input reads of each unique sequence are only needed at the end for the comp stats and writing the initial reads so the
+	//clusters keep their positions in inputReads rather than copies of them
+	std::unordered_map<std::string, std::vector<uint32_t>> uniqueSeqInputReads;
+	const uint64_t inputReadCount = inputReads.size();
+	bool keepInputReads = false;
 	if (setUp.pars_.ioOptions_.processed_) {
-		clusters = baseCluster::convertVectorToClusterVector<cluster>(reads);
+		for (uint32_t readPos = 0; readPos < inputReads.size(); ++readPos) {
+			clusters.push_back(cluster(inputReads.getSeqInfo(readPos)));
+		}
 	} else {
-		identicalClusters = clusterCollapser::collapseIdenticalReads(reads,
-				pars.qualRep);
-		for (const auto & read : identicalClusters) {
-			clusters.push_back(cluster(read.seqBase_));
+		IdenticalReadCollapser identicalCollapser(pars.numThreads);
+		keepInputReads = containsCompReads || pars.writeOutInitalSeqs;
+		auto uniqueSeqs = identicalCollapser.collapseToUniqueSeqs(inputReads, pars.qualRep);
+		for (auto & uniqueSeq : uniqueSeqs) {
+			clusters.push_back(cluster(uniqueSeq.seqBase_));
+			if (keepInputReads) {
+				uniqueSeqInputReads[uniqueSeq.seqBase_.name_] = std::move(uniqueSeq.readPositions_);
+			}
 		}
-		//clusters = baseCluster::convertVectorToClusterVector<cluster>(identicalClusters);
+	}
+	//only the clusters, and the input reads if they're written out or checked for _Comp, are needed from here on
+	if (!keepInputReads) {
+		inputReads.clear();
+		inputReads.shrinkToFit();
 	}
 
 	if (setUp.pars_.verbose_) {
@@ -202,9 +279,26 @@ int SeekDeepRunner::qluster(const bib::progutils::CmdArgs & inputCommands) {
 			std::cout << "Removed " << singletons.size() << " singlets" << std::endl;
 		}
 	}
+	//with more than one thread (or an alignment cache) the alignments runFullClustering() will look for are done ahead of it on
+	//several threads and put in alignerObj's cache, the clustering itself is unchanged so the clusters are the same with any
+	//number of threads
+	std::unique_ptr<MappedAlignmentCache> alnCache;
+	if ("" != pars.alnCacheFnp) {
+		alnCache = std::make_unique<MappedAlignmentCache>(pars.alnCacheFnp);
+	}
+	std::unique_ptr<ClusterPrealigner> prealigner;
+	if ((pars.numThreads > 1 || alnCache)
+			&& ClusterPrealigner::canPrealign(collapserObj.opts_, pars.onPerId)) {
+		prealigner = std::make_unique<ClusterPrealigner>(collapserObj.opts_,
+				pars.numThreads);
+		prealigner->setAlignmentCache(alnCache.get());
+	}
 	setUp.rLog_.logCurrentTime("Running initial clustering");
 	//run clustering
 	pars.snapShotsOpts_.snapShotsDirName_ = "firstSnaps";
+	if (prealigner) {
+		prealigner->prealign(clusters, alignerObj, pars.intialParameters);
+	}
 	collapserObj.runFullClustering(clusters, pars.intialParameters,
 			pars.binIteratorMap, alignerObj, setUp.pars_.directoryName_,
 			setUp.pars_.ioOptions_, setUp.pars_.refIoOptions_, pars.snapShotsOpts_);
@@ -213,6 +307,9 @@ int SeekDeepRunner::qluster(const bib::progutils::CmdArgs & inputCommands) {
 		setUp.rLog_.logCurrentTime("Running singlet clustering");
 		addOtherVec(clusters, singletons);
 		pars.snapShotsOpts_.snapShotsDirName_ = "secondSnaps";
+		if (prealigner) {
+			prealigner->prealign(clusters, alignerObj, pars.iteratorMap);
+		}
 		collapserObj.runFullClustering(clusters, pars.iteratorMap,
 				pars.binIteratorMap, alignerObj, setUp.pars_.directoryName_,
 				setUp.pars_.ioOptions_, setUp.pars_.refIoOptions_, pars.snapShotsOpts_);
@@ -256,6 +353,11 @@ int SeekDeepRunner::qluster(const bib::progutils::CmdArgs & inputCommands) {
 				setUp.pars_.directoryName_ + "chimeraNumberInfo.txt", ".txt", false, false);
 		chimerasInfoFile << "#chimericClusters\t#chimericReads" << std::endl;
 		setUp.pars_.chiOpts_.chiOverlap_.largeBaseIndel_ = .99;
+		if (pars.numThreads > 1) {
+			//the parent alignments are done on all threads first so markChimeras only has to look them up
+			ChimeraPrealigner chiPrealigner(pars.numThreads);
+			chiPrealigner.prealign(clusters, alignerObj, setUp.pars_.chiOpts_);
+		}
 		auto chiInfoTab = collapserObj.markChimeras(clusters, alignerObj,
 				setUp.pars_.chiOpts_);
 		chiInfoTab.outPutContents(
@@ -316,6 +418,43 @@ int SeekDeepRunner::qluster(const bib::progutils::CmdArgs & inputCommands) {
 		startingInfo << clus.seqBase_.name_ << "\t" << clus.firstReadName_ << "\t"
 				<< toks.back() << std::endl;
 	}
+	//the longest output read is recorded in the meta data so processClusters can size its aligner without reading every file first
+	uint64_t maxOutputLength = 0;
+	readVec::getMaxLength(clusters, maxOutputLength);
+	auto writeClusters = [&pars](const std::vector<cluster> & clus, const SeqIOOptions & opts) {
+		if (pars.bgzfOutput && BgzfSeqOutput::canCompress(opts)) {
+			BgzfSeqOutput::write(clus, opts, pars.bgzfThreads, pars.bgzfLevel);
+			return BgzfSeqOutput::getOutFnp(opts);
+		}
+		SeqOutput::write(clus, opts);
+		return bfs::path(opts.out_.outName());
+	};
+	//the max length is kept per file along with the file's size, and the lengths already in the directory's meta data are kept,
+	//so samples written to the same directory (e.g. with --additionalOut) don't replace each other's
+	auto writeMetaData = [&metaData, &setUp, &maxOutputLength](const std::string & dirName,
+			const bfs::path & outFnp) {
+		auto metaDataFnp = bib::files::make_path(dirName, "metaData.json");
+		Json::Value outMetaData = metaData;
+		if (bfs::exists(metaDataFnp)) {
+			auto previousMetaData = bib::json::parseFile(metaDataFnp.string());
+			if (previousMetaData.isMember("maxReadLengths")) {
+				outMetaData["maxReadLengths"] = previousMetaData["maxReadLengths"];
+			}
+		}
+		if (bfs::exists(outFnp)) {
+			auto & fileMetaData = outMetaData["maxReadLengths"][outFnp.filename().string()];
+			fileMetaData["maxReadLength"] = bib::json::toJson(maxOutputLength);
+			fileMetaData["fileSize"] = bib::json::toJson(
+					static_cast<uint64_t>(bfs::file_size(outFnp)));
+		}
+		auto metaDataOutOpts = setUp.pars_.ioOptions_.out_;
+		//the previous meta data was merged in above
+		metaDataOutOpts.overWriteFile_ = true;
+		std::ofstream metaDataFile;
+		openTextFile(metaDataFile, bib::files::make_path(dirName, "metaData").string(), ".json",
+				metaDataOutOpts);
+		metaDataFile << outMetaData;
+	};
 	if (pars.additionalOut) {
 		std::string additionalOutDir = findAdditonalOutLocation(
 				pars.additionalOutLocationFile, setUp.pars_.ioOptions_.firstName_.string());
@@ -325,19 +464,17 @@ int SeekDeepRunner::qluster(const bib::progutils::CmdArgs & inputCommands) {
 					<< setUp.pars_.ioOptions_.firstName_ << std::endl;
 			std::cerr << bib::bashCT::reset;
 		} else {
-			SeqOutput::write(clusters, SeqIOOptions(additionalOutDir + setUp.pars_.ioOptions_.out_.outFilename_.string(),
+			auto additionalOutFnp = writeClusters(clusters, SeqIOOptions(additionalOutDir + setUp.pars_.ioOptions_.out_.outFilename_.string(),
 					setUp.pars_.ioOptions_.outFormat_,setUp.pars_.ioOptions_.out_));
-			std::ofstream metaDataFile;
-			openTextFile(metaDataFile, additionalOutDir + "/" + "metaData", ".json",
-					setUp.pars_.ioOptions_.out_);
-			metaDataFile << metaData;
+			writeMetaData(additionalOutDir, additionalOutFnp);
 		}
 	}
 
-	SeqOutput::write(clusters,
+	auto outFnp = writeClusters(clusters,
 			SeqIOOptions(
 					setUp.pars_.directoryName_ + setUp.pars_.ioOptions_.out_.outFilename_.string(),
 					setUp.pars_.ioOptions_.outFormat_,setUp.pars_.ioOptions_.out_));
+	writeMetaData(setUp.pars_.directoryName_, outFnp);
 	if(pars.writeOutFinalInternalSnps){
 		setUp.rLog_.logCurrentTime("Calling internal snps");
 		std::string snpDir = bib::files::makeDir(setUp.pars_.directoryName_,
@@ -387,33 +524,45 @@ int SeekDeepRunner::qluster(const bib::progutils::CmdArgs & inputCommands) {
 				bib::files::MkdirPar("minTree", false)).string();
 		auto clusSplit = readVecSplitter::splitVectorOnReadFraction(clusters,
 				0.005);
-		std::vector<readObject> tempReads;
-		for (const auto & clus : clusSplit.first) {
-			tempReads.emplace_back(readObject(clus.seqBase_));
-		}
-	  std::unordered_map<std::string, std::unique_ptr<aligner>> aligners;
-	  std::mutex alignerLock;
-	  uint32_t numThreads = 2;
-		auto graph = genReadComparisonGraph(tempReads, alignerObj, aligners, alignerLock,
-				numThreads);
-		std::vector<std::string> popNames;
-		for (const auto & n : graph.nodes_) {
-			if (n->on_) {
-				popNames.emplace_back(n->name_);
+		auto writeTree = [&](comparisonGraph & graph) {
+			std::vector<std::string> popNames;
+			for (const auto & n : graph.nodes_) {
+				if (n->on_) {
+					popNames.emplace_back(n->name_);
+				}
 			}
+			auto nameColors = getColorsForNames(popNames);
+			comparison maxEvents = graph.setMinimumEventConnections();
+			if(setUp.pars_.debug_){
+				std::cout << maxEvents.toJson() << std::endl;
+			}
+			auto treeData = graph.toD3Json(bib::color("#000000"), nameColors);
+			std::ofstream outJson(minTreeDirname + "tree.json");
+			std::ofstream outHtml(minTreeDirname + "tree.html");
+			outJson << treeData;
+			auto outHtmlStr = genHtmlStrForPsuedoMintree("tree.json",
+					"http://bib8.umassmed.edu/~hathawan/js/psuedoMinTreeWithIndels.js");
+			outHtml << outHtmlStr;
+		};
+		if (pars.minTreeByDifferences) {
+			MinSpanningTreeBuilder treeBuilder(pars.numThreads,
+					setUp.pars_.colOpts_.alignOpts_.countEndGaps_);
+			auto graph = treeBuilder.build(clusSplit.first, alignerObj);
+			setUp.rLog_ << "Minimum Spanning Tree Alignments: "
+					<< treeBuilder.alignmentsDone_ << " done, "
+					<< treeBuilder.kmerSkipped_ << " skipped by kmers" << "\n";
+			writeTree(graph);
+		} else {
+			std::vector<readObject> tempReads;
+			for (const auto & clus : clusSplit.first) {
+				tempReads.emplace_back(readObject(clus.seqBase_));
+			}
+			std::unordered_map<std::string, std::unique_ptr<aligner>> aligners;
+			std::mutex alignerLock;
+			auto graph = genReadComparisonGraph(tempReads, alignerObj, aligners, alignerLock,
+					pars.numThreads);
+			writeTree(graph);
 		}
-		auto nameColors = getColorsForNames(popNames);
-		comparison maxEvents = graph.setMinimumEventConnections();
-		if(setUp.pars_.debug_){
-			std::cout << maxEvents.toJson() << std::endl;
-		}
-		auto treeData = graph.toD3Json(bib::color("#000000"), nameColors);
-		std::ofstream outJson(minTreeDirname + "tree.json");
-		std::ofstream outHtml(minTreeDirname + "tree.html");
-		outJson << treeData;
-		auto outHtmlStr = genHtmlStrForPsuedoMintree("tree.json",
-				"http://bib8.umassmed.edu/~hathawan/js/psuedoMinTreeWithIndels.js");
-		outHtml << outHtmlStr;
 	}
 
 
@@ -463,18 +612,22 @@ int SeekDeepRunner::qluster(const bib::progutils::CmdArgs & inputCommands) {
 			subClusterWriter.openOut();
 		}
 
+		seqInfo subClusCopy;
 		for (const auto& clus : clusters) {
 			MetaDataInName clusMeta;
 			clusMeta.addMeta("clusterName", clus.seqBase_.name_);
 			uint32_t currentCompAmount = 0;
 			for (const auto & seq : clus.reads_) {
-				auto input = readVec::getReadByName(identicalClusters, seq->seqBase_.name_);
-				for( auto & inputRead : input.reads_){
-					if (bib::containsSubString(inputRead->seqBase_.name_, "_Comp")) {
-						currentCompAmount += inputRead->seqBase_.cnt_;
+				auto input = uniqueSeqInputReads.find(seq->seqBase_.name_);
+				if (uniqueSeqInputReads.end() == input) {
+					continue;
+				}
+				for (const auto inputPos : input->second) {
+					if (inputReads.nameContains(inputPos, "_Comp")) {
+						currentCompAmount += inputReads.getCnt(inputPos);
 					}
 					if(pars.writeOutInitalSeqs){
-						seqInfo subClusCopy = inputRead->seqBase_;
+						inputReads.getSeqInfo(inputPos, subClusCopy);
 						clusMeta.resetMetaInName(subClusCopy.name_);
 						subClusterWriter.write(subClusCopy);
 					}
@@ -496,7 +649,7 @@ int SeekDeepRunner::qluster(const bib::progutils::CmdArgs & inputCommands) {
 				".tab.txt", false, true);
 		singletonsInfoFile << "readCnt\treadFrac\n";
 		singletonsInfoFile << singletons.size() << "\t"
-				<< singletons.size() / static_cast<double>(reads.size())
+				<< singletons.size() / static_cast<double>(inputReadCount)
 				<< std::endl;
 	}
 
@@ -505,11 +658,30 @@ int SeekDeepRunner::qluster(const bib::progutils::CmdArgs & inputCommands) {
 		alignerObj.alnHolder_.write(setUp.pars_.outAlnInfoDirName_);
 	}
 	//log number of alignments done
+	uint64_t alignmentsDone = alignerObj.numberOfAlingmentsDone_;
+	if (alnCache) {
+		setUp.rLog_ << "Alignment Cache: " << alnCache->stats_.hits_ << " found, "
+				<< alnCache->stats_.added_ << " added, " << alnCache->size()
+				<< " total" << "\n";
+		if (setUp.pars_.verbose_) {
+			std::cout << "Alignment Cache: " << alnCache->stats_.hits_ << " found, "
+					<< alnCache->stats_.added_ << " added, " << alnCache->size()
+					<< " total" << std::endl;
+		}
+	}
+	if (prealigner) {
+		setUp.rLog_ << "Number of Alignments Done Ahead Of Clustering: "
+				<< prealigner->alignmentsDone_ << "\n";
+		if (setUp.pars_.verbose_) {
+			std::cout << "Number of Alignments Done Ahead Of Clustering: "
+					<< prealigner->alignmentsDone_ << std::endl;
+		}
+	}
 	setUp.rLog_ << "Number of Alignments Done: "
-			<< alignerObj.numberOfAlingmentsDone_ << "\n";
+			<< alignmentsDone << "\n";
 	if (setUp.pars_.verbose_) {
 		std::cout << "Number of Alignments Done: "
-				<< alignerObj.numberOfAlingmentsDone_ << std::endl;
+				<< alignmentsDone << std::endl;
 		//log time
 		setUp.logRunTime(std::cout);
 	}
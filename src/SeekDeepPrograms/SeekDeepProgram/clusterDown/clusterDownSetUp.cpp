@@ -284,6 +284,12 @@ void SeekDeepSetUp::setUpClusterDown(clusterDownPars & pars) {
 				"Naturally the cut off for being a singlet is by default 1 but can use --singletCutOff to raise the number", false, "Clustering");
 	setOption(pars.createMinTree, "--createMinTree",
 			"Create Pseudo minimum Spanning Trees For Mismatches for Final Clusters", false, "Additional Output");
+	setOption(pars.minTreeByDifferences, "--minTreeByDifferences",
+			"Create the --createMinTree tree by differences instead, each mismatch and each gap base counts as one difference rather than each event, each cluster is connected by one edge and tied edges aren't kept, clusters that can't be closer by kmers aren't aligned so it's faster for many clusters", false, "Additional Output");
+	if (pars.minTreeByDifferences && !pars.createMinTree) {
+		addWarning("--minTreeByDifferences can only be used with --createMinTree");
+		failed_ = true;
+	}
 	setOption(pars_.colOpts_.kmerBinOpts_.useKmerBinning_, "--useKmerBinning", "Use Kmer Binning for initial clustering to speed up clustering", false, "Clustering");
 	setOption(pars_.colOpts_.kmerBinOpts_.kmerCutOff_, "--kmerCutOff", "kmer Cut Off for when --useKmerBinning is used", false, "Clustering");
 	setOption(pars_.colOpts_.kmerBinOpts_.kCompareLen_, "--kCompareLen", "kmer Compare Length for when bining by kmers first for when --useKmerBinning is used", false, "Clustering");
@@ -316,6 +322,41 @@ void SeekDeepSetUp::setUpClusterDown(clusterDownPars & pars) {
 	processSkipOnNucComp();
 	setOption(pars_.colOpts_.clusOpts_.converge_, "--converge", "Keep clustering at each iteration until there is no more collapsing, could increase run time significantly", false, "Clustering");
 	setOption(pars.writeOutInitalSeqs, "--writeOutInitalSeqs", "Write out the sequences that make up each cluster", false, "Additional Output");
+	setOption(pars.bgzfOutput, "--bgzfOutput",
+			"Write the final clusters compressed as bgzf (block gzip, readable by any gzip reader), the output file gets .gz added", false, "Output");
+	setOption(pars.bgzfThreads, "--bgzfThreads",
+			"Number of threads to use for compressing the output and for decompressing bgzf input", false, "Output");
+	setOption(pars.bgzfLevel, "--bgzfLevel",
+			"Compression level (0-9) for bgzf output, lower is faster", false, "Output");
+	if (pars.bgzfLevel < 0 || pars.bgzfLevel > 9) {
+		addWarning("--bgzfLevel should be between 0 and 9, not " + estd::to_string(pars.bgzfLevel));
+		failed_ = true;
+	}
+	setOption(pars.readAhead, "--readAhead",
+			"Read and decompress the input on a separate thread into large buffers while the reads are being parsed", false, "Input");
+	setOption(pars.readAheadBufferSize, "--readAheadBufferSize",
+			"Size in bytes of each of the buffers the input is read ahead into", false, "Input");
+	if (pars.readAhead && 0 == pars.readAheadBufferSize) {
+		addWarning("--readAheadBufferSize can't be 0");
+		failed_ = true;
+	}
+	if (pars.readAhead && !ReadAheadSeqInput::canReadAhead(pars_.ioOptions_)) {
+		addWarning("--readAhead can only be used with fasta or fastq input");
+		failed_ = true;
+	}
+	setOption(pars.numThreads, "--numThreads",
+			"Number of threads to use for collapsing identical reads, aligning clusters ahead of clustering, aligning possible chimera parents and creating the minimum spanning tree, chimera checking is only faster when this is above 1, the clusters are the same with any number of threads", false, "Run Options");
+	if (0 == pars.numThreads) {
+		addWarning("--numThreads can't be 0");
+		failed_ = true;
+	}
+	setOption(pars.alnCacheFnp, "--alnCacheFile",
+			"A memory mapped alignment cache file, created if it doesn't exist and can be shared between runs, alignments done ahead of clustering are looked up in it before aligning and added to it, only global alignments are cached, the clusters are the same with or without it", false, "Alignment");
+	if ("" != pars.alnCacheFnp
+			&& !ClusterPrealigner::canPrealign(pars_.colOpts_, pars.onPerId)) {
+		addWarning("--alnCacheFile can't be used with --noAlignCompare or --onPerId");
+		failed_ = true;
+	}
 	pars_.colOpts_.verboseOpts_.verbose_ = pars_.verbose_;
 	pars_.colOpts_.verboseOpts_.debug_ = pars_.debug_;
 	processRefFilename();
@@ -37,7 +37,20 @@ int SeekDeepRunner::extractor(const bib::progutils::CmdArgs & inputCommands) {
 	SeekDeepSetUp setUp(inputCommands);
 	extractorPars pars;
 	setUp.setUpExtractor(pars);
+	auto extractorStart = std::chrono::steady_clock::now();
 
+	if (pars.singlePass && pars.filterOffSmallReadCounts) {
+		std::cerr << bib::bashCT::boldRed("Warning: ")
+				<< "--filterOffSmallReadCounts needs the read counts per barcode before filtering, extracting in two passes"
+				<< std::endl;
+		pars.singlePass = false;
+	}
+	if (pars.singlePass && (pars.mothurExtract || pars.pyroExtract)) {
+		std::cerr << bib::bashCT::boldRed("Warning: ")
+				<< "--singlePass can't be used when extracting flows, extracting in two passes"
+				<< std::endl;
+		pars.singlePass = false;
+	}
 	uint32_t readsNotMatchedToBarcode = 0;
 	uint32_t readsNotMatchedToBarcodePossContam = 0;
 	if (setUp.pars_.verbose_) {
@@ -60,7 +73,7 @@ int SeekDeepRunner::extractor(const bib::progutils::CmdArgs & inputCommands) {
 	// run log
 	setUp.startARunLog(setUp.pars_.directoryName_);
 	// parameter file
-	setUp.writeParametersFile(setUp.pars_.directoryName_ + "parametersUsed.txt", false,
+	setUp.writeParametersFile(setUp.pars_.directoryName_ + "parametersUsed.txt", pars.resume,
 			false);
 	readObject compareObject = readObject(seqInfo("Compare", pars.compareSeq));
 	table primerTable = seqUtil::readPrimers(pars.idFilename, pars.idFileDelim,
@@ -91,50 +104,75 @@ int SeekDeepRunner::extractor(const bib::progutils::CmdArgs & inputCommands) {
 		return std::equal(tcagLower.begin(), tcagLower.end(), seq.begin()) ||
 		std::equal(tcagUpper.begin(), tcagUpper.end(), seq.begin());
 	};
-	// make some directories for outputs
-	bfs::path unfilteredReadsDir = bib::files::makeDir(
-			setUp.pars_.directoryName_,
-			bib::files::MkdirPar("unfilteredReads", false));
-	bfs::path unfilteredByBarcodesDir = bib::files::makeDir(unfilteredReadsDir,
-			bib::files::MkdirPar("byBarcodes", false));
-	bfs::path unfilteredByBarcodesFlowDir = bib::files::makeDir(
-			unfilteredReadsDir, bib::files::MkdirPar("flowsByBarcodes", false));
-	bfs::path unfilteredByPrimersDir = bib::files::makeDir(unfilteredReadsDir,
-			bib::files::MkdirPar("byPrimers", false));
-	bfs::path filteredOffDir = bib::files::makeDir(setUp.pars_.directoryName_,
-			bib::files::MkdirPar("filteredOff", false));
-	bfs::path badDir = bib::files::makeDir(filteredOffDir,
-			bib::files::MkdirPar("bad", false));
-	bfs::path unrecognizedPrimerDir = bib::files::makeDir(filteredOffDir,
-			bib::files::MkdirPar("unrecognizedPrimer", false));
+	// make some directories for outputs, when resuming they already exist
+	auto makeOutDir = [&pars](const bfs::path & parent, const std::string & name) -> bfs::path {
+		if (pars.resume && bfs::exists(bib::files::make_path(parent, name))) {
+			return bib::files::make_path(parent, name);
+		}
+		return bib::files::makeDir(parent, bib::files::MkdirPar(name, false));
+	};
+	bfs::path unfilteredReadsDir = makeOutDir(setUp.pars_.directoryName_,
+			"unfilteredReads");
+	bfs::path unfilteredByBarcodesDir = makeOutDir(unfilteredReadsDir,
+			"byBarcodes");
+	bfs::path unfilteredByPrimersDir = makeOutDir(unfilteredReadsDir,
+			"byPrimers");
+	bfs::path filteredOffDir = makeOutDir(setUp.pars_.directoryName_,
+			"filteredOff");
+	bfs::path badDir = makeOutDir(filteredOffDir, "bad");
+	bfs::path unrecognizedPrimerDir = makeOutDir(filteredOffDir,
+			"unrecognizedPrimer");
 	bfs::path contaminationDir = "";
 	if (pars.screenForPossibleContamination) {
-		contaminationDir = bib::files::makeDir(filteredOffDir,
-				bib::files::MkdirPar("contamination", false));
+		contaminationDir = makeOutDir(filteredOffDir, "contamination");
 	}
 
-	std::shared_ptr<readObject> seq = std::make_shared<readObject>();
-
 	// read in reads and remove lower case bases indicating tech low quality like
 	// tags and such
 	if(setUp.pars_.verbose_){
 		std::cout << "Reading in reads:" << std::endl;
 	}
 	SeqIO reader(setUp.pars_.ioOptions_);
-	reader.openIn();
+	//bgzf input (e.g. from --bgzfOutput) is decompressed on --bgzfThreads threads, with --readAhead other input is read and
+	//decompressed on its own thread while the reads are extracted
+	std::unique_ptr<BgzfSeqInput> bgzfReader;
+	std::unique_ptr<ReadAheadSeqInput> readAheadReader;
+	if (BgzfSeqInput::isBgzfInput(setUp.pars_.ioOptions_)) {
+		bgzfReader = std::make_unique<BgzfSeqInput>(setUp.pars_.ioOptions_,
+				pars.bgzfThreads);
+		bgzfReader->openIn();
+	} else if (pars.readAhead) {
+		readAheadReader = std::make_unique<ReadAheadSeqInput>(
+				setUp.pars_.ioOptions_, pars.readAheadBufferSize);
+		readAheadReader->openIn();
+	} else {
+		reader.openIn();
+	}
+	auto readInputRead = [&](std::shared_ptr<readObject> & seq) {
+		if (nullptr != bgzfReader) {
+			return bgzfReader->readNextRead(seq);
+		}
+		if (nullptr != readAheadReader) {
+			return readAheadReader->readNextRead(seq);
+		}
+		return reader.readNextRead(seq);
+	};
+	BufferedMultiSeqOut readerOuts(pars.maxOpenOutputs, pars.outputBufferSize,
+			pars.outputTotalBufferSize);
+	if (pars.bgzfOutput) {
+		readerOuts.setBgzfOutput(pars.bgzfThreads, pars.bgzfLevel);
+	}
+	BufferedMultiSeqOut::Stats outputStats;
 	auto smallOpts = setUp.pars_.ioOptions_;
 	smallOpts.out_.outFilename_ = bib::files::make_path(badDir,"smallFragments").string();
-	SeqIO smallFragMentOut(smallOpts);
-	smallFragMentOut.openOut();
+	readerOuts.addReader("smallFragments", smallOpts);
 	auto startsWtihBadQualOpts = setUp.pars_.ioOptions_;
 	startsWtihBadQualOpts.out_.outFilename_ = bib::files::make_path(badDir,"startsWtihBadQual").string();
-	SeqOutput startsWtihBadQualOut(startsWtihBadQualOpts);
+	readerOuts.addReader("startsWtihBadQual", startsWtihBadQualOpts);
 
 	uint32_t smallFragmentCount = 0;
 	uint32_t startsWithBadQualCount = 0;
-	uint64_t maxReadSize = 0;
 	uint32_t count = 0;
-	MultiSeqIO readerOuts;
 
 	std::map<std::string, std::pair<uint32_t, uint32_t>> counts;
 	std::unordered_map<std::string, uint32_t>  failBarCodeCounts;
@@ -153,13 +191,6 @@ int SeekDeepRunner::extractor(const bib::progutils::CmdArgs & inputCommands) {
 				std::cout << "Inserting: " << mid.first << std::endl;
 			}
 			readerOuts.addReader(mid.first, midOpts);
-			if (pars.mothurExtract || pars.pyroExtract) {
-				auto flowExtractOutOpts = midOpts;
-				flowExtractOutOpts.out_.outFilename_ = bib::files::make_path(unfilteredByBarcodesFlowDir, mid.first + "_temp").string();
-				flowExtractOutOpts.outFormat_ = SeqIOOptions::outFormats::FLOW;
-				flowExtractOutOpts.out_.outExtention_ = ".dat";
-				readerOuts.addReader(mid.first + "flow", flowExtractOutOpts);
-			}
 		}
 	} else {
 		auto midOpts = setUp.pars_.ioOptions_;
@@ -168,13 +199,6 @@ int SeekDeepRunner::extractor(const bib::progutils::CmdArgs & inputCommands) {
 			std::cout << "Inserting: " << "all" << std::endl;
 		}
 		readerOuts.addReader("all", midOpts);
-		if (pars.mothurExtract || pars.pyroExtract) {
-			auto flowExtractOutOpts = midOpts;
-			flowExtractOutOpts.out_.outFilename_ = bib::files::make_path(unfilteredByBarcodesFlowDir, "all_temp").string();
-			flowExtractOutOpts.outFormat_ = SeqIOOptions::outFormats::FLOW;
-			flowExtractOutOpts.out_.outExtention_ = ".dat";
-			readerOuts.addReader(std::string("all") + "flow", flowExtractOutOpts);
-		}
 	}
 
 	if (pars.multiplex) {
@@ -204,11 +228,12 @@ int SeekDeepRunner::extractor(const bib::progutils::CmdArgs & inputCommands) {
 	std::unique_ptr<ReadCheckerOnKmerComp> compareInfoRev;
 	std::map<std::string, ReadCheckerOnKmerComp> compareInfos;
 	std::map<std::string, ReadCheckerOnKmerComp> compareInfosRev;
+	//the sequences of compareInfos for building the contamination kmer index
+	std::map<std::string, seqInfo> compareSeqs;
 
 
 
 	if (pars.screenForPossibleContamination) {
-		readVec::getMaxLength(compareObject, maxReadSize);
 
 		compareInfo = std::make_unique<ReadCheckerOnKmerComp>(kmerInfo(compareObject.seqBase_.seq_,
 				pars.contaminationKLen, false),pars.contaminationKLen, pars.kmerCutOff, true);
@@ -234,9 +259,9 @@ int SeekDeepRunner::extractor(const bib::progutils::CmdArgs & inputCommands) {
 				}
 
 				for (const auto & read : reads) {
-					readVec::getMaxLength(read, maxReadSize);
 					compareInfos.emplace(read.seqBase_.name_, ReadCheckerOnKmerComp(kmerInfo(read.seqBase_.seq_,
 							pars.contaminationKLen, false),pars.contaminationKLen, pars.kmerCutOff, false));
+					compareSeqs.emplace(read.seqBase_.name_, read.seqBase_);
 					auto rev = read;
 					rev.seqBase_.reverseComplementRead(true, true);
 					compareInfosRev.emplace(read.seqBase_.name_, ReadCheckerOnKmerComp(kmerInfo(rev.seqBase_.seq_,
@@ -245,6 +270,7 @@ int SeekDeepRunner::extractor(const bib::progutils::CmdArgs & inputCommands) {
 			}else{
 				compareInfos.emplace(compareObject.seqBase_.name_, ReadCheckerOnKmerComp(kmerInfo(compareObject.seqBase_.seq_,
 						pars.contaminationKLen, false),pars.contaminationKLen, pars.kmerCutOff, true));
+				compareSeqs.emplace(compareObject.seqBase_.name_, compareObject.seqBase_);
 				compareInfosRev.emplace(compareObject.seqBase_.name_, ReadCheckerOnKmerComp(kmerInfo(rev.seqBase_.seq_,
 						pars.contaminationKLen, false),pars.contaminationKLen, pars.kmerCutOff, true));
 			}
@@ -260,98 +286,292 @@ int SeekDeepRunner::extractor(const bib::progutils::CmdArgs & inputCommands) {
 		readerCon.openIn();
 		auto reads = readerCon.readAllReads<readObject>();
 		for (const auto & refSeq : reads) {
-			readVec::getMaxLength(refSeq, maxReadSize);
 			compareInfos.emplace(refSeq.seqBase_.name_, ReadCheckerOnKmerComp(kmerInfo(refSeq.seqBase_.seq_,
 					pars.contaminationKLen, false),pars.contaminationKLen, pars.kmerCutOff, true));
+			compareSeqs.emplace(refSeq.seqBase_.name_, refSeq.seqBase_);
 			auto rev = refSeq;
 			rev.seqBase_.reverseComplementRead(true, true);
 			compareInfosRev.emplace(refSeq.seqBase_.name_, ReadCheckerOnKmerComp(kmerInfo(rev.seqBase_.seq_,
 								pars.contaminationKLen, false),pars.contaminationKLen, pars.kmerCutOff, true));
 		}
 	}
+	//one kmer index of all the compare sequences so reads are only checked against the ones they could match
+	std::unique_ptr<ContaminationKmerIndex> contaminationIndex;
+	if (pars.contaminationKmerIndex && !compareSeqs.empty()) {
+		std::vector<seqInfo> refs;
+		for (const auto & compareSeq : compareSeqs) {
+			refs.emplace_back(compareSeq.second);
+		}
+		contaminationIndex = std::make_unique<ContaminationKmerIndex>(refs,
+				pars.contaminationKLen);
+	}
 	if(setUp.pars_.verbose_){
 		std::cout << bib::bashCT::boldGreen("Extracting on MIDs") << std::endl;
 	}
 
 	std::vector<size_t> readLens;
 
+	//the barcode pass is checkpointed so a killed run can be resumed, the input position is kept as the number of reads
+	//written out since the reads are written out in input order
+	auto checkpointFnp = bib::files::make_path(setUp.pars_.directoryName_, "extractorCheckpoint.json");
+	ExtractorCheckpoint checkpoint;
+	if (pars.resume) {
+		checkpoint = ExtractorCheckpoint::read(checkpointFnp);
+		count = checkpoint.readsProcessed_;
+		smallFragmentCount = checkpoint.smallFragmentCount_;
+		startsWithBadQualCount = checkpoint.startsWithBadQualCount_;
+		readsNotMatchedToBarcode = checkpoint.readsNotMatchedToBarcode_;
+		readsNotMatchedToBarcodePossContam = checkpoint.readsNotMatchedToBarcodePossContam_;
+		counts = checkpoint.counts_;
+		failBarCodeCounts = checkpoint.failBarCodeCounts_;
+		failBarCodeCountsPossibleContamination = checkpoint.failBarCodeCountsPossibleContamination_;
+		readLens = checkpoint.getReadLengths();
+		readerOuts.restore(checkpoint.outputSizes_);
+		if (setUp.pars_.verbose_) {
+			std::cout << "Resuming from checkpoint after " << checkpoint.readsProcessed_ << " reads";
+			if (checkpoint.barcodesDone_) {
+				std::cout << ", barcodes already determined";
+			}
+			std::cout << std::endl;
+		}
+	}
+	//only the lengths added since the last checkpoint need to be added to its length counts
+	size_t readLensCheckpointed = readLens.size();
+	auto writeCheckpoint = [&](bool barcodesDone) {
+		checkpoint.barcodesDone_ = barcodesDone;
+		checkpoint.readsProcessed_ = count;
+		checkpoint.smallFragmentCount_ = smallFragmentCount;
+		checkpoint.startsWithBadQualCount_ = startsWithBadQualCount;
+		checkpoint.readsNotMatchedToBarcode_ = readsNotMatchedToBarcode;
+		checkpoint.readsNotMatchedToBarcodePossContam_ = readsNotMatchedToBarcodePossContam;
+		checkpoint.counts_ = counts;
+		checkpoint.failBarCodeCounts_ = failBarCodeCounts;
+		checkpoint.failBarCodeCountsPossibleContamination_ = failBarCodeCountsPossibleContamination;
+		checkpoint.addReadLengths(readLens, readLensCheckpointed);
+		readLensCheckpointed = readLens.size();
+		checkpoint.outputSizes_ = readerOuts.checkpoint();
+		checkpoint.write(checkpointFnp);
+	};
 
-	while (reader.readNextRead(seq)) {
-		++count;
-		if (setUp.pars_.verbose_ && count % 50 == 0) {
-			std::cout << "\r" << count ;
-			std::cout.flush();
+	const uint32_t midNumThreads = pars.numThreads;
+	const bool extractingFlows = pars.mothurExtract || pars.pyroExtract;
+	//the flows of the reads written to each barcode's file, in the same order, for the filter pass
+	std::map<std::string, std::vector<std::shared_ptr<sffObject>>> barcodeFlows;
+	//per stage timing, the reader, each worker thread and the writer each get their own profile
+	StageTimingProfile readTiming;
+	StageTimingProfile writeTiming;
+	std::vector<StageTimingProfile> threadTimings(std::max<uint32_t>(1, pars.numThreads));
+	auto getTiming = [&pars](StageTimingProfile & profile) -> StageTimingProfile * {
+		return pars.timingProfile ? &profile : nullptr;
+	};
+	auto readBytes = [](const std::shared_ptr<readObject> & seq) -> uint64_t {
+		return seq->seqBase_.name_.size() + seq->seqBase_.seq_.size() + seq->seqBase_.qual_.size();
+	};
+	auto timedReadNextRead = [&](auto & in, std::shared_ptr<readObject> & seq) {
+		StageTimingProfile::Timer timer(getTiming(readTiming), "parsing");
+		bool read = in.readNextRead(seq);
+		timer.reads_ = read ? 1 : 0;
+		timer.bytesOut_ = read ? readBytes(seq) : 0;
+		return read;
+	};
+	//each thread gets it's own determinator
+	std::vector<std::unique_ptr<MidDeterminator>> threadDeterminators;
+	std::vector<MidDeterminator::MidDeterminePars> threadMDetPars(midNumThreads,
+			pars.mDetPars);
+	if (pars.multiplex) {
+		for (uint32_t t = 0; t < midNumThreads; ++t) {
+			threadDeterminators.emplace_back(std::make_unique<MidDeterminator>(mids));
+			threadDeterminators.back()->setAllowableMismatches(pars.barcodeErrors);
+			threadDeterminators.back()->setMidEndsRevComp(pars.midEndsRevComp);
+		}
+	}
+	//index of barcode variants so most reads only have to be compared against one barcode
+	std::unique_ptr<MidNeighborhoodIndex> midIndex;
+	std::vector<std::vector<std::unique_ptr<MidDeterminator>>> threadSingleMidDeterminators(midNumThreads);
+	std::vector<MidNeighborhoodIndex::Stats> threadMidIndexStats(midNumThreads);
+	if (pars.multiplex && pars.barcodeIndex) {
+		std::vector<std::pair<std::string, std::string>> midBarcodes;
+		for (const auto & mid : determinator->mids_) {
+			midBarcodes.emplace_back(mid.first, mid.second.bar_->motifOriginal_);
+		}
+		bib::sort(midBarcodes);
+		midIndex = std::make_unique<MidNeighborhoodIndex>(midBarcodes,
+				pars.barcodeErrors, pars.barcodeIndexIndel);
+		auto midNameCol = mids.getColPos("id");
+		for (uint32_t t = 0; t < midNumThreads; ++t) {
+			for (const auto & midName : midIndex->midNames_) {
+				table singleMidTab(mids.columnNames_);
+				for (const auto & row : mids.content_) {
+					if (row[midNameCol] == midName) {
+						singleMidTab.content_.emplace_back(row);
+					}
+				}
+				threadSingleMidDeterminators[t].emplace_back(std::make_unique<MidDeterminator>(singleMidTab));
+				threadSingleMidDeterminators[t].back()->setAllowableMismatches(pars.barcodeErrors);
+				threadSingleMidDeterminators[t].back()->setMidEndsRevComp(pars.midEndsRevComp);
+			}
 		}
+		std::ofstream collisionFile;
+		openTextFile(collisionFile, setUp.pars_.directoryName_ + "barcodeIndexCollisions.tab.txt",
+				".txt", pars.resume, false);
+		midIndex->writeCollisionReport(collisionFile);
+		if (setUp.pars_.verbose_) {
+			std::cout << "Indexed " << midIndex->numberOfVariants()
+					<< " barcode variants, " << midIndex->numberOfAmbiguousVariants()
+					<< " of them ambiguous" << std::endl;
+		}
+	}
 
-		if (pars.HMP) {
-			subStrToUpper(seq->seqBase_.seq_, 4, pars.primerLen);
+	struct MidResult {
+		std::pair<MidDeterminator::midPos, MidDeterminator::midPos> mid_;
+		bool startsWithBadQual_ = false;
+		bool smallFragment_ = false;
+		bool possibleContamination_ = false;
+		//only set when keeping the unfiltered reads in single pass mode
+		std::shared_ptr<readObject> unfilteredSeq_;
+		//only set when extracting flows
+		std::shared_ptr<sffObject> flows_;
+	};
+	//a read and the flows read in with it, the flows are grabbed from the reader as the read is read in so they stay with the
+	//read when the barcode step is done on several threads
+	struct FlowRead {
+		std::shared_ptr<readObject> seq_ = std::make_shared<readObject>();
+		std::shared_ptr<sffObject> flows_;
+	};
+
+	auto readNextRead = [&](std::shared_ptr<readObject> & seq) {
+		if (nullptr != bgzfReader) {
+			return timedReadNextRead(*bgzfReader, seq);
 		}
-		if (pars.trimTcag) {
-			if (checkForTcag(seq->seqBase_.seq_)) {
-				seq->trimFront(4);
+		if (nullptr != readAheadReader) {
+			return timedReadNextRead(*readAheadReader, seq);
+		}
+		return timedReadNextRead(reader, seq);
+	};
+
+	auto determineMid = [&](uint32_t threadNum, std::shared_ptr<readObject> & seq, MidResult & result) {
+		auto timing = getTiming(threadTimings[threadNum]);
+		{
+			StageTimingProfile::Timer timer(timing, "lowerCaseHandling", readBytes(seq));
+			if (pars.HMP) {
+				subStrToUpper(seq->seqBase_.seq_, 4, pars.primerLen);
+			}
+			if (pars.trimTcag) {
+				if (checkForTcag(seq->seqBase_.seq_)) {
+					seq->trimFront(4);
+				}
 			}
+			readVec::handelLowerCaseBases(seq, setUp.pars_.ioOptions_.lowerCaseBases_);
+			timer.bytesOut_ = readBytes(seq);
 		}
-		readVec::handelLowerCaseBases(seq, setUp.pars_.ioOptions_.lowerCaseBases_);
 
 		//possibly trim reads at low quality
 		if(pars.trimAtQual){
+			StageTimingProfile::Timer timer(timing, "qualityChecks", readBytes(seq));
 			readVecTrimmer::trimAtFirstQualScore(seq->seqBase_, pars.trimAtQualCutOff);
 			if(0 == len(*seq)){
-				startsWtihBadQualOut.openWrite(seq);
-				++startsWithBadQualCount;
-				continue;
+				result.startsWithBadQual_ = true;
+				return;
 			}
+			timer.bytesOut_ = readBytes(seq);
 		}
 
-		if (len(*seq) < pars.smallFragmentCutoff) {
-			smallFragMentOut.write(seq);
-			++smallFragmentCount;
-			continue;
+		{
+			StageTimingProfile::Timer timer(timing, "lengthChecks", readBytes(seq));
+			if (len(*seq) < pars.smallFragmentCutoff) {
+				result.smallFragment_ = true;
+				return;
+			}
+			timer.bytesOut_ = readBytes(seq);
 		}
-		readVec::getMaxLength(seq, maxReadSize);
 
-		std::pair<MidDeterminator::midPos, MidDeterminator::midPos> currentMid;
+		StageTimingProfile::Timer midTimer(timing, "midDetermination", readBytes(seq));
 		if (pars.multiplex) {
-			currentMid = determinator->fullDetermine(seq, pars.mDetPars);
-		} else {
-			currentMid = {MidDeterminator::midPos("all", 0, 0, 0),MidDeterminator::midPos("all", 0, 0, 0)};
-		}
-		if (seq->seqBase_.name_.find("_Comp") != std::string::npos) {
-			++counts[currentMid.first.midName_].second;
+			bool determined = false;
+			if (nullptr != midIndex) {
+				auto hit = midIndex->lookUp(seq->seqBase_.seq_);
+				threadMidIndexStats[threadNum].increase(hit.first);
+				if (MidNeighborhoodIndex::lookUpStatus::UNIQUE == hit.first) {
+					//keep the original in case the full determinator has to be used
+					auto original = seq->seqBase_;
+					result.mid_ = threadSingleMidDeterminators[threadNum][hit.second]->fullDetermine(seq, threadMDetPars[threadNum]);
+					if (result.mid_.first) {
+						determined = true;
+					} else {
+						++threadMidIndexStats[threadNum].uniqueFailed_;
+						seq->seqBase_ = original;
+					}
+				}
+			}
+			if (!determined) {
+				result.mid_ = threadDeterminators[threadNum]->fullDetermine(seq, threadMDetPars[threadNum]);
+			}
 		} else {
-			++counts[currentMid.first.midName_].first;
+			result.mid_ = {MidDeterminator::midPos("all", 0, 0, 0),MidDeterminator::midPos("all", 0, 0, 0)};
 		}
-		if (!currentMid.first) {
-			std::string unRecName = "unrecognizedBarcode_" + MidDeterminator::midPos::getFailureCaseName(currentMid.first.fCase_);
-			bool possibleContaimination = false;
-			if(pars.screenForPossibleContamination){
-				//this will check the read against all targets and their reverse complement so it will be a conservative estimate
-				//of whether or not this is contamination, if the read is still on by the end then that it means it's not
-				//considered possible contamination
-				if (pars.multipleTargets || pars.contaminationMutlipleCompare) {
-					for(const auto & compare : compareInfosRev){
+		midTimer.bytesOut_ = readBytes(seq);
+		midTimer.stop();
+		if (!result.mid_.first && pars.screenForPossibleContamination) {
+			StageTimingProfile::Timer timer(timing, "contaminationScreening", readBytes(seq));
+			//this will check the read against all targets and their reverse complement so it will be a conservative estimate
+			//of whether or not this is contamination, if the read is still on by the end then that it means it's not
+			//considered possible contamination
+			if (nullptr != contaminationIndex) {
+				contaminationIndex->checkRead(seq->seqBase_, compareInfos, compareInfosRev,
+						pars.kmerCutOff, true, true);
+			} else if (pars.multipleTargets || pars.contaminationMutlipleCompare) {
+				for(const auto & compare : compareInfosRev){
+					if(compare.second.checkRead(seq->seqBase_)){
+						break;
+					}
+				}
+				if(!seq->seqBase_.on_){
+					for(const auto & compare : compareInfos){
 						if(compare.second.checkRead(seq->seqBase_)){
 							break;
 						}
 					}
-					if(!seq->seqBase_.on_){
-						for(const auto & compare : compareInfos){
-							if(compare.second.checkRead(seq->seqBase_)){
-								break;
-							}
-						}
-					}
-				}else{
-					compareInfo->checkRead(seq->seqBase_);
-					if(!seq->seqBase_.on_){
-						compareInfoRev->checkRead(seq->seqBase_);
-					}
 				}
+			}else{
+				compareInfo->checkRead(seq->seqBase_);
 				if(!seq->seqBase_.on_){
-					possibleContaimination = true;
+					compareInfoRev->checkRead(seq->seqBase_);
 				}
 			}
-			if(possibleContaimination){
+			if(!seq->seqBase_.on_){
+				result.possibleContamination_ = true;
+			}
+		}
+	};
+
+	auto writeMidResult = [&](std::shared_ptr<readObject> & seq, MidResult & result) {
+		StageTimingProfile::Timer timer(getTiming(writeTiming), "writing", readBytes(seq));
+		timer.bytesOut_ = timer.bytesIn_;
+		++count;
+		if (setUp.pars_.verbose_ && count % 50 == 0) {
+			std::cout << "\r" << count ;
+			std::cout.flush();
+		}
+		if (result.startsWithBadQual_) {
+			readerOuts.openWrite("startsWtihBadQual", seq);
+			++startsWithBadQualCount;
+			return;
+		}
+		if (result.smallFragment_) {
+			readerOuts.openWrite("smallFragments", seq);
+			++smallFragmentCount;
+			return;
+		}
+
+		const auto & currentMid = result.mid_;
+		if (seq->seqBase_.name_.find("_Comp") != std::string::npos) {
+			++counts[currentMid.first.midName_].second;
+		} else {
+			++counts[currentMid.first.midName_].first;
+		}
+		if (!currentMid.first) {
+			std::string unRecName = "unrecognizedBarcode_" + MidDeterminator::midPos::getFailureCaseName(currentMid.first.fCase_);
+			if(result.possibleContamination_){
 				unRecName = "possible_contamination_" + unRecName;
 				++readsNotMatchedToBarcodePossContam;
 				MidDeterminator::increaseFailedBarcodeCounts(currentMid.first, failBarCodeCountsPossibleContamination);
@@ -361,19 +581,89 @@ int SeekDeepRunner::extractor(const bib::progutils::CmdArgs & inputCommands) {
 			}
 			readerOuts.openWrite(unRecName, seq);
 		}else{
-			readLens.emplace_back(len(*seq));
-			/**@todo need to reorient the reads here before outputing if that's needed*/
-			readerOuts.openWrite(currentMid.first.midName_, seq);
-			if (pars.mothurExtract || pars.pyroExtract){
-				readerOuts.openWriteFlow(currentMid.first.midName_ + "flow", *reader.in_.lastSffRead_);
+			if (pars.singlePass) {
+				//the length cut offs were determined from the first reads so lengths only need to be kept when doing two passes
+				if (nullptr != result.unfilteredSeq_) {
+					readerOuts.openWrite(currentMid.first.midName_, result.unfilteredSeq_);
+				}
+			} else {
+				readLens.emplace_back(len(*seq));
+				/**@todo need to reorient the reads here before outputing if that's needed*/
+				readerOuts.openWrite(currentMid.first.midName_, seq);
+				if (extractingFlows) {
+					barcodeFlows[currentMid.first.midName_].emplace_back(result.flows_);
+				}
 			}
 		}
+	};
+
+	auto writeMidResultAndCheckpoint = [&](std::shared_ptr<readObject> & seq, MidResult & result) {
+		writeMidResult(seq, result);
+		if (pars.checkpointEvery > 0 && 0 == count % pars.checkpointEvery) {
+			writeCheckpoint(false);
+		}
+	};
+
+	auto readNextFlowRead = [&](FlowRead & read) {
+		if (!readNextRead(read.seq_)) {
+			return false;
+		}
+		if (extractingFlows) {
+			read.flows_ = std::make_shared<sffObject>(*reader.in_.lastSffRead_);
+		}
+		return true;
+	};
+	auto determineFlowReadMid = [&](uint32_t threadNum, FlowRead & read, MidResult & result) {
+		determineMid(threadNum, read.seq_, result);
+		result.flows_ = std::move(read.flows_);
+	};
+	auto writeFlowReadMidResult = [&](FlowRead & read, MidResult & result) {
+		writeMidResultAndCheckpoint(read.seq_, result);
+	};
+	ReadBatchPipeline<FlowRead, MidResult> midPipeline(midNumThreads, pars.batchSize);
+	//reads read in to determine length cut offs when extracting in a single pass
+	std::vector<std::shared_ptr<readObject>> sampledReads;
+	if (pars.singlePass) {
+		auto seq = std::make_shared<readObject>();
+		while (sampledReads.size() < pars.singlePassSampleSize && readInputRead(seq)) {
+			sampledReads.emplace_back(std::make_shared<readObject>(*seq));
+			MidResult result;
+			determineMid(0, seq, result);
+			if (!result.startsWithBadQual_ && !result.smallFragment_ && result.mid_.first) {
+				readLens.emplace_back(len(*seq));
+			}
+		}
+		//these reads will be determined again
+		threadMidIndexStats.front() = MidNeighborhoodIndex::Stats();
+	} else if (!checkpoint.barcodesDone_) {
+		if (checkpoint.readsProcessed_ > 0) {
+			//SeqInput doesn't give a position to seek to (and gzipped input can't seek) so skip the reads already done by reading them
+			auto seq = std::make_shared<readObject>();
+			ReadAheadSeqInput::RecordView record;
+			for (uint64_t skipped = 0; skipped < checkpoint.readsProcessed_; ++skipped) {
+				//the read ahead input can skip reads without copying them out of its buffers
+				bool read = nullptr != readAheadReader ?
+						readAheadReader->readNextRecord(record) : readInputRead(seq);
+				if (!read) {
+					std::stringstream ss;
+					ss << __PRETTY_FUNCTION__ << ", error: input has fewer reads than the "
+							<< checkpoint.readsProcessed_ << " already processed according to "
+							<< checkpointFnp << "\n";
+					throw std::runtime_error { ss.str() };
+				}
+			}
+		}
+		midPipeline.run(readNextFlowRead, determineFlowReadMid, writeFlowReadMidResult);
+		if (setUp.pars_.verbose_) {
+			std::cout << std::endl;
+		}
+		//close mid outs;
+		readerOuts.closeOutAll();
+		//a resumed run after this point goes straight to filtering
+		if (pars.checkpointEvery > 0 || pars.resume) {
+			writeCheckpoint(true);
+		}
 	}
-	if (setUp.pars_.verbose_) {
-		std::cout << std::endl;
-	}
-	//close mid outs;
-	readerOuts.closeOutAll();
 	//if no length was supplied, calculate a min and max length off of the median read length
 	auto readLenMedian = vectorMedianRef(readLens);
 	auto lenStep = readLenMedian * .20;
@@ -390,14 +680,7 @@ int SeekDeepRunner::extractor(const bib::progutils::CmdArgs & inputCommands) {
 		pars.maxLength = ::round(readLenMedian + lenStep);
 	}
 
-	struct lenCutOffs {
-		lenCutOffs(uint32_t minLen, uint32_t maxLen, bool mark = true):
-			minLenChecker_(ReadCheckerLenAbove(minLen, mark)),
-			maxLenChecker_(ReadCheckerLenBelow(maxLen, mark)){
-		}
-		ReadCheckerLenAbove minLenChecker_;
-		ReadCheckerLenBelow maxLenChecker_;
-	};
+	typedef ExtractorReadFilter::LenCutOffs lenCutOffs;
 
 
 	std::map<std::string, lenCutOffs> multipleLenCutOffs;
@@ -459,7 +742,7 @@ int SeekDeepRunner::extractor(const bib::progutils::CmdArgs & inputCommands) {
 	std::ofstream renameKeyFile;
 	if (pars.rename) {
 		openTextFile(renameKeyFile, setUp.pars_.directoryName_ + "renameKey.tab.txt",
-				".tab.txt", false, false);
+				".tab.txt", pars.resume, false);
 		renameKeyFile << "originalName\tnewName\n";
 	}
 
@@ -474,9 +757,6 @@ int SeekDeepRunner::extractor(const bib::progutils::CmdArgs & inputCommands) {
 		}
 	}
 
-	auto barcodeFiles = bib::files::listAllFiles(unfilteredByBarcodesDir, false,
-			VecStr { });
-
 	// create aligner for primer identification
 	if(setUp.pars_.debug_){
 		std::cout << bib::bashCT::boldGreen("Creating Scoring Matrix: Start") << std::endl;
@@ -488,91 +768,78 @@ int SeekDeepRunner::extractor(const bib::progutils::CmdArgs & inputCommands) {
 	bool countEndGaps = true;
 	if(setUp.pars_.debug_){
 		std::cout << bib::bashCT::boldRed("Creating Scoring Matrix: Stop") << std::endl;
-		std::cout << bib::bashCT::boldGreen("Determining Max Read Size: Start") << std::endl;
-	}
-	//to avoid allocating an extremely large aligner matrix;
-	if(maxReadSize > 1000){
-		auto maxPrimerSize = pDetermine.getMaxPrimerSize();
-		if(setUp.pars_.debug_){
-			std::cout << bib::bashCT::boldBlack("maxPrimerSize: ") << maxPrimerSize << std::endl;
-		}
-		maxReadSize =  maxPrimerSize * 4 + pars.mDetPars.variableStop_;
+		std::cout << bib::bashCT::boldGreen("Creating Aligner: Start") << std::endl;
 	}
+	//the aligner is only used on the primer search windows at the ends of the reads so it's sized from the primers,
+	//so it doesn't need the max read length from a pass over the reads and never allocates an extremely large matrix
+	auto maxPrimerSize = pDetermine.getMaxPrimerSize();
+	uint64_t maxAlignSize = maxPrimerSize * 4 + pars.mDetPars.variableStop_;
 	if(setUp.pars_.debug_){
-		std::cout << bib::bashCT::boldRed("Determining Max Read Size: Stop") << std::endl;
-		std::cout << bib::bashCT::boldGreen("Creating Aligner: Start") << std::endl;
-		std::cout << bib::bashCT::boldBlack("max read size: " ) << maxReadSize << std::endl;
+		std::cout << bib::bashCT::boldBlack("maxPrimerSize: ") << maxPrimerSize << std::endl;
+		std::cout << bib::bashCT::boldBlack("max align size: " ) << maxAlignSize << std::endl;
 	}
 
-	aligner alignObj = aligner(maxReadSize, gapPars, scoreMatrix, emptyMaps,
+	aligner alignObj = aligner(maxAlignSize, gapPars, scoreMatrix, emptyMaps,
 			setUp.pars_.qScorePars_, countEndGaps, false);
 	if(setUp.pars_.debug_){
 		std::cout << bib::bashCT::boldRed("Creating Aligner: Stop") << std::endl;
 		std::cout << bib::bashCT::boldGreen("Reading In Previous Alignments: Start") << std::endl;
 	}
 	alignObj.processAlnInfoInput(setUp.pars_.alnInfoDirName_);
+	//each thread gets it's own aligner and primer determinator
+	bibseq::concurrent::AlignerPool alnPool(alignObj, pars.numThreads);
+	alnPool.initAligners();
+	if (setUp.pars_.writingOutAlnInfo_) {
+		alnPool.outAlnDir_ = setUp.pars_.outAlnInfoDirName_;
+	}
+	std::vector<decltype(alnPool.popAligner())> threadAligners;
+	for (uint32_t t = 0; t < pars.numThreads; ++t) {
+		threadAligners.emplace_back(alnPool.popAligner());
+	}
+	std::vector<PrimerDeterminator> threadPDetermines(pars.numThreads, pDetermine);
+	//kmer index and/or edit distance screen of the primers so only primers that could match the read are aligned
+	std::unique_ptr<PrimerKmerIndex> primerIndex;
+	std::unique_ptr<PrimerEditScreen> forwardPrimerScreen;
+	std::unique_ptr<PrimerEditScreen> reversePrimerScreen;
+	std::vector<std::unique_ptr<ShortlistPrimerDeterminator>> threadShortlistPDetermines;
+	if ((pars.primerKmerIndex || pars.primerEditScreen) && !pars.noForwardPrimer) {
+		PrimersAndMids ids(pars.idFilename);
+		if (pars.primerKmerIndex) {
+			primerIndex = std::make_unique<PrimerKmerIndex>(ids, pars.primerKmerLen);
+		}
+		if (pars.primerEditScreen) {
+			forwardPrimerScreen = PrimerEditScreen::forwardPrimerScreen(ids);
+			reversePrimerScreen = PrimerEditScreen::reversePrimerScreen(ids);
+		}
+		for (uint32_t t = 0; t < pars.numThreads; ++t) {
+			threadShortlistPDetermines.emplace_back(
+					std::make_unique<ShortlistPrimerDeterminator>(primerTable,
+							threadPDetermines[t], pars.primerKmerIndexCheckEvery,
+							primerIndex.get(), forwardPrimerScreen.get(),
+							reversePrimerScreen.get()));
+		}
+	}
+
+	typedef ExtractorReadFilter::Result FilterResult;
 	if(setUp.pars_.debug_){
 		std::cout << bib::bashCT::boldRed("Reading In Previous Alignments: Stop") << std::endl;
-		std::cout << bib::bashCT::boldGreen("Creating Extractor Stats: Start") << std::endl;
 	}
 	bfs::path smallDir = "";
 	if (pars.filterOffSmallReadCounts) {
-		smallDir = bib::files::makeDir(setUp.pars_.directoryName_, bib::files::MkdirPar("smallReadCounts", false));
+		smallDir = makeOutDir(setUp.pars_.directoryName_, "smallReadCounts");
 	}
 
-	ExtractionStator stats(count, readsNotMatchedToBarcode,
-			readsNotMatchedToBarcodePossContam, smallFragmentCount);
-	if(setUp.pars_.debug_){
-		std::cout << bib::bashCT::boldRed("Creating Extractor Stats: Stop") << std::endl;
-	}
+	//stats are tallied as reads are filtered and added to the ExtractionStator once all the totals are known
+	ExtractionTally statsTally;
 	std::map<std::string, uint32_t> goodCounts;
+	//the flows of the good reads for the pyro files, the header needs the read count so they're held until the barcode is done
+	std::map<std::string, std::vector<std::shared_ptr<sffObject>>> pyroFlows;
 
-	for (const auto & f : barcodeFiles) {
-		auto barcodeName = bfs::basename(f.first.string());
-		if ((counts[barcodeName].first + counts[barcodeName].second) == 0
-				&& pars.multiplex) {
-			//no reads extracted for barcode so skip filtering step
-			continue;
-		}
-
-		if (pars.filterOffSmallReadCounts
-				&& (counts[barcodeName].first + counts[barcodeName].second)
-						<= pars.smallExtractReadCount) {
-			auto barcodeOpts = setUp.pars_.ioOptions_;
-			barcodeOpts.firstName_ = f.first.string();
-			barcodeOpts.inFormat_ = SeqIOOptions::getInFormat(bib::files::getExtension(f.first.string()));
-			barcodeOpts.out_.outFilename_ = bib::files::make_path(smallDir,  barcodeName).string();
-			SeqIO barcodeIn(barcodeOpts);
-			barcodeIn.openIn();
-			readObject read;
-			while (barcodeIn.readNextRead(read)) {
-				barcodeIn.openWrite(read);
-			}
-			continue;
-		}
-		if (setUp.pars_.verbose_) {
-			if (pars.multiplex) {
-				std::cout
-						<< bib::bashCT::boldGreen("Filtering on barcode: " + barcodeName)
-						<< std::endl;
-			} else {
-				std::cout << bib::bashCT::boldGreen("Filtering") << std::endl;
-			}
-		}
-
-		auto barcodeOpts = setUp.pars_.ioOptions_;
-		barcodeOpts.firstName_ = f.first.string();
-		barcodeOpts.inFormat_ = SeqIOOptions::getInFormat(
-				bib::files::getExtension(f.first.string()));
-		SeqIO barcodeIn(barcodeOpts);
-		barcodeIn.openIn();
-
-		//create outputs
-		MultiSeqIO midReaderOuts;
+	auto addFilterOutputs = [&](BufferedMultiSeqOut & outs, const std::string & barcodeName) {
 		auto unrecogPrimerOutOpts = setUp.pars_.ioOptions_;
 		unrecogPrimerOutOpts.out_.outFilename_ = bib::files::make_path(unrecognizedPrimerDir
 				,barcodeName).string();
-		midReaderOuts.addReader("unrecognized", unrecogPrimerOutOpts);
+		outs.addReader(barcodeName + "unrecognized", unrecogPrimerOutOpts);
 
 		for (const auto & primerName : getVectorOfMapKeys(pDetermine.primers_)) {
 			std::string fullname = primerName;
@@ -584,293 +851,335 @@ int SeekDeepRunner::extractor(const bib::progutils::CmdArgs & inputCommands) {
 			//bad out
 			auto badDirOutOpts = setUp.pars_.ioOptions_;
 			badDirOutOpts.out_.outFilename_ =bib::files::make_path( badDir, fullname).string();
-			midReaderOuts.addReader(fullname + "bad", badDirOutOpts);
+			outs.addReader(fullname + "bad", badDirOutOpts);
 			//good out
 			auto goodDirOutOpts = setUp.pars_.ioOptions_;
 			goodDirOutOpts.out_.outFilename_ = setUp.pars_.directoryName_ + fullname;
-			midReaderOuts.addReader(fullname + "good", goodDirOutOpts);
+			outs.addReader(fullname + "good", goodDirOutOpts);
 			//contamination out
 			if (pars.screenForPossibleContamination) {
 				auto contamOutOpts = setUp.pars_.ioOptions_;
 				contamOutOpts.out_.outFilename_ = bib::files::make_path(contaminationDir, fullname).string();
-				midReaderOuts.addReader(fullname + "contamination", contamOutOpts);
+				outs.addReader(fullname + "contamination", contamOutOpts);
 			}
-			if (pars.mothurExtract || pars.pyroExtract) {
+			//flows for the good reads are written straight to the final flow files
+			if (pars.mothurExtract) {
 				auto flowExtractOutOpts = setUp.pars_.ioOptions_;
-				flowExtractOutOpts.out_.outFilename_ = setUp.pars_.directoryName_ + fullname + "_temp";
+				flowExtractOutOpts.out_.outFilename_ = setUp.pars_.directoryName_ + fullname;
 				flowExtractOutOpts.outFormat_ = SeqIOOptions::outFormats::FLOW;
-				flowExtractOutOpts.out_.outExtention_ = ".dat";
-				midReaderOuts.addReader(fullname + "flow", flowExtractOutOpts);
+				flowExtractOutOpts.out_.outExtention_ = ".flow";
+				outs.addReader(fullname + "mothurFlow", flowExtractOutOpts);
 			}
 		}
+	};
 
-		uint32_t barcodeCount = 1;
-		bib::ProgressBar pbar(
-				counts[barcodeName].first + counts[barcodeName].second);
-		pbar.progColors_ = pbar.RdYlGn_;
-		std::string readFlows = "";
-		std::ifstream inFlowFile;
-		if(pars.mothurExtract || pars.pyroExtract){
-			inFlowFile.open(bib::files::make_path(unfilteredByBarcodesFlowDir, barcodeName + "_temp.dat").string());
-		}
-
-
-
-		while (barcodeIn.readNextRead(seq)) {
-			//std::cout << barcodeCount << std::endl;
-			std::getline(inFlowFile, readFlows);
-			if(setUp.pars_.verbose_){
-				pbar.outputProgAdd(std::cout, 1, true);
-			}
-			++barcodeCount;
-			//filter on primers
-			//forward
-			std::string primerName = "";
-			bool foundInReverse = false;
-			if (pars.noForwardPrimer) {
-				primerName = primerTable.content_.front()[primerTable.getColPos(
-						"geneName")];
-			} else {
-				if (pars.multiplex) {
-
-					primerName = pDetermine.determineForwardPrimer(seq, 0, alignObj,
-							pars.fPrimerErrors, !pars.forwardPrimerToUpperCase);
-
-					if (primerName == "unrecognized" && pars.mDetPars.checkComplement_) {
-						primerName = pDetermine.determineWithReversePrimer(seq, 0,
-								alignObj, pars.fPrimerErrors, !pars.forwardPrimerToUpperCase);
-						if (seq->seqBase_.on_) {
-							foundInReverse = true;
-						}
-					}
+	//the same filtering as extractorPairedEnd
+	ExtractorReadFilter readFilter(pars, primerTable, compareInfo.get(),
+			compareInfoRev.get(), compareInfos, compareInfosRev,
+			contaminationIndex.get(), multipleLenCutOffs, nullptr, nChecker,
+			*qualChecker);
+	auto filterRead = [&](uint32_t threadNum, std::shared_ptr<readObject> & seq,
+			const std::string & barcodeName, FilterResult & result) {
+		readFilter.filter(seq, barcodeName, *threadAligners[threadNum],
+				threadPDetermines[threadNum],
+				threadShortlistPDetermines.empty() ? nullptr : threadShortlistPDetermines[threadNum].get(),
+				getTiming(threadTimings[threadNum]), result);
+	};
 
+	uint32_t mothurExtractFlowNum = 800;
+	if (pars.maxFlowCutoff == 720) {
+		mothurExtractFlowNum = 800;
+	} else if (pars.maxFlowCutoff <= 400) {
+		mothurExtractFlowNum = 400;
+	}
+	auto writeFilterResult = [&](std::shared_ptr<readObject> & seq,
+			const std::string & barcodeName, FilterResult & result,
+			BufferedMultiSeqOut & outs, const std::shared_ptr<sffObject> & readFlows) {
+		StageTimingProfile::Timer timer(getTiming(writeTiming), "writing", readBytes(seq));
+		timer.bytesOut_ = timer.bytesIn_;
+		if (result.failedForward_) {
+			statsTally.increaseFailedForward(barcodeName, seq->seqBase_.name_);
+			outs.openWrite(barcodeName + "unrecognized", seq);
+			return;
+		}
+		const auto & fullname = result.fullname_;
+		statsTally.increaseCounts(fullname, seq->seqBase_.name_, result.case_);
+		if (ExtractionStator::extractCase::CONTAMINATION == result.case_) {
+			outs.openWrite(fullname + "contamination", seq);
+		} else if (ExtractionStator::extractCase::GOOD == result.case_) {
+			if (pars.rename) {
+				std::string oldName = bib::replaceString(seq->seqBase_.name_, "_Comp", "");
+				if (pars.singlePass) {
+					//the number of reads per barcode isn't known ahead of time so the numbers aren't padded
+					seq->seqBase_.name_ = fullname + "."
+							+ estd::to_string(goodCounts[fullname]);
 				} else {
-					uint32_t start = pars.mDetPars.variableStop_;
-//					if(setUp.pars_.verbose_){
-//						std::cout << "Determining primer" << std::endl;
-//					}
-
-					primerName = pDetermine.determineForwardPrimer(seq, start, alignObj,
-							pars.fPrimerErrors, !pars.forwardPrimerToUpperCase);
-					if (primerName == "unrecognized" && pars.mDetPars.checkComplement_) {
-						primerName = pDetermine.determineWithReversePrimer(seq, start,
-								alignObj, pars.fPrimerErrors, !pars.forwardPrimerToUpperCase);
-						if (seq->seqBase_.on_) {
-							foundInReverse = true;
-						}
-					}
+					seq->seqBase_.name_ = fullname + "."
+							+ leftPadNumStr(goodCounts[fullname],
+									counts[barcodeName].first + counts[barcodeName].second);
 				}
-
-				if (!seq->seqBase_.on_) {
-					stats.increaseFailedForward(barcodeName, seq->seqBase_.name_);
-					midReaderOuts.openWrite("unrecognized", seq);
-					continue;
+				if (bib::containsSubString(oldName, "_Comp")) {
+					seq->seqBase_.name_.append("_Comp");
 				}
+				renameKeyFile << oldName << "\t" << seq->seqBase_.name_ << "\n";
 			}
-			std::string fullname = primerName;
-			if (pars.multiplex) {
-				fullname += barcodeName;
-			} else if (pars.sampleName != "") {
-				fullname += pars.sampleName;
-			}
-
-
-
-			//look for possible contamination
-			if (pars.screenForPossibleContamination) {
-				if (pars.multipleTargets) {
-					if (compareInfos.find(primerName) != compareInfos.end()) {
-						if (foundInReverse) {
-							compareInfosRev.at(primerName).checkRead(seq->seqBase_);
-						} else {
-							compareInfos.at(primerName).checkRead(seq->seqBase_);
-						}
-
-						if (!seq->seqBase_.on_) {
-							stats.increaseCounts(fullname, seq->seqBase_.name_,
-									ExtractionStator::extractCase::CONTAMINATION);
-							midReaderOuts.openWrite(fullname + "contamination", seq);
-							continue;
-						}
-					} else {
-						std::stringstream ss;
-						ss
-								<< "Error in screening for contamination, multiple targets turned on but no contamination found for "
-								<< primerName << std::endl;
-						ss << "Options are: "
-								<< vectorToString(getVectorOfMapKeys(compareInfos), ",")
-								<< std::endl;
-						throw std::runtime_error{ss.str()};
-					}
-				} else {
-
-					if(pars.contaminationMutlipleCompare){
-						//if it passes at least one of the multiple compares given in compareSeq filename
-						if (foundInReverse) {
-							for(const auto & compares : compareInfosRev){
-								if(compares.second.checkRead(seq->seqBase_)){
-									break;
-								}
-							}
-						}else{
-							for(const auto & compares : compareInfos){
-								if(compares.second.checkRead(seq->seqBase_)){
-									break;
-								}
-							}
-						}
-					}else{
-						if (foundInReverse) {
-							compareInfoRev->checkRead(seq->seqBase_);
-						} else {
-							compareInfo->checkRead(seq->seqBase_);
-						}
-					}
-					if (!seq->seqBase_.on_) {
-						stats.increaseCounts(fullname, seq->seqBase_.name_,
-								ExtractionStator::extractCase::CONTAMINATION);
-						midReaderOuts.openWrite(fullname + "contamination", seq);
-						continue;
-					}
+			outs.openWrite(fullname + "good", seq);
+			if (pars.mothurExtract) {
+				if (0 == goodCounts[fullname]) {
+					outs.openWrite(fullname + "mothurFlow", estd::to_string(mothurExtractFlowNum));
 				}
+				outs.openWriteFlow(fullname + "mothurFlow", *readFlows);
 			}
+			if (pars.pyroExtract) {
+				pyroFlows[fullname].emplace_back(readFlows);
+			}
+			++goodCounts[fullname];
+		} else {
+			if (ExtractionStator::extractCase::BADREVERSE == result.case_) {
+				seq->seqBase_.name_.append("_badReverse");
+			}
+			outs.openWrite(fullname + "bad", seq);
+		}
+	};
 
-			//min len
-			multipleLenCutOffs.at(primerName).minLenChecker_.checkRead(seq->seqBase_);
-
-			if (!seq->seqBase_.on_) {
-				stats.increaseCounts(fullname, seq->seqBase_.name_,
-						ExtractionStator::extractCase::MINLENBAD);
-				midReaderOuts.openWrite(fullname + "bad", seq);
+	if (!pars.singlePass) {
+		auto barcodeFiles = bib::files::listAllFiles(unfilteredByBarcodesDir, false,
+				VecStr { });
+		for (const auto & f : barcodeFiles) {
+			auto barcodeName = bfs::basename(f.first.string());
+			if (Bgzf::isBgzf(f.first)) {
+				//strip the .gz and then the read extension
+				barcodeName = bfs::basename(f.first.stem());
+			}
+			if ((counts[barcodeName].first + counts[barcodeName].second) == 0
+					&& pars.multiplex) {
+				//no reads extracted for barcode so skip filtering step
 				continue;
 			}
 
-			//reverse
-			if (!pars.noReversePrimer) {
-				if (foundInReverse) {
-					pDetermine.checkForForwardPrimerInRev(seq, primerName, alignObj,
-							pars.rPrimerErrors, !pars.reversePrimerToUpperCase,
-							pars.mDetPars.variableStop_, false);
-				} else {
-					pDetermine.checkForReversePrimer(seq, primerName, alignObj,
-							pars.rPrimerErrors, !pars.reversePrimerToUpperCase,
-							pars.mDetPars.variableStop_, false);
-				}
-
-				if (!seq->seqBase_.on_) {
-					stats.increaseCounts(fullname, seq->seqBase_.name_,
-							ExtractionStator::extractCase::BADREVERSE);
-					seq->seqBase_.name_.append("_badReverse");
-					midReaderOuts.openWrite(fullname + "bad", seq);
+			if (pars.filterOffSmallReadCounts
+					&& (counts[barcodeName].first + counts[barcodeName].second)
+							<= pars.smallExtractReadCount) {
+				auto barcodeOpts = setUp.pars_.ioOptions_;
+				barcodeOpts.firstName_ = f.first.string();
+				barcodeOpts.out_.outFilename_ = bib::files::make_path(smallDir,  barcodeName).string();
+				if (BgzfSeqInput::isBgzfInput(barcodeOpts)) {
+					BgzfSeqInput barcodeIn(barcodeOpts, pars.bgzfThreads);
+					BgzfSeqOutput smallOut(barcodeOpts, pars.bgzfThreads, pars.bgzfLevel);
+					readObject read;
+					while (barcodeIn.readNextRead(read)) {
+						smallOut.openWrite(read);
+					}
+					smallOut.closeOut();
 					continue;
 				}
-			}
-			//min len again becuase the reverse primer search trims to the reverse primer so it could be short again
-			multipleLenCutOffs.at(primerName).minLenChecker_.checkRead(
-										seq->seqBase_);
-
-			if (!seq->seqBase_.on_) {
-				stats.increaseCounts(fullname, seq->seqBase_.name_,
-						ExtractionStator::extractCase::MINLENBAD);
-				midReaderOuts.openWrite(fullname + "bad", seq);
+				barcodeOpts.inFormat_ = SeqIOOptions::getInFormat(bib::files::getExtension(f.first.string()));
+				SeqIO barcodeIn(barcodeOpts);
+				barcodeIn.openIn();
+				readObject read;
+				while (barcodeIn.readNextRead(read)) {
+					barcodeIn.openWrite(read);
+				}
 				continue;
 			}
-
-			//if found in the reverse direction need to re-orient now
-			if (foundInReverse) {
-				seq->seqBase_.reverseComplementRead(true, true);
-			}
-
-			//contains n
-			nChecker.checkRead(seq->seqBase_);
-			if (!seq->seqBase_.on_) {
-				stats.increaseCounts(fullname, seq->seqBase_.name_,
-						ExtractionStator::extractCase::CONTAINSNS);
-				midReaderOuts.openWrite(fullname + "bad", seq);
-				continue;
+			if (setUp.pars_.verbose_) {
+				if (pars.multiplex) {
+					std::cout
+							<< bib::bashCT::boldGreen("Filtering on barcode: " + barcodeName)
+							<< std::endl;
+				} else {
+					std::cout << bib::bashCT::boldGreen("Filtering") << std::endl;
+				}
 			}
 
-			//max len
-			multipleLenCutOffs.at(primerName).maxLenChecker_.checkRead(seq->seqBase_);
-
-			if (!seq->seqBase_.on_) {
-				stats.increaseCounts(fullname, seq->seqBase_.name_,
-						ExtractionStator::extractCase::MAXLENBAD);
-				midReaderOuts.openWrite(fullname + "bad", seq);
-				continue;
+			auto barcodeOpts = setUp.pars_.ioOptions_;
+			barcodeOpts.firstName_ = f.first.string();
+			std::unique_ptr<SeqIO> barcodeIn;
+			std::unique_ptr<BgzfSeqInput> bgzfBarcodeIn;
+			if (BgzfSeqInput::isBgzfInput(barcodeOpts)) {
+				bgzfBarcodeIn = std::make_unique<BgzfSeqInput>(barcodeOpts, pars.bgzfThreads);
+				bgzfBarcodeIn->openIn();
+			} else {
+				barcodeOpts.inFormat_ = SeqIOOptions::getInFormat(
+						bib::files::getExtension(f.first.string()));
+				barcodeIn = std::make_unique<SeqIO>(barcodeOpts);
+				barcodeIn->openIn();
 			}
 
-
-			//quality
-			qualChecker->checkRead(seq->seqBase_);
-
-			if (!seq->seqBase_.on_) {
-				stats.increaseCounts(fullname, seq->seqBase_.name_,
-						ExtractionStator::extractCase::QUALITYFAILED);
-				midReaderOuts.openWrite(fullname + "bad", seq);
-				continue;
+			//create outputs
+			BufferedMultiSeqOut midReaderOuts(pars.maxOpenOutputs, pars.outputBufferSize,
+					pars.outputTotalBufferSize);
+			if (pars.bgzfOutput) {
+				midReaderOuts.setBgzfOutput(pars.bgzfThreads, pars.bgzfLevel);
 			}
-
-			if (seq->seqBase_.on_) {
-				stats.increaseCounts(fullname, seq->seqBase_.name_,
-						ExtractionStator::extractCase::GOOD);
-				if (pars.rename) {
-					std::string oldName = bib::replaceString(seq->seqBase_.name_, "_Comp", "");
-					seq->seqBase_.name_ = fullname + "."
-							+ leftPadNumStr(goodCounts[fullname],
-									counts[barcodeName].first + counts[barcodeName].second);
-					if (bib::containsSubString(oldName, "_Comp")) {
-						seq->seqBase_.name_.append("_Comp");
+			addFilterOutputs(midReaderOuts, barcodeName);
+
+			uint32_t barcodeCount = 1;
+			bib::ProgressBar pbar(
+					counts[barcodeName].first + counts[barcodeName].second);
+			pbar.progColors_ = pbar.RdYlGn_;
+			//the barcode's reads are read back in the order they were written so their flows are in the same order
+			const auto & flows = barcodeFlows[barcodeName];
+			uint64_t flowsPos = 0;
+			std::shared_ptr<sffObject> noFlows;
+
+			auto readNextBarcodeRead = [&](std::shared_ptr<readObject> & seq) {
+				if (nullptr != bgzfBarcodeIn) {
+					StageTimingProfile::Timer timer(getTiming(readTiming), "parsing");
+					bool read = bgzfBarcodeIn->readNextRead(seq);
+					timer.reads_ = read ? 1 : 0;
+					timer.bytesOut_ = read ? readBytes(seq) : 0;
+					return read;
+				}
+				return timedReadNextRead(*barcodeIn, seq);
+			};
+			auto filterBarcodeRead = [&](uint32_t threadNum, std::shared_ptr<readObject> & seq, FilterResult & result) {
+				filterRead(threadNum, seq, barcodeName, result);
+			};
+			auto writeBarcodeFilterResult = [&](std::shared_ptr<readObject> & seq, FilterResult & result) {
+				//std::cout << barcodeCount << std::endl;
+				if(setUp.pars_.verbose_){
+					pbar.outputProgAdd(std::cout, 1, true);
+				}
+				++barcodeCount;
+				if (extractingFlows) {
+					if (flowsPos >= flows.size()) {
+						std::stringstream ss;
+						ss << __PRETTY_FUNCTION__ << ", error: more reads than flows for barcode "
+								<< barcodeName << "\n";
+						throw std::runtime_error { ss.str() };
 					}
-					renameKeyFile << oldName << "\t" << seq->seqBase_.name_ << "\n";
+					writeFilterResult(seq, barcodeName, result, midReaderOuts, flows[flowsPos]);
+					++flowsPos;
+				} else {
+					writeFilterResult(seq, barcodeName, result, midReaderOuts, noFlows);
 				}
-				midReaderOuts.openWrite(fullname + "good", seq);
-				if(pars.mothurExtract || pars.pyroExtract){
-					midReaderOuts.openWrite(fullname + "flow", readFlows);
+			};
+
+			ReadBatchPipeline<std::shared_ptr<readObject>, FilterResult> filterPipeline(
+					pars.numThreads, pars.batchSize);
+			filterPipeline.readFactory_ = []() {return std::make_shared<readObject>();};
+			filterPipeline.run(readNextBarcodeRead, filterBarcodeRead, writeBarcodeFilterResult);
+			midReaderOuts.closeOutAll();
+			outputStats.addOtherStats(midReaderOuts.stats_);
+			barcodeFlows.erase(barcodeName);
+			if (pars.pyroExtract) {
+				//now that the read counts are known write the pyro files, the header followed by the flows
+				for (const auto & fullnameFlows : pyroFlows) {
+					auto flowExtractOutOpts = setUp.pars_.ioOptions_;
+					flowExtractOutOpts.out_.outFilename_ = setUp.pars_.directoryName_ + fullnameFlows.first;
+					flowExtractOutOpts.outFormat_ = SeqIOOptions::outFormats::FLOW;
+					flowExtractOutOpts.out_.outExtention_ = ".dat";
+					SeqOutput ampNoiseOut(flowExtractOutOpts);
+					ampNoiseOut.openWrite(estd::to_string(fullnameFlows.second.size()) + " "
+							+ estd::to_string(pars.maxFlowCutoff));
+					for (const auto & readFlows : fullnameFlows.second) {
+						ampNoiseOut.openWriteFlow(*readFlows);
+					}
+					ampNoiseOut.closeOut();
 				}
-				++goodCounts[fullname];
+				pyroFlows.clear();
+			}
+			if(setUp.pars_.verbose_){
+				std::cout << std::endl;
 			}
 		}
-		if(setUp.pars_.verbose_){
-			std::cout << std::endl;
+	} else {
+		if (setUp.pars_.verbose_) {
+			std::cout << bib::bashCT::boldGreen("Extracting and filtering") << std::endl;
 		}
-	}
-	if(pars.mothurExtract || pars.pyroExtract){
-		if(pars.mothurExtract){
-			for(const auto & name : goodCounts){
-				std::ofstream mothurOut;
-				openTextFile(mothurOut,setUp.pars_.directoryName_ + name.first,".flow",false, true);
-				uint32_t mothurExtractFlowNum = 800;
-				if (pars.maxFlowCutoff == 720) {
-					mothurExtractFlowNum = 800;
-				} else if (pars.maxFlowCutoff <= 400) {
-					mothurExtractFlowNum = 400;
-				}
-				mothurOut << mothurExtractFlowNum << std::endl;
-				std::ifstream flowFile(setUp.pars_.directoryName_ + name.first + "_temp.dat");
-				for(std::string line; std::getline(flowFile,line);){
-					mothurOut << line << std::endl;
-				}
+		//create outputs for all barcodes, files are only opened if a read is written to them
+		BufferedMultiSeqOut filterOuts(pars.maxOpenOutputs, pars.outputBufferSize,
+				pars.outputTotalBufferSize);
+		if (pars.bgzfOutput) {
+			filterOuts.setBgzfOutput(pars.bgzfThreads, pars.bgzfLevel);
+		}
+		if (pars.multiplex) {
+			for (const auto & mid : determinator->mids_) {
+				addFilterOutputs(filterOuts, mid.first);
 			}
+		} else {
+			addFilterOutputs(filterOuts, "all");
 		}
-		if(pars.pyroExtract){
-			for(const auto & name : goodCounts){
-				std::ofstream ampNoiseOut;
-				openTextFile(ampNoiseOut,setUp.pars_.directoryName_ + name.first,".dat",false, true);
-				ampNoiseOut << name.second << " " << pars.maxFlowCutoff << std::endl;
-				std::ifstream flowFile(setUp.pars_.directoryName_ + name.first + "_temp.dat");
-				for(std::string line; std::getline(flowFile,line);){
-					ampNoiseOut << line << std::endl;
-				}
+
+		struct SinglePassResult {
+			MidResult midResult_;
+			FilterResult filterResult_;
+		};
+		//first hand out the reads read in to determine the length cut offs
+		size_t sampledPos = 0;
+		auto readNextSinglePassRead = [&](std::shared_ptr<readObject> & seq) {
+			if (sampledPos < sampledReads.size()) {
+				seq = sampledReads[sampledPos];
+				sampledReads[sampledPos] = nullptr;
+				++sampledPos;
+				return true;
+			}
+			return readNextRead(seq);
+		};
+		auto processSinglePassRead = [&](uint32_t threadNum, std::shared_ptr<readObject> & seq, SinglePassResult & result) {
+			determineMid(threadNum, seq, result.midResult_);
+			if (result.midResult_.startsWithBadQual_ || result.midResult_.smallFragment_
+					|| !result.midResult_.mid_.first) {
+				return;
 			}
+			if (pars.keepUnfilteredReads) {
+				result.midResult_.unfilteredSeq_ = std::make_shared<readObject>(*seq);
+			}
+			filterRead(threadNum, seq, result.midResult_.mid_.first.midName_,
+					result.filterResult_);
+		};
+		//flows aren't extracted in single pass mode
+		std::shared_ptr<sffObject> noFlows;
+		auto writeSinglePassResult = [&](std::shared_ptr<readObject> & seq, SinglePassResult & result) {
+			writeMidResult(seq, result.midResult_);
+			if (result.midResult_.startsWithBadQual_ || result.midResult_.smallFragment_
+					|| !result.midResult_.mid_.first) {
+				return;
+			}
+			writeFilterResult(seq, result.midResult_.mid_.first.midName_,
+					result.filterResult_, filterOuts, noFlows);
+		};
+		ReadBatchPipeline<std::shared_ptr<readObject>, SinglePassResult> singlePassPipeline(
+				pars.numThreads, pars.batchSize);
+		singlePassPipeline.readFactory_ = []() {return std::make_shared<readObject>();};
+		singlePassPipeline.run(readNextSinglePassRead, processSinglePassRead, writeSinglePassResult);
+		readerOuts.closeOutAll();
+		filterOuts.closeOutAll();
+		outputStats.addOtherStats(filterOuts.stats_);
+		if (setUp.pars_.verbose_) {
+			std::cout << std::endl;
 		}
-		for(const auto & name : goodCounts){
-			bib::files::bfs::remove(setUp.pars_.directoryName_ + name.first + "_temp.dat");
+	}
+	if(setUp.pars_.debug_){
+		std::cout << bib::bashCT::boldGreen("Creating Extractor Stats: Start") << std::endl;
+	}
+	ExtractionStator stats(count, readsNotMatchedToBarcode,
+			readsNotMatchedToBarcodePossContam, smallFragmentCount);
+	statsTally.addToStator(stats);
+	if(setUp.pars_.debug_){
+		std::cout << bib::bashCT::boldRed("Creating Extractor Stats: Stop") << std::endl;
+	}
+	if (pars.timingProfile) {
+		StageTimingProfile timings;
+		timings.addOther(readTiming);
+		for (const auto & threadTiming : threadTimings) {
+			timings.addOther(threadTiming);
 		}
+		timings.addOther(writeTiming);
+		auto timingJson = timings.toJson();
+		timingJson["numThreads"] = bib::json::toJson(pars.numThreads);
+		timingJson["singlePass"] = bib::json::toJson(pars.singlePass);
+		timingJson["totalWallSeconds"] = bib::json::toJson(
+				std::chrono::duration<double>(std::chrono::steady_clock::now() - extractorStart).count());
+		std::ofstream timingFile;
+		openTextFile(timingFile, setUp.pars_.directoryName_ + "extractionTimingProfile",
+				".json", pars.resume, false);
+		timingFile << timingJson;
 	}
 	std::ofstream profileLog;
 	openTextFile(profileLog, setUp.pars_.directoryName_ + "extractionProfile.tab.txt",
-			".txt", false, false);
+			".txt", pars.resume, false);
 	if(pDetermine.primers_.size() == 1){
 		profileLog
 				<< "name\ttotalReadsExtracted\tgoodReadsExtracted\tforGood\trevGood\ttotalBadReads\t"
@@ -907,14 +1216,14 @@ int SeekDeepRunner::extractor(const bib::progutils::CmdArgs & inputCommands) {
 	stats.outTotalStats(extractionStatsFile, "\t");
 	std::ofstream failedForwardFile;
 	openTextFile(failedForwardFile, setUp.pars_.directoryName_ + "failedForward.tab.txt",
-			".txt", false, false);
+			".txt", pars.resume, false);
 	failedForwardFile << "MidName\ttotalFailed\tfailedInFor\tfailedInRev"
 			<< std::endl;
 	stats.outFailedForwardStats(failedForwardFile, "\t");
 	if(pars.multiplex){
 		std::ofstream failedBarcodeFile;
 		openTextFile(failedBarcodeFile, setUp.pars_.directoryName_ + "failedBarcode.tab.txt",
-				".txt", false, false);
+				".txt", pars.resume, false);
 		failedBarcodeFile << "Reason\tcount"
 				<< std::endl;
 		auto countKeys = getVectorOfMapKeys(failBarCodeCounts);
@@ -925,7 +1234,7 @@ int SeekDeepRunner::extractor(const bib::progutils::CmdArgs & inputCommands) {
 		if(pars.screenForPossibleContamination && ! failBarCodeCountsPossibleContamination.empty()){
 			std::ofstream failedBarcodePosContFile;
 			openTextFile(failedBarcodePosContFile, setUp.pars_.directoryName_ + "failedBarcodePossibleContamination.tab.txt",
-					".txt", false, false);
+					".txt", pars.resume, false);
 			failedBarcodePosContFile << "Reason\tcount"
 					<< std::endl;
 			auto countKeys = getVectorOfMapKeys(failBarCodeCountsPossibleContamination);
@@ -936,12 +1245,48 @@ int SeekDeepRunner::extractor(const bib::progutils::CmdArgs & inputCommands) {
 		}
 	}
 
-	if (!setUp.pars_.debug_) {
+	outputStats.addOtherStats(readerOuts.stats_);
+	std::ofstream outputStatsFile;
+	openTextFile(outputStatsFile, setUp.pars_.directoryName_ + "outputBufferStats.tab.txt",
+			".txt", pars.resume, false);
+	BufferedMultiSeqOut::writeStats(outputStatsFile, outputStats);
+	if (!threadShortlistPDetermines.empty()) {
+		ShortlistPrimerDeterminator::Stats primerIndexStats;
+		for (const auto & shortlistDeterminator : threadShortlistPDetermines) {
+			primerIndexStats.addOtherStats(shortlistDeterminator->stats_);
+		}
+		std::ofstream primerIndexStatsFile;
+		openTextFile(primerIndexStatsFile, setUp.pars_.directoryName_ + "primerShortlistStats.tab.txt",
+				".txt", pars.resume, false);
+		ShortlistPrimerDeterminator::writeStats(primerIndexStatsFile, primerIndexStats);
+	}
+	if (nullptr != midIndex) {
+		MidNeighborhoodIndex::Stats midIndexStats;
+		for (const auto & threadStats : threadMidIndexStats) {
+			midIndexStats.addOtherStats(threadStats);
+		}
+		std::ofstream midIndexStatsFile;
+		openTextFile(midIndexStatsFile, setUp.pars_.directoryName_ + "barcodeIndexStats.tab.txt",
+				".txt", pars.resume, false);
+		midIndex->writeStats(midIndexStatsFile, midIndexStats);
+	}
+
+	//the run finished so there's nothing to resume
+	if (bfs::exists(checkpointFnp)) {
+		bfs::remove(checkpointFnp);
+	}
+	if (!setUp.pars_.debug_ && !pars.keepUnfilteredReads) {
 		bib::files::rmDirForce(unfilteredReadsDir);
 	}
 	if (setUp.pars_.writingOutAlnInfo_) {
-		setUp.rLog_ << "Number of alignments done" << "\n";
-		alignObj.alnHolder_.write(setUp.pars_.outAlnInfoDirName_, setUp.pars_.verbose_);
+		//the thread aligners started as copies of alignObj so their counts past it's count are the alignments they did
+		uint64_t alignmentsDone = 0;
+		for (const auto & threadAligner : threadAligners) {
+			alignmentsDone += threadAligner->numberOfAlingmentsDone_
+					- alignObj.numberOfAlingmentsDone_;
+		}
+		setUp.rLog_ << "Number of alignments done: " << alignmentsDone << "\n";
+		//the alignments from each thread's aligner are written by alnPool on destruction
 	}
 
 	if(setUp.pars_.verbose_){
@@ -37,6 +37,13 @@ int SeekDeepRunner::extractorPairedEnd(const bib::progutils::CmdArgs & inputComm
 	SeekDeepSetUp setUp(inputCommands);
 	extractorPars pars;
 	setUp.setUpExtractor(pars);
+	//paired output goes to a file per mate, which BgzfSeqOutput can't write
+	if (pars.bgzfOutput) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__
+				<< ", error: --bgzfOutput can't be used with paired end reads" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
 
 	uint32_t readsNotMatchedToBarcode = 0;
 	uint32_t readsNotMatchedToBarcodePossContam = 0;
@@ -107,8 +114,6 @@ int SeekDeepRunner::extractorPairedEnd(const bib::progutils::CmdArgs & inputComm
 				bib::files::MkdirPar("contamination", false));
 	}
 
-	std::shared_ptr<PairedRead> seq = std::make_shared<PairedRead>();
-
 	// read in reads and remove lower case bases indicating tech low quality like
 	// tags and such
 	if(setUp.pars_.verbose_){
@@ -126,9 +131,10 @@ int SeekDeepRunner::extractorPairedEnd(const bib::progutils::CmdArgs & inputComm
 
 	uint32_t smallFragmentCount = 0;
 	uint32_t startsWithBadQualCount = 0;
-	uint64_t maxReadSize = 0;
 	uint32_t count = 0;
-	MultiSeqIO readerOuts;
+	BufferedMultiSeqOut readerOuts(pars.maxOpenOutputs, pars.outputBufferSize,
+			pars.outputTotalBufferSize);
+	BufferedMultiSeqOut::Stats outputStats;
 
 	std::map<std::string, std::pair<uint32_t, uint32_t>> counts;
 	std::unordered_map<std::string, uint32_t>  failBarCodeCounts;
@@ -202,7 +208,6 @@ int SeekDeepRunner::extractorPairedEnd(const bib::progutils::CmdArgs & inputComm
 
 
 	if (pars.screenForPossibleContamination) {
-		readVec::getMaxLength(compareObject, maxReadSize);
 
 		compareInfo = std::make_unique<ReadCheckerOnKmerComp>(kmerInfo(compareObject.seqBase_.seq_,
 				pars.contaminationKLen, false),pars.contaminationKLen, pars.kmerCutOff, true);
@@ -228,7 +233,6 @@ int SeekDeepRunner::extractorPairedEnd(const bib::progutils::CmdArgs & inputComm
 				}
 
 				for (const auto & read : reads) {
-					readVec::getMaxLength(read, maxReadSize);
 					compareInfos.emplace(read.seqBase_.name_, ReadCheckerOnKmerComp(kmerInfo(read.seqBase_.seq_,
 							pars.contaminationKLen, false),pars.contaminationKLen, pars.kmerCutOff, false));
 					auto rev = read;
@@ -254,7 +258,6 @@ int SeekDeepRunner::extractorPairedEnd(const bib::progutils::CmdArgs & inputComm
 		readerCon.openIn();
 		auto reads = readerCon.readAllReads<readObject>();
 		for (const auto & refSeq : reads) {
-			readVec::getMaxLength(refSeq, maxReadSize);
 			compareInfos.emplace(refSeq.seqBase_.name_, ReadCheckerOnKmerComp(kmerInfo(refSeq.seqBase_.seq_,
 					pars.contaminationKLen, false),pars.contaminationKLen, pars.kmerCutOff, true));
 			auto rev = refSeq;
@@ -271,13 +274,39 @@ int SeekDeepRunner::extractorPairedEnd(const bib::progutils::CmdArgs & inputComm
 	std::vector<size_t> readLensR2;
 
 
-	while (reader.readNextRead(seq)) {
-		++count;
-		if (setUp.pars_.verbose_ && count % 50 == 0) {
-			std::cout << "\r" << count ;
-			std::cout.flush();
+	//the flows are grabbed from the reader as each read is read in so the barcode step has to be done serially
+	uint32_t midNumThreads = pars.numThreads;
+	if ((pars.mothurExtract || pars.pyroExtract) && midNumThreads > 1) {
+		if (setUp.pars_.verbose_) {
+			std::cout << "Extracting flows, barcode determination will be done with 1 thread"
+					<< std::endl;
+		}
+		midNumThreads = 1;
+	}
+	//each thread gets it's own determinator
+	std::vector<std::unique_ptr<MidDeterminator>> threadDeterminators;
+	std::vector<MidDeterminator::MidDeterminePars> threadMDetPars(midNumThreads,
+			pars.mDetPars);
+	if (pars.multiplex) {
+		for (uint32_t t = 0; t < midNumThreads; ++t) {
+			threadDeterminators.emplace_back(std::make_unique<MidDeterminator>(mids));
+			threadDeterminators.back()->setAllowableMismatches(pars.barcodeErrors);
+			threadDeterminators.back()->setMidEndsRevComp(pars.midEndsRevComp);
 		}
+	}
+
+	struct MidResult {
+		std::pair<MidDeterminator::midPos, MidDeterminator::midPos> mid_;
+		bool startsWithBadQual_ = false;
+		bool smallFragment_ = false;
+		bool possibleContamination_ = false;
+	};
 
+	auto readNextRead = [&reader](std::shared_ptr<PairedRead> & seq) {
+		return reader.readNextRead(seq);
+	};
+
+	auto determineMid = [&](uint32_t threadNum, std::shared_ptr<PairedRead> & seq, MidResult & result) {
 		if (pars.HMP) {
 			subStrToUpper(seq->seqBase_.seq_, 4, pars.primerLen);
 		}
@@ -293,61 +322,76 @@ int SeekDeepRunner::extractorPairedEnd(const bib::progutils::CmdArgs & inputComm
 			readVecTrimmer::trimAtFirstQualScore(seq->seqBase_, pars.trimAtQualCutOff);
 			readVecTrimmer::trimAtFirstQualScore(seq->mateSeqBase_, pars.trimAtQualCutOff);
 			if(0 == len(*seq)){
-				startsWtihBadQualOut.openWrite(seq);
-				++startsWithBadQualCount;
-				continue;
+				result.startsWithBadQual_ = true;
+				return;
 			}
 		}
 
 		if (len(*seq) < pars.smallFragmentCutoff) {
-			smallFragMentOut.write(seq);
-			++smallFragmentCount;
-			continue;
+			result.smallFragment_ = true;
+			return;
 		}
-		readVec::getMaxLength(seq, maxReadSize);
 
-		std::pair<MidDeterminator::midPos, MidDeterminator::midPos> currentMid;
 		if (pars.multiplex) {
-			currentMid = determinator->fullDetermine(seq, pars.mDetPars);
-		} else {
-			currentMid = {MidDeterminator::midPos("all", 0, 0, 0),MidDeterminator::midPos("all", 0, 0, 0)};
-		}
-		if (seq->seqBase_.name_.find("_Comp") != std::string::npos) {
-			++counts[currentMid.first.midName_].second;
+			result.mid_ = threadDeterminators[threadNum]->fullDetermine(seq, threadMDetPars[threadNum]);
 		} else {
-			++counts[currentMid.first.midName_].first;
-		}
-		if (!currentMid.first) {
-			std::string unRecName = "unrecognizedBarcode_" + MidDeterminator::midPos::getFailureCaseName(currentMid.first.fCase_);
-			bool possibleContaimination = false;
-			if(pars.screenForPossibleContamination){
-				//this will check the read against all targets and their reverse complement so it will be a conservative estimate
-				//of whether or not this is contamination, if the read is still on by the end then that it means it's not
-				//considered possible contamination
-				if (pars.multipleTargets || pars.contaminationMutlipleCompare) {
-					for(const auto & compare : compareInfosRev){
+			result.mid_ = {MidDeterminator::midPos("all", 0, 0, 0),MidDeterminator::midPos("all", 0, 0, 0)};
+		}
+		if (!result.mid_.first && pars.screenForPossibleContamination) {
+			//this will check the read against all targets and their reverse complement so it will be a conservative estimate
+			//of whether or not this is contamination, if the read is still on by the end then that it means it's not
+			//considered possible contamination
+			if (pars.multipleTargets || pars.contaminationMutlipleCompare) {
+				for(const auto & compare : compareInfosRev){
+					if(compare.second.checkRead(seq->seqBase_)){
+						break;
+					}
+				}
+				if(!seq->seqBase_.on_){
+					for(const auto & compare : compareInfos){
 						if(compare.second.checkRead(seq->seqBase_)){
 							break;
 						}
 					}
-					if(!seq->seqBase_.on_){
-						for(const auto & compare : compareInfos){
-							if(compare.second.checkRead(seq->seqBase_)){
-								break;
-							}
-						}
-					}
-				}else{
-					compareInfo->checkRead(seq->seqBase_);
-					if(!seq->seqBase_.on_){
-						compareInfoRev->checkRead(seq->seqBase_);
-					}
 				}
+			}else{
+				compareInfo->checkRead(seq->seqBase_);
 				if(!seq->seqBase_.on_){
-					possibleContaimination = true;
+					compareInfoRev->checkRead(seq->seqBase_);
 				}
 			}
-			if(possibleContaimination){
+			if(!seq->seqBase_.on_){
+				result.possibleContamination_ = true;
+			}
+		}
+	};
+
+	auto writeMidResult = [&](std::shared_ptr<PairedRead> & seq, MidResult & result) {
+		++count;
+		if (setUp.pars_.verbose_ && count % 50 == 0) {
+			std::cout << "\r" << count ;
+			std::cout.flush();
+		}
+		if (result.startsWithBadQual_) {
+			startsWtihBadQualOut.openWrite(seq);
+			++startsWithBadQualCount;
+			return;
+		}
+		if (result.smallFragment_) {
+			smallFragMentOut.write(seq);
+			++smallFragmentCount;
+			return;
+		}
+
+		const auto & currentMid = result.mid_;
+		if (seq->seqBase_.name_.find("_Comp") != std::string::npos) {
+			++counts[currentMid.first.midName_].second;
+		} else {
+			++counts[currentMid.first.midName_].first;
+		}
+		if (!currentMid.first) {
+			std::string unRecName = "unrecognizedBarcode_" + MidDeterminator::midPos::getFailureCaseName(currentMid.first.fCase_);
+			if(result.possibleContamination_){
 				unRecName = "possible_contamination_" + unRecName;
 				++readsNotMatchedToBarcodePossContam;
 				MidDeterminator::increaseFailedBarcodeCounts(currentMid.first, failBarCodeCountsPossibleContamination);
@@ -365,7 +409,12 @@ int SeekDeepRunner::extractorPairedEnd(const bib::progutils::CmdArgs & inputComm
 				readerOuts.openWriteFlow(currentMid.first.midName_ + "flow", *reader.in_.lastSffRead_);
 			}
 		}
-	}
+	};
+
+	ReadBatchPipeline<std::shared_ptr<PairedRead>, MidResult> midPipeline(
+			midNumThreads, pars.batchSize);
+	midPipeline.readFactory_ = []() {return std::make_shared<PairedRead>();};
+	midPipeline.run(readNextRead, determineMid, writeMidResult);
 	if (setUp.pars_.verbose_) {
 		std::cout << std::endl;
 	}
@@ -401,14 +450,7 @@ int SeekDeepRunner::extractorPairedEnd(const bib::progutils::CmdArgs & inputComm
 		pars.r2MaxLen = ::round(readLenMedianR2 + lenStepR2);
 	}
 
-	struct lenCutOffs {
-		lenCutOffs(uint32_t minLen, uint32_t maxLen, bool mark = true):
-			minLenChecker_(ReadCheckerLenAbove(minLen, mark)),
-			maxLenChecker_(ReadCheckerLenBelow(maxLen, mark)){
-		}
-		ReadCheckerLenAbove minLenChecker_;
-		ReadCheckerLenBelow maxLenChecker_;
-	};
+	typedef ExtractorReadFilter::LenCutOffs lenCutOffs;
 
 
 	std::map<std::string, lenCutOffs> multipleLenCutOffsR1;
@@ -503,29 +545,57 @@ int SeekDeepRunner::extractorPairedEnd(const bib::progutils::CmdArgs & inputComm
 	bool countEndGaps = true;
 	if(setUp.pars_.debug_){
 		std::cout << bib::bashCT::boldRed("Creating Scoring Matrix: Stop") << std::endl;
-		std::cout << bib::bashCT::boldGreen("Determining Max Read Size: Start") << std::endl;
-	}
-	//to avoid allocating an extremely large aligner matrix;
-	if(maxReadSize > 1000){
-		auto maxPrimerSize = pDetermine.getMaxPrimerSize();
-		if(setUp.pars_.debug_){
-			std::cout << bib::bashCT::boldBlack("maxPrimerSize: ") << maxPrimerSize << std::endl;
-		}
-		maxReadSize =  maxPrimerSize * 4 + pars.mDetPars.variableStop_;
+		std::cout << bib::bashCT::boldGreen("Creating Aligner: Start") << std::endl;
 	}
+	//the aligner is only used on the primer search windows at the ends of the reads so it's sized from the primers,
+	//so it doesn't need the max read length from a pass over the reads and never allocates an extremely large matrix
+	auto maxPrimerSize = pDetermine.getMaxPrimerSize();
+	uint64_t maxAlignSize = maxPrimerSize * 4 + pars.mDetPars.variableStop_;
 	if(setUp.pars_.debug_){
-		std::cout << bib::bashCT::boldRed("Determining Max Read Size: Stop") << std::endl;
-		std::cout << bib::bashCT::boldGreen("Creating Aligner: Start") << std::endl;
-		std::cout << bib::bashCT::boldBlack("max read size: " ) << maxReadSize << std::endl;
+		std::cout << bib::bashCT::boldBlack("maxPrimerSize: ") << maxPrimerSize << std::endl;
+		std::cout << bib::bashCT::boldBlack("max align size: " ) << maxAlignSize << std::endl;
 	}
 
-	aligner alignObj = aligner(maxReadSize, gapPars, scoreMatrix, emptyMaps,
+	aligner alignObj = aligner(maxAlignSize, gapPars, scoreMatrix, emptyMaps,
 			setUp.pars_.qScorePars_, countEndGaps, false);
 	if(setUp.pars_.debug_){
 		std::cout << bib::bashCT::boldRed("Creating Aligner: Stop") << std::endl;
 		std::cout << bib::bashCT::boldGreen("Reading In Previous Alignments: Start") << std::endl;
 	}
 	alignObj.processAlnInfoInput(setUp.pars_.alnInfoDirName_);
+	//each thread gets it's own aligner and primer determinator
+	bibseq::concurrent::AlignerPool alnPool(alignObj, pars.numThreads);
+	alnPool.initAligners();
+	if (setUp.pars_.writingOutAlnInfo_) {
+		alnPool.outAlnDir_ = setUp.pars_.outAlnInfoDirName_;
+	}
+	std::vector<decltype(alnPool.popAligner())> threadAligners;
+	for (uint32_t t = 0; t < pars.numThreads; ++t) {
+		threadAligners.emplace_back(alnPool.popAligner());
+	}
+	std::vector<PrimerDeterminator> threadPDetermines(pars.numThreads, pDetermine);
+	//kmer index and/or edit distance screen of the primers so only primers that could match the read are aligned
+	std::unique_ptr<PrimerKmerIndex> primerIndex;
+	std::unique_ptr<PrimerEditScreen> forwardPrimerScreen;
+	std::unique_ptr<PrimerEditScreen> reversePrimerScreen;
+	std::vector<std::unique_ptr<ShortlistPrimerDeterminator>> threadShortlistPDetermines;
+	if ((pars.primerKmerIndex || pars.primerEditScreen) && !pars.noForwardPrimer) {
+		PrimersAndMids ids(pars.idFilename);
+		if (pars.primerKmerIndex) {
+			primerIndex = std::make_unique<PrimerKmerIndex>(ids, pars.primerKmerLen);
+		}
+		if (pars.primerEditScreen) {
+			forwardPrimerScreen = PrimerEditScreen::forwardPrimerScreen(ids);
+			reversePrimerScreen = PrimerEditScreen::reversePrimerScreen(ids);
+		}
+		for (uint32_t t = 0; t < pars.numThreads; ++t) {
+			threadShortlistPDetermines.emplace_back(
+					std::make_unique<ShortlistPrimerDeterminator>(primerTable,
+							threadPDetermines[t], pars.primerKmerIndexCheckEvery,
+							primerIndex.get(), forwardPrimerScreen.get(),
+							reversePrimerScreen.get()));
+		}
+	}
 	if(setUp.pars_.debug_){
 		std::cout << bib::bashCT::boldRed("Reading In Previous Alignments: Stop") << std::endl;
 		std::cout << bib::bashCT::boldGreen("Creating Extractor Stats: Start") << std::endl;
@@ -542,6 +612,21 @@ int SeekDeepRunner::extractorPairedEnd(const bib::progutils::CmdArgs & inputComm
 	}
 	std::map<std::string, uint32_t> goodCounts;
 
+	typedef ExtractorReadFilter::Result FilterResult;
+
+	//the same filtering as extractor, both mates are length checked and max length isn't checked
+	ExtractorReadFilter readFilter(pars, primerTable, compareInfo.get(),
+			compareInfoRev.get(), compareInfos, compareInfosRev, nullptr,
+			multipleLenCutOffsR1, &multipleLenCutOffsR2, nChecker, *qualChecker);
+	readFilter.checkMaxLen_ = false;
+	auto filterRead = [&](uint32_t threadNum, std::shared_ptr<PairedRead> & seq,
+			const std::string & barcodeName, FilterResult & result) {
+		readFilter.filter(seq, barcodeName, *threadAligners[threadNum],
+				threadPDetermines[threadNum],
+				threadShortlistPDetermines.empty() ? nullptr : threadShortlistPDetermines[threadNum].get(),
+				nullptr, result);
+	};
+
 	for (const auto & f : barcodeFiles) {
 		auto barcodeName = bfs::basename(f.first.string());
 		if ((counts[barcodeName].first + counts[barcodeName].second) == 0
@@ -583,7 +668,8 @@ int SeekDeepRunner::extractorPairedEnd(const bib::progutils::CmdArgs & inputComm
 		barcodeIn.openIn();
 
 		//create outputs
-		MultiSeqIO midReaderOuts;
+		BufferedMultiSeqOut midReaderOuts(pars.maxOpenOutputs, pars.outputBufferSize,
+				pars.outputTotalBufferSize);
 		auto unrecogPrimerOutOpts = setUp.pars_.ioOptions_;
 		unrecogPrimerOutOpts.out_.outFilename_ = bib::files::make_path(unrecognizedPrimerDir
 				,barcodeName).string();
@@ -629,207 +715,29 @@ int SeekDeepRunner::extractorPairedEnd(const bib::progutils::CmdArgs & inputComm
 			inFlowFile.open(bib::files::make_path(unfilteredByBarcodesFlowDir,barcodeName + "_temp.dat").string());
 		}
 
-
-
-		while (barcodeIn.readNextRead(seq)) {
-			//std::cout << barcodeCount << std::endl;
+		auto readNextBarcodeRead = [&barcodeIn](std::shared_ptr<PairedRead> & seq) {
+			return barcodeIn.readNextRead(seq);
+		};
+		auto filterBarcodeRead = [&](uint32_t threadNum, std::shared_ptr<PairedRead> & seq, FilterResult & result) {
+			filterRead(threadNum, seq, barcodeName, result);
+		};
+		//stats, renaming and writing are done in input order so the output is the same as filtering serially
+		auto writeBarcodeFilterResult = [&](std::shared_ptr<PairedRead> & seq, FilterResult & result) {
 			std::getline(inFlowFile, readFlows);
 			if(setUp.pars_.verbose_){
 				pbar.outputProgAdd(std::cout, 1, true);
 			}
 			++barcodeCount;
-			//filter on primers
-			//forward
-			std::string primerName = "";
-			bool foundInReverse = false;
-			if (pars.noForwardPrimer) {
-				primerName = primerTable.content_.front()[primerTable.getColPos(
-						"geneName")];
-			} else {
-				if (pars.multiplex) {
-
-					primerName = pDetermine.determineForwardPrimer(seq, 0, alignObj,
-							pars.fPrimerErrors, !pars.forwardPrimerToUpperCase);
-
-					if (primerName == "unrecognized" && pars.mDetPars.checkComplement_) {
-						primerName = pDetermine.determineWithReversePrimer(seq, 0,
-								alignObj, pars.fPrimerErrors, !pars.forwardPrimerToUpperCase);
-						if (seq->seqBase_.on_) {
-							foundInReverse = true;
-						}
-					}
-
-				} else {
-					uint32_t start = pars.mDetPars.variableStop_;
-					//std::cout << "Determining primer" << std::endl;
-
-					primerName = pDetermine.determineForwardPrimer(seq, start, alignObj,
-							pars.fPrimerErrors, !pars.forwardPrimerToUpperCase);
-					if (primerName == "unrecognized" && pars.mDetPars.checkComplement_) {
-						primerName = pDetermine.determineWithReversePrimer(seq, start,
-								alignObj, pars.fPrimerErrors, !pars.forwardPrimerToUpperCase);
-						if (seq->seqBase_.on_) {
-							foundInReverse = true;
-						}
-					}
-				}
-
-				if (!seq->seqBase_.on_) {
-					stats.increaseFailedForward(barcodeName, seq->seqBase_.name_);
-					midReaderOuts.openWrite("unrecognized", seq);
-					continue;
-				}
-			}
-			std::string fullname = primerName;
-			if (pars.multiplex) {
-				fullname += barcodeName;
-			} else if (pars.sampleName != "") {
-				fullname += pars.sampleName;
-			}
-
-
-
-			//look for possible contamination
-			if (pars.screenForPossibleContamination) {
-				if (pars.multipleTargets) {
-					if (compareInfos.find(primerName) != compareInfos.end()) {
-						if (foundInReverse) {
-							compareInfosRev.at(primerName).checkRead(seq->seqBase_);
-						} else {
-							compareInfos.at(primerName).checkRead(seq->seqBase_);
-						}
-
-						if (!seq->seqBase_.on_) {
-							stats.increaseCounts(fullname, seq->seqBase_.name_,
-									ExtractionStator::extractCase::CONTAMINATION);
-							midReaderOuts.openWrite(fullname + "contamination", seq);
-							continue;
-						}
-					} else {
-						std::stringstream ss;
-						ss
-								<< "Error in screening for contamination, multiple targets turned on but no contamination found for "
-								<< primerName << std::endl;
-						ss << "Options are: "
-								<< vectorToString(getVectorOfMapKeys(compareInfos), ",")
-								<< std::endl;
-						throw std::runtime_error{ss.str()};
-					}
-				} else {
-
-					if(pars.contaminationMutlipleCompare){
-						//if it passes at least one of the multiple compares given in compareSeq filename
-						if (foundInReverse) {
-							for(const auto & compares : compareInfosRev){
-								if(compares.second.checkRead(seq->seqBase_)){
-									break;
-								}
-							}
-						}else{
-							for(const auto & compares : compareInfos){
-								if(compares.second.checkRead(seq->seqBase_)){
-									break;
-								}
-							}
-						}
-					}else{
-						if (foundInReverse) {
-							compareInfoRev->checkRead(seq->seqBase_);
-						} else {
-							compareInfo->checkRead(seq->seqBase_);
-						}
-					}
-					if (!seq->seqBase_.on_) {
-						stats.increaseCounts(fullname, seq->seqBase_.name_,
-								ExtractionStator::extractCase::CONTAMINATION);
-						midReaderOuts.openWrite(fullname + "contamination", seq);
-						continue;
-					}
-				}
+			if (result.failedForward_) {
+				stats.increaseFailedForward(barcodeName, seq->seqBase_.name_);
+				midReaderOuts.openWrite("unrecognized", seq);
+				return;
 			}
-
-			//min len
-			multipleLenCutOffsR1.at(primerName).minLenChecker_.checkRead(seq->seqBase_);
-			multipleLenCutOffsR2.at(primerName).minLenChecker_.checkRead(seq->mateSeqBase_);
-
-			if (!seq->seqBase_.on_) {
-				stats.increaseCounts(fullname, seq->seqBase_.name_,
-						ExtractionStator::extractCase::MINLENBAD);
-				midReaderOuts.openWrite(fullname + "bad", seq);
-				continue;
-			}
-
-			//reverse
-			if (!pars.noReversePrimer) {
-				if (foundInReverse) {
-					pDetermine.checkForForwardPrimerInRev(seq, primerName, alignObj,
-							pars.rPrimerErrors, !pars.reversePrimerToUpperCase,
-							pars.mDetPars.variableStop_, false);
-				} else {
-					pDetermine.checkForReversePrimer(seq, primerName, alignObj,
-							pars.rPrimerErrors, !pars.reversePrimerToUpperCase,
-							pars.mDetPars.variableStop_, false);
-				}
-
-				if (!seq->seqBase_.on_) {
-					stats.increaseCounts(fullname, seq->seqBase_.name_,
-							ExtractionStator::extractCase::BADREVERSE);
-					seq->seqBase_.name_.append("_badReverse");
-					midReaderOuts.openWrite(fullname + "bad", seq);
-					continue;
-				}
-			}
-			//min len again becuase the reverse primer search trims to the reverse primer so it could be short again
-			multipleLenCutOffsR1.at(primerName).minLenChecker_.checkRead(seq->seqBase_);
-			multipleLenCutOffsR2.at(primerName).minLenChecker_.checkRead(seq->mateSeqBase_);
-
-
-			if (!seq->seqBase_.on_) {
-				stats.increaseCounts(fullname, seq->seqBase_.name_,
-						ExtractionStator::extractCase::MINLENBAD);
-				midReaderOuts.openWrite(fullname + "bad", seq);
-				continue;
-			}
-
-			//if found in the reverse direction need to re-orient now
-			if (foundInReverse) {
-				seq->seqBase_.reverseComplementRead(true, true);
-			}
-
-			//contains n
-			nChecker.checkRead(*seq);
-			if (!seq->seqBase_.on_) {
-				stats.increaseCounts(fullname, seq->seqBase_.name_,
-						ExtractionStator::extractCase::CONTAINSNS);
-				midReaderOuts.openWrite(fullname + "bad", seq);
-				continue;
-			}
-			/*
-			//max len
-			multipleLenCutOffsR1.at(primerName).maxLenChecker_.checkRead(seq->seqBase_);
-			multipleLenCutOffsR2.at(primerName).maxLenChecker_.checkRead(seq->mateSeqBase_);
-
-			if (!seq->seqBase_.on_) {
-				stats.increaseCounts(fullname, seq->seqBase_.name_,
-						ExtractionStator::extractCase::MAXLENBAD);
-				midReaderOuts.openWrite(fullname + "bad", seq);
-				continue;
-			}*/
-
-
-			//quality
-			qualChecker->checkRead(*seq);
-
-			if (!seq->seqBase_.on_) {
-				stats.increaseCounts(fullname, seq->seqBase_.name_,
-						ExtractionStator::extractCase::QUALITYFAILED);
-				midReaderOuts.openWrite(fullname + "bad", seq);
-				continue;
-			}
-
-			if (seq->seqBase_.on_) {
-				stats.increaseCounts(fullname, seq->seqBase_.name_,
-						ExtractionStator::extractCase::GOOD);
+			const auto & fullname = result.fullname_;
+			stats.increaseCounts(fullname, seq->seqBase_.name_, result.case_);
+			if (ExtractionStator::extractCase::CONTAMINATION == result.case_) {
+				midReaderOuts.openWrite(fullname + "contamination", seq);
+			} else if (ExtractionStator::extractCase::GOOD == result.case_) {
 				if (pars.rename) {
 					std::string oldName = bib::replaceString(seq->seqBase_.name_, "_Comp", "");
 					seq->seqBase_.name_ = fullname + "."
@@ -845,8 +753,20 @@ int SeekDeepRunner::extractorPairedEnd(const bib::progutils::CmdArgs & inputComm
 					midReaderOuts.openWrite(fullname + "flow", readFlows);
 				}
 				++goodCounts[fullname];
+			} else {
+				if (ExtractionStator::extractCase::BADREVERSE == result.case_) {
+					seq->seqBase_.name_.append("_badReverse");
+				}
+				midReaderOuts.openWrite(fullname + "bad", seq);
 			}
-		}
+		};
+
+		ReadBatchPipeline<std::shared_ptr<PairedRead>, FilterResult> filterPipeline(
+				pars.numThreads, pars.batchSize);
+		filterPipeline.readFactory_ = []() {return std::make_shared<PairedRead>();};
+		filterPipeline.run(readNextBarcodeRead, filterBarcodeRead, writeBarcodeFilterResult);
+		midReaderOuts.closeOutAll();
+		outputStats.addOtherStats(midReaderOuts.stats_);
 		if(setUp.pars_.verbose_){
 			std::cout << std::endl;
 		}
@@ -942,12 +862,27 @@ int SeekDeepRunner::extractorPairedEnd(const bib::progutils::CmdArgs & inputComm
 		}
 	}
 
+	outputStats.addOtherStats(readerOuts.stats_);
+	std::ofstream outputStatsFile;
+	openTextFile(outputStatsFile, setUp.pars_.directoryName_ + "outputBufferStats.tab.txt",
+			".txt", false, false);
+	BufferedMultiSeqOut::writeStats(outputStatsFile, outputStats);
+	if (!threadShortlistPDetermines.empty()) {
+		ShortlistPrimerDeterminator::Stats primerIndexStats;
+		for (const auto & shortlistDeterminator : threadShortlistPDetermines) {
+			primerIndexStats.addOtherStats(shortlistDeterminator->stats_);
+		}
+		std::ofstream primerIndexStatsFile;
+		openTextFile(primerIndexStatsFile, setUp.pars_.directoryName_ + "primerShortlistStats.tab.txt",
+				".txt", false, false);
+		ShortlistPrimerDeterminator::writeStats(primerIndexStatsFile, primerIndexStats);
+	}
 	if (!setUp.pars_.debug_) {
 		bib::files::rmDirForce(unfilteredReadsDir);
 	}
 	if (setUp.pars_.writingOutAlnInfo_) {
 		setUp.rLog_ << "Number of alignments done" << "\n";
-		alignObj.alnHolder_.write(setUp.pars_.outAlnInfoDirName_, setUp.pars_.verbose_);
+		//the alignments from each thread's aligner are written by alnPool on destruction
 	}
 
 	if(setUp.pars_.verbose_){
@@ -69,6 +69,18 @@ void SeekDeepSetUp::setUpExtractor(extractorPars & pars) {
 	setOption(pars.rPrimerErrors.twoBaseIndel_, "--rTwoBaseIndels",
 			"Number Of Two base indels to allow in reverse primer", false, "Primer");
 	//rPrimerErrors.largeBaseIndel_ = .99;
+	setOption(pars.primerKmerIndex, "--primerKmerIndex",
+			"Only align primers that share a kmer with the start of the read, speeds up runs with many targets", false, "Primer");
+	setOption(pars.primerKmerLen, "--primerKmerLen",
+			"Kmer length for --primerKmerIndex", false, "Primer");
+	setOption(pars.primerKmerIndexCheckEvery, "--primerKmerIndexCheckEvery",
+			"Check every this many primer look ups against all primers to report how often the kmer index or edit screen misses the primer, 0 to not check", false, "Primer");
+	setOption(pars.primerEditScreen, "--primerEditScreen",
+			"Skip aligning primers whose SIMD computed lower bound edit distance to the start of the read is more than the primer errors allowed", false, "Primer");
+	if (0 == pars.primerKmerLen || pars.primerKmerLen > 32) {
+		addWarning("--primerKmerLen has to be between 1 and 32");
+		failed_ = true;
+	}
 
 	setOption(pars.filterOffSmallReadCounts, "--filterOffSmallReadCounts",
 			"Whether to Filter Off Extraction of Small size (size set by --smallExtractReadCount)",
@@ -85,6 +97,15 @@ void SeekDeepSetUp::setUpExtractor(extractorPars & pars) {
 	setOption(pars.rename, "--rename", "Rename Sequences With Barcode Names",
 			false, "Output Naming");
 	setOption(pars.barcodeErrors, "--barcodeErrors", "Errors Allowed in Barcode", false, "Barcodes");
+	setOption(pars.barcodeIndex, "--barcodeIndex",
+			"Index all barcode variants within --barcodeErrors substitutions to speed up barcode determination, reads matching more than one barcode's variants are checked against all barcodes, only looks for barcodes at the start of the read so can't be used with --variableStart, --midEndsRevComp, --checkComplement or --checkShortenBars", false, "Barcodes");
+	setOption(pars.barcodeIndexIndel, "--barcodeIndexIndel",
+			"Also index barcode variants with a one base indel when using --barcodeIndex", false, "Barcodes");
+	if (pars.barcodeIndex && pars.barcodeErrors > MidNeighborhoodIndex::maxAllowableErrors_) {
+		addWarning("--barcodeIndex can only be used with --barcodeErrors of "
+				+ estd::to_string(MidNeighborhoodIndex::maxAllowableErrors_) + " or less");
+		failed_ = true;
+	}
 	setOption(pars.trimTcag, "--trimTcag", "trim TCAG(454 tag) if it is present",
 			false, "Preprocessing");
 	if (setOption(pars.HMP, "--HMP", "HMP")) {
@@ -116,8 +137,22 @@ void SeekDeepSetUp::setUpExtractor(extractorPars & pars) {
 		pars.checkingQCheck = true;
 	}
 	processReadInNames(VecStr{"--fasta", "--fastagz", "--fastq", "--fastqgz"},true);
-	bool mustMakeDirectory = true;
-	processDirectoryOutputName(mustMakeDirectory);
+	setOption(pars.resume, "--resume",
+			"Resume a killed run from the checkpoint in its output directory (given by --dout), the run has to have been started with --checkpointEvery", false, "Run Options");
+	if (pars.resume) {
+		//re-use the directory of the run being resumed rather than making a new one
+		setOption(pars_.directoryName_, "--dout", "Output directory of the run to resume", true);
+		pars_.directoryName_ = bib::appendAsNeededRet(pars_.directoryName_, "/");
+		if (!bfs::exists(bib::files::make_path(pars_.directoryName_, "extractorCheckpoint.json"))) {
+			addWarning("--resume was given but there is no extractorCheckpoint.json in " + pars_.directoryName_);
+			failed_ = true;
+		}
+		//the filtering outputs are made again from the start
+		pars_.ioOptions_.out_.overWriteFile_ = true;
+	} else {
+		bool mustMakeDirectory = true;
+		processDirectoryOutputName(mustMakeDirectory);
+	}
 	if (setOption(pars.idFilename, "--id", "The name of the ID file", true, "ID File")) {
 		if (!bfs::exists(pars.idFilename)) {
 			failed_ = true;
@@ -131,6 +166,13 @@ void SeekDeepSetUp::setUpExtractor(extractorPars & pars) {
 			"Indicates that the Reads are multiplex barcoded", false, "Barcodes");
 	setOption(pars.mDetPars.checkComplement_, "--checkComplement",
 			"Check the Complement of the Seqs As Well", false, "Complement");
+	//the barcode index only looks at the start of the read in the forward direction
+	if (pars.barcodeIndex
+			&& (pars.mDetPars.variableStop_ > 0 || pars.midEndsRevComp
+					|| pars.mDetPars.checkComplement_ || pars.mDetPars.checkForShorten_)) {
+		addWarning("--barcodeIndex can't be used with --variableStart, --midEndsRevComp, --checkComplement or --checkShortenBars");
+		failed_ = true;
+	}
 	// setOption(within, "-within");
 	setOption(pars.minLen, "--minlen", "Minimum read length", false, "Filtering");
 	setOption(pars.maxLength, "--maxlen", "Maximum read length", false, "Filtering");
@@ -164,6 +206,12 @@ void SeekDeepSetUp::setUpExtractor(extractorPars & pars) {
 	}
 	setOption(pars.contaminationMutlipleCompare, "--contaminationMutlipleCompare",
 			"Compare to all the sequences within the compare seq file if a file is given", false, "Contamination Filtering");
+	setOption(pars.contaminationKmerIndex, "--contaminationKmerIndex",
+			"When comparing to multiple sequences, use one kmer index of all of them to only check the ones the read could match", false, "Contamination Filtering");
+	if (pars.contaminationKmerIndex && (0 == pars.contaminationKLen || pars.contaminationKLen > 32)) {
+		addWarning("--contaminationKLen has to be between 1 and 32 to use --contaminationKmerIndex");
+		failed_ = true;
+	}
 	setOption(pars.multipleTargets, "--multipleTargets",
 			"Id file contains multiple targets", false, "Primers");
 	if (pars.multipleTargets) {
@@ -197,6 +245,70 @@ void SeekDeepSetUp::setUpExtractor(extractorPars & pars) {
 	pars.trimAtQual = setOption(pars.trimAtQualCutOff, "--trimAtQual",
 			"Trim Reads at first occurrence of quality score", false, "Post Processing");
 
+	setOption(pars.numThreads, "--numThreads", "Number of threads to use", false, "Run Options");
+	if (0 == pars.numThreads) {
+		addWarning("--numThreads can't be 0");
+		failed_ = true;
+	}
+	setOption(pars.batchSize, "--batchSize",
+			"Number of reads handed to a thread at a time when using more than one thread", false, "Run Options");
+	if (0 == pars.batchSize) {
+		addWarning("--batchSize can't be 0");
+		failed_ = true;
+	}
+	setOption(pars.singlePass, "--singlePass",
+			"Determine barcodes, primers and filter each read in one pass rather than writing out reads by barcode first, if no --minlen/--maxlen given length cut offs are determined from the first reads (set by --singlePassSampleSize) and renamed reads are not zero padded",
+			false, "Run Options");
+	setOption(pars.singlePassSampleSize, "--singlePassSampleSize",
+			"Number of reads to use to determine length cut offs when using --singlePass", false, "Run Options");
+	setOption(pars.keepUnfilteredReads, "--keepUnfilteredReads",
+			"Keep the unfilteredReads directory of reads by barcode, written even in --singlePass mode", false, "Run Options");
+	setOption(pars.maxOpenOutputs, "--maxOpenOutputs",
+			"Max number of output files to have open at once per set of outputs, the least recently written is closed and re-opened later if needed", false, "Run Options");
+	setOption(pars.outputBufferSize, "--outputBufferSize",
+			"Approximate number of bytes of reads to hold in memory for an output file before writing them out", false, "Run Options");
+	setOption(pars.outputTotalBufferSize, "--outputTotalBufferSize",
+			"Approximate number of bytes of reads to hold in memory over all output files before writing out the largest buffers", false, "Run Options");
+	if (0 == pars.maxOpenOutputs) {
+		addWarning("--maxOpenOutputs can't be 0");
+		failed_ = true;
+	}
+	setOption(pars.bgzfOutput, "--bgzfOutput",
+			"Write fasta and fastq outputs compressed as bgzf (block gzip, readable by any gzip reader), the output files get .gz added, not for extractorPairedEnd", false, "Run Options");
+	setOption(pars.bgzfThreads, "--bgzfThreads",
+			"Number of threads to use for compressing bgzf output and decompressing bgzf input (e.g. from --bgzfOutput), ordinary gzipped input (--fastqgz, --fastagz) can't be decompressed on more than one thread, use --readAhead to decompress it on its own thread", false, "Run Options");
+	setOption(pars.bgzfLevel, "--bgzfLevel",
+			"Compression level (0-9) for bgzf output, lower is faster", false, "Run Options");
+	if (pars.bgzfLevel < 0 || pars.bgzfLevel > 9) {
+		addWarning("--bgzfLevel should be between 0 and 9, not " + estd::to_string(pars.bgzfLevel));
+		failed_ = true;
+	}
+	setOption(pars.readAhead, "--readAhead",
+			"Read and decompress the input on a separate thread into large buffers while the reads are being extracted", false, "Run Options");
+	setOption(pars.readAheadBufferSize, "--readAheadBufferSize",
+			"Size in bytes of each of the buffers the input is read ahead into", false, "Run Options");
+	if (pars.readAhead && 0 == pars.readAheadBufferSize) {
+		addWarning("--readAheadBufferSize can't be 0");
+		failed_ = true;
+	}
+	if (pars.readAhead && !ReadAheadSeqInput::canReadAhead(pars_.ioOptions_)) {
+		addWarning("--readAhead can only be used with fasta or fastq input");
+		failed_ = true;
+	}
+	setOption(pars.timingProfile, "--timingProfile",
+			"Record wall time, cpu time, reads and bytes for each extraction stage to extractionTimingProfile.json", false, "Run Options");
+	setOption(pars.checkpointEvery, "--checkpointEvery",
+			"Write out all outputs and save the run's progress to extractorCheckpoint.json every this many reads so a killed run can be continued with --resume, 0 to not checkpoint", false, "Run Options");
+	if ((pars.resume || pars.checkpointEvery > 0) && pars.singlePass) {
+		addWarning("--checkpointEvery and --resume can't be used with --singlePass");
+		failed_ = true;
+	}
+	//the flows are kept in memory between the barcode and filter passes so they can't be picked back up by a resumed run
+	if ((pars.resume || pars.checkpointEvery > 0) && (pars.mothurExtract || pars.pyroExtract)) {
+		addWarning("--checkpointEvery and --resume can't be used with --mothurExtract or --pyro");
+		failed_ = true;
+	}
+
 	pars_.gapInfo_.gapOpen_ = 5;
 	pars_.gapInfo_.gapExtend_ = 1;
 	pars_.gap_ = "5,1";
@@ -116,8 +116,22 @@ int SeekDeepRunner::processClusters(const bib::progutils::CmdArgs & inputCommand
 	if (checkingExpected) {
 		expectedSeqs = SeqInput::getReferenceSeq(setUp.pars_.refIoOptions_, maxSize);
 	}
-	// get max size for aligner
+	// get max size for aligner, from the max read length clusterDown records for each file in the meta data next to it,
+	// only reading the files that have no such record or have changed size since it was made
 	for (const auto& sf : specificFiles) {
+		auto metaDataJsonFnp = bib::files::make_path(bfs::path(sf).parent_path(), "metaData.json");
+		if (bfs::exists(metaDataJsonFnp)) {
+			auto metaJson = bib::json::parseFile(metaDataJsonFnp.string());
+			auto fileName = bfs::path(sf).filename().string();
+			if (metaJson.isMember("maxReadLengths")
+					&& metaJson["maxReadLengths"].isMember(fileName)) {
+				const auto & fileMetaData = metaJson["maxReadLengths"][fileName];
+				if (fileMetaData["fileSize"].asUInt64() == bfs::file_size(sf)) {
+					maxSize = std::max<uint64_t>(maxSize, fileMetaData["maxReadLength"].asUInt64());
+					continue;
+				}
+			}
+		}
 		SeqIOOptions inOpts(sf, setUp.pars_.ioOptions_.inFormat_, true);
 		SeqInput reader(inOpts);
 		reader.openIn();
@@ -36,7 +36,8 @@ SeekDeepUtilsRunner::SeekDeepUtilsRunner() :
 				{ addFunc("dryRunQaulityFiltering", dryRunQaulityFiltering, false),
 					addFunc("runMultipleCommands",    runMultipleCommands, false),
 					addFunc("setupTarAmpAnalysis", setupTarAmpAnalysis, false),
-					addFunc("replaceUnderscores", replaceUnderscores, false) }, //
+					addFunc("replaceUnderscores", replaceUnderscores, false),
+					addFunc("benchPrimerEditScreen", benchPrimerEditScreen, false) }, //
 				"SeekDeepUtils") {
 }
 
@@ -390,6 +391,17 @@ int SeekDeepUtilsRunner::setupTarAmpAnalysis(
 
 	setUp.setOption(pars.maxOverlap, "--maxOverlap",
 			"Max overlap allowed in stitcher", false, "Illumina Stitching");
+	setUp.setOption(pars.minOverlap, "--minOverlap",
+			"Min overlap required to stitch reads", false, "Illumina Stitching");
+	setUp.setOption(pars.maxMismatchDensity, "--maxMismatchDensity",
+			"Max fraction of mismatches allowed in the overlap to stitch reads", false, "Illumina Stitching");
+	setUp.setOption(pars.useFlash, "--useFlash",
+			"Stitch with flash on uncompressed copies of the reads rather than the built in stitcher", false, "Illumina Stitching");
+	if (0 == pars.minOverlap || pars.minOverlap > pars.maxOverlap) {
+		setUp.failed_ = true;
+		setUp.addWarning("--minOverlap should be between 1 and --maxOverlap, not "
+				+ estd::to_string(pars.minOverlap));
+	}
 	setUp.setOption(pars.numThreads, "--numThreads", "Number of CPUs to use");
 
 	setUp.setOption(pars.extraExtractorCmds, "--extraExtractorCmds",
@@ -564,6 +576,7 @@ int SeekDeepUtilsRunner::setupTarAmpAnalysis(
 	VecStr inputPassed;
 	VecStr samplesExtracted;
 	VecStr samplesEmpty;
+	std::map<std::string, std::string> samplesStitchFailed;
 	Json::Value logs;
 	std::mutex logsMut;
 
@@ -575,7 +588,7 @@ int SeekDeepUtilsRunner::setupTarAmpAnalysis(
 		bib::sort(keys);
 		bib::concurrent::LockableQueue<std::string> filesKeys(keys);
 		auto extractStitchFiles =
-				[&analysisSetup ,&samplesExtracted, &samplesEmpty,
+				[&analysisSetup ,&samplesExtracted, &samplesEmpty, &samplesStitchFailed,
 				&filesKeys, &readsByPairs,
 				&logs, &logsMut]() {
 					const std::string zcatTempCmdR1 = analysisSetup.pars_.zcatCmd + " " + "{FILES} > "
@@ -590,6 +603,7 @@ int SeekDeepUtilsRunner::setupTarAmpAnalysis(
 					std::string key = "";
 					VecStr currentEmptySamps;
 					VecStr currentSamplesExtracted;
+					std::map<std::string, std::string> currentStitchFailed;
 					std::unordered_map<std::string, Json::Value> currentLogs;
 
 					while(filesKeys.getVal(key)) {
@@ -598,6 +612,43 @@ int SeekDeepUtilsRunner::setupTarAmpAnalysis(
 							currentEmptySamps.emplace_back(key);
 							continue;
 						}
+						if(!analysisSetup.pars_.useFlash) {
+							//stitch straight from the gzipped reads, no uncompressed copies or external stitcher
+							PairedReadStitcher::StitchPars stitchPars;
+							stitchPars.minOverlap_ = analysisSetup.pars_.minOverlap;
+							stitchPars.maxOverlap_ = analysisSetup.pars_.maxOverlap;
+							stitchPars.maxMismatchDensity_ = analysisSetup.pars_.maxMismatchDensity;
+							stitchPars.r1Trim_ = analysisSetup.pars_.r1Trim;
+							stitchPars.r2Trim_ = analysisSetup.pars_.r2Trim;
+							PairedReadStitcher stitcher(stitchPars);
+							auto stitchStart = std::chrono::steady_clock::now();
+							//same fields as the log of running the stitcher command so the stitch report can be made the same way
+							Json::Value stitchLog;
+							stitchLog["cmd_"] = "in process stitching";
+							try {
+								stitcher.stitchFiles(readsByPairs.at(key).first, readsByPairs.at(key).second,
+										bib::files::make_path(analysisSetup.dir_, key).string());
+								stitchLog["success_"] = true;
+								stitchLog["stdOut_"] = stitcher.stats_.flashLog();
+								stitchLog["stdErr_"] = "";
+								stitchLog["returnCode_"] = 0;
+							} catch (std::exception & e) {
+								//a sample that couldn't be stitched is reported like a failed stitcher command rather than stopping the set up,
+								//it's reported with nothing stitched
+								stitchLog["success_"] = false;
+								stitchLog["stdOut_"] = PairedReadStitcher::Stats().flashLog();
+								stitchLog["stdErr_"] = e.what();
+								stitchLog["returnCode_"] = 1;
+								stitcher.stats_ = PairedReadStitcher::Stats();
+								currentStitchFailed[key] = e.what();
+							}
+							stitchLog["runTime_"] = std::chrono::duration<double>(std::chrono::steady_clock::now() - stitchStart).count();
+							stitchLog["stats"] = stitcher.stats_.toJson();
+							currentLogs[key]["stitch"] = stitchLog;
+							currentLogs[key]["name"] = key;
+							currentSamplesExtracted.emplace_back(key);
+							continue;
+						}
 						auto zcatR1 = bib::replaceString(zcatTempCmdR1, "{FILES}", bib::conToStr(readsByPairs.at(key).first, " "));
 						zcatR1 = bib::replaceString(zcatR1, "{OUTPUT}", bib::files::make_path(analysisSetup.dir_, key).string());
 						auto zcatR2 = bib::replaceString(zcatTempCmdR2, "{FILES}", bib::conToStr(readsByPairs.at(key).second, " "));
@@ -657,6 +708,7 @@ int SeekDeepUtilsRunner::setupTarAmpAnalysis(
 						std::lock_guard<std::mutex> lock(logsMut);
 						addOtherVec(samplesEmpty, currentEmptySamps);
 						addOtherVec(samplesExtracted, currentSamplesExtracted);
+						samplesStitchFailed.insert(currentStitchFailed.begin(), currentStitchFailed.end());
 						for(const auto & keyLog : currentLogs) {
 							logs[keyLog.first] = keyLog.second;
 
@@ -703,6 +755,14 @@ int SeekDeepUtilsRunner::setupTarAmpAnalysis(
 				}
 			}
 		}
+		if (!samplesStitchFailed.empty()) {
+			foundErrors = true;
+			errorOutput << "The following samples failed to stitch " << std::endl;
+			for (const auto & samp : samplesStitchFailed) {
+				errorOutput << "\tSample: " << samp.first << std::endl;
+				errorOutput << "\t\t" << samp.second << std::endl;
+			}
+		}
 		if (!rpOrganizer.readPairsUnrecognized_.empty()) {
 			foundErrors = true;
 			errorOutput
@@ -1185,4 +1245,113 @@ int SeekDeepUtilsRunner::setupTarAmpAnalysis(
 }
 //
 
+int SeekDeepUtilsRunner::benchPrimerEditScreen(
+		const bib::progutils::CmdArgs & inputCommands) {
+	std::string idFilename = "";
+	std::string idFileDelim = "whitespace";
+	uint32_t withinPos = 0;
+	uint32_t maxReads = 10000;
+	comparison fPrimerErrors;
+	fPrimerErrors.hqMismatches_ = 2;
+	fPrimerErrors.distances_.query_.coverage_ = 1;
+	fPrimerErrors.largeBaseIndel_ = .99;
+	fPrimerErrors.oneBaseIndel_ = 2;
+	fPrimerErrors.twoBaseIndel_ = 1;
+	seqSetUp setUp(inputCommands);
+	setUp.setOption(idFilename, "--id", "The id file with the primers", true);
+	setUp.setOption(idFileDelim, "--idFileDelim", "Delimiter of the id file");
+	setUp.setOption(withinPos, "--withinPos", "How far into the read the primer can start");
+	setUp.setOption(maxReads, "--maxReads", "Max number of reads to time, 0 for all reads");
+	setUp.setOption(fPrimerErrors.hqMismatches_, "--fNumOfMismatches",
+			"Number of Mismatches to allow in Forward Primer");
+	setUp.setOption(fPrimerErrors.oneBaseIndel_, "--fOneBaseIndels",
+			"Number Of One base indels to allow in forward primer");
+	setUp.setOption(fPrimerErrors.twoBaseIndel_, "--fTwoBaseIndels",
+			"Number Of Two base indels to allow in forward primer");
+	setUp.setOption(fPrimerErrors.distances_.query_.coverage_, "--fCoverage",
+			"Amount of forward primer to find");
+	setUp.processDefaultReader(true);
+	setUp.processAlignerDefualts();
+	setUp.finishSetUp(std::cout);
+
+	table primerTable = seqUtil::readPrimers(idFilename, idFileDelim, false);
+	PrimerDeterminator pDetermine(primerTable);
+	PrimersAndMids ids(idFilename);
+	auto screen = PrimerEditScreen::forwardPrimerScreen(ids);
+	ShortlistPrimerDeterminator screenedDetermine(primerTable, pDetermine, 0,
+			nullptr, screen.get(), nullptr);
+
+	std::vector<std::shared_ptr<readObject>> reads;
+	SeqInput reader(setUp.pars_.ioOptions_);
+	reader.openIn();
+	readObject read;
+	while ((0 == maxReads || reads.size() < maxReads) && reader.readNextRead(read)) {
+		reads.emplace_back(std::make_shared<readObject>(read));
+	}
+	uint64_t maxSize = pDetermine.getMaxPrimerSize() * 4 + withinPos;
+	aligner alignObj(maxSize, setUp.pars_.gapInfo_,
+			substituteMatrix::createDegenScoreMatrixNoNInRef(
+					setUp.pars_.generalMatch_, setUp.pars_.generalMismatch_),
+			KmerMaps(), setUp.pars_.qScorePars_, true, false);
+
+	auto timeIt = [](const std::function<void()> & func) {
+		auto start = std::chrono::steady_clock::now();
+		func();
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	};
+	std::vector<uint16_t> distances;
+	uint64_t scalarSum = 0;
+	uint64_t simdSum = 0;
+	auto scalarTime = timeIt([&]() {
+		for (const auto & seq : reads) {
+			screen->lowerBoundDistancesScalar(seq->seqBase_.seq_, withinPos, distances);
+			scalarSum = std::accumulate(distances.begin(), distances.end(), scalarSum);
+		}
+	});
+	auto simdTime = timeIt([&]() {
+		for (const auto & seq : reads) {
+			screen->lowerBoundDistances(seq->seqBase_.seq_, withinPos, distances);
+			simdSum = std::accumulate(distances.begin(), distances.end(), simdSum);
+		}
+	});
+	VecStr fullNames;
+	auto fullTime = timeIt([&]() {
+		for (const auto & seq : reads) {
+			auto seqCopy = std::make_shared<readObject>(*seq);
+			fullNames.emplace_back(pDetermine.determineForwardPrimer(seqCopy, withinPos,
+					alignObj, fPrimerErrors, false));
+		}
+	});
+	VecStr screenedNames;
+	auto screenedTime = timeIt([&]() {
+		for (const auto & seq : reads) {
+			auto seqCopy = std::make_shared<readObject>(*seq);
+			screenedNames.emplace_back(screenedDetermine.determineForwardPrimer(seqCopy,
+					withinPos, alignObj, fPrimerErrors, false));
+		}
+	});
+	uint32_t disagreements = 0;
+	for (uint32_t pos = 0; pos < fullNames.size(); ++pos) {
+		if (fullNames[pos] != screenedNames[pos]) {
+			++disagreements;
+		}
+	}
+	std::cout << "reads\tprimers\tsimd\tscalarScreenTime\tsimdScreenTime\talignAllTime\tscreenThenAlignTime\tscreenedOut\tdisagreements" << std::endl;
+	std::cout << reads.size()
+			<< "\t" << screen->primers_.size()
+			<< "\t" << PrimerEditScreen::simdType()
+			<< "\t" << scalarTime
+			<< "\t" << simdTime
+			<< "\t" << fullTime
+			<< "\t" << screenedTime
+			<< "\t" << screenedDetermine.stats_.screenedOut_
+			<< "\t" << disagreements << std::endl;
+	if (scalarSum != simdSum) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error: scalar and simd distances differ" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	return 0;
+}
+
 }// namespace bibseq
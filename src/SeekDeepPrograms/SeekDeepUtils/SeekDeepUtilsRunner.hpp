@@ -42,6 +42,7 @@ class SeekDeepUtilsRunner : public bib::progutils::ProgramRunner {
 
 	static int setupTarAmpAnalysis(const bib::progutils::CmdArgs & inputCommands);
 	static int replaceUnderscores(const bib::progutils::CmdArgs & inputCommands);
+	static int benchPrimerEditScreen(const bib::progutils::CmdArgs & inputCommands);
 
 };
 